@@ -148,7 +148,9 @@ HEADERS += \
     ./src/qt/dialogs/insert_link_dialog.h \
     ./src/qt/dialogs/rows_and_depth_dialog.h \
     ./src/qt/dialogs/new_file_dialog.h \
-    ./src/qt/dialogs/new_repository_dialog.h
+    ./src/qt/dialogs/new_repository_dialog.h \
+    ./src/qt/dialogs/near_duplicates_dialog.h \
+    ./src/qt/near_duplicates_main_window_worker_thread.h
 
 macx|mfwebengine {
     HEADERS += ./src/qt/web_engine_page_link_navigation_policy.h
@@ -233,7 +235,9 @@ SOURCES += \
     ./src/qt/dialogs/insert_link_dialog.cpp \
     ./src/qt/dialogs/rows_and_depth_dialog.cpp \
     ./src/qt/dialogs/new_file_dialog.cpp \
-    ./src/qt/dialogs/new_repository_dialog.cpp
+    ./src/qt/dialogs/new_repository_dialog.cpp \
+    ./src/qt/dialogs/near_duplicates_dialog.cpp \
+    ./src/qt/near_duplicates_main_window_worker_thread.cpp
 
 macx|mfwebengine {
     SOURCES += ./src/qt/web_engine_page_link_navigation_policy.cpp
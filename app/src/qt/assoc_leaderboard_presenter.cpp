@@ -27,6 +27,7 @@ AssocLeaderboardPresenter::AssocLeaderboardPresenter(AssocLeaderboardView* view,
     this->view->setModel(this->model);
 
     this->orloj = orloj;
+    this->source = nullptr;
 
     // ensure HTML cells rendering
     HtmlDelegate* delegate = new HtmlDelegate();
@@ -56,15 +57,27 @@ void AssocLeaderboardPresenter::slotShowNote(const QItemSelection& selected, con
         // IMPROVE make my role constant
         Note* note = item->data(Qt::UserRole + 1).value<Note*>();
 
-        note->incReads();
+        orloj->getMind()->remind().read(note);
         note->makeDirty();
 
+        if(source) {
+            orloj->getMind()->acceptAssociation(source, note, leaderboard);
+            source = nullptr;
+        }
+
         orloj->showFacetNoteView(note);
     } // else do nothing
 }
 
-void AssocLeaderboardPresenter::refresh(std::vector<std::pair<Note*,float>>& assocLeaderboard)
+void AssocLeaderboardPresenter::refresh(std::vector<std::pair<Note*,float>>& assocLeaderboard, const Note* source)
 {
+    this->source = source;
+    if(source) {
+        leaderboard = assocLeaderboard;
+    } else {
+        leaderboard.clear();
+    }
+
     model->removeAllRows();
     if(assocLeaderboard.size()) {
         view->setVisible(true);
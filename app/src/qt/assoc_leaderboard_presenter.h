@@ -42,6 +42,10 @@ private:
 
     OrlojPresenter* orloj;
 
+    // N whose associations are shown and the shown leaderboard (AA model is trained by user choices)
+    const Note* source;
+    std::vector<std::pair<Note*,float>> leaderboard;
+
 public:
     explicit AssocLeaderboardPresenter(AssocLeaderboardView* view, OrlojPresenter* orloj);
     AssocLeaderboardPresenter(const AssocLeaderboardPresenter&) = delete;
@@ -50,7 +54,10 @@ public:
     AssocLeaderboardPresenter &operator=(const AssocLeaderboardPresenter&&) = delete;
     ~AssocLeaderboardPresenter();
 
-    void refresh(std::vector<std::pair<Note*,float>>& assocLeaderboard);
+    /**
+     * @brief Show leaderboard - if source N is set, then user choices are used to train AA model.
+     */
+    void refresh(std::vector<std::pair<Note*,float>>& assocLeaderboard, const Note* source=nullptr);
     AssocLeaderboardView* getView() const { return view; }
 
 public slots:
@@ -137,7 +137,7 @@ void CliAndBreadcrumbsPresenter::executeFts(QString& command)
 
 void CliAndBreadcrumbsPresenter::executeListOutlines()
 {
-    mainPresenter->getOrloj()->showFacetOutlineList(mind->getOutlines());
+    mainPresenter->getOrloj()->showFacetOutlineList(*mind->getOutlines());
 }
 
 void CliAndBreadcrumbsPresenter::executeListNotes()
@@ -0,0 +1,140 @@
+/*
+ near_duplicates_dialog.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "near_duplicates_dialog.h"
+
+namespace m8r {
+
+using namespace std;
+
+NearDuplicatesDialog::NearDuplicatesDialog(QWidget* parent)
+    : QDialog(parent),
+      notes{},
+      choice{nullptr}
+{
+    // widgets
+    label = new QLabel{tr("Clusters of Notes with nearly the same description:")};
+
+    clustersView = new QTreeWidget{this};
+    clustersView->setColumnCount(2);
+    clustersView->setHeaderLabels(QStringList{} << tr("Note") << tr("Notebook"));
+    clustersView->setSelectionMode(QAbstractItemView::SingleSelection);
+    clustersView->header()->setSectionResizeMode(0, QHeaderView::Stretch);
+
+    openButton = new QPushButton{tr("&Open Note")};
+    openButton->setDefault(true);
+    openButton->setEnabled(false);
+
+    closeButton = new QPushButton{tr("&Cancel")};
+
+    // signals
+    QObject::connect(openButton, SIGNAL(clicked()), this, SLOT(handleChoice()));
+    QObject::connect(closeButton, SIGNAL(clicked()), this, SLOT(close()));
+    QObject::connect(
+        clustersView,
+        SIGNAL(currentItemChanged(QTreeWidgetItem*, QTreeWidgetItem*)),
+        this,
+        SLOT(slotItemSelected(QTreeWidgetItem*, QTreeWidgetItem*)));
+    QObject::connect(
+        clustersView,
+        SIGNAL(itemDoubleClicked(QTreeWidgetItem*, int)),
+        this,
+        SLOT(handleChoice()));
+
+    // assembly
+    QVBoxLayout *mainLayout = new QVBoxLayout{};
+    mainLayout->addWidget(label);
+    mainLayout->addWidget(clustersView);
+
+    QHBoxLayout *buttonLayout = new QHBoxLayout{};
+    buttonLayout->addStretch(1);
+    buttonLayout->addWidget(closeButton);
+    buttonLayout->addWidget(openButton);
+    buttonLayout->addStretch();
+
+    mainLayout->addLayout(buttonLayout);
+    setLayout(mainLayout);
+
+    // dialog
+    setWindowTitle(tr("Near-duplicate Notes"));
+    // height is set to make sure tree gets enough lines
+    resize(fontMetrics().averageCharWidth()*90, fontMetrics().height()*30);
+    setModal(true);
+}
+
+NearDuplicatesDialog::~NearDuplicatesDialog()
+{
+    delete label;
+    delete clustersView;
+    delete closeButton;
+    delete openButton;
+}
+
+void NearDuplicatesDialog::show(const vector<vector<Note*>>& clusters)
+{
+    choice = nullptr;
+    notes.clear();
+    clustersView->clear();
+    openButton->setEnabled(false);
+
+    if(clusters.size()) {
+        label->setText(tr("Clusters of Notes with nearly the same description:"));
+        int c = 1;
+        for(const vector<Note*>& cluster:clusters) {
+            QTreeWidgetItem* clusterItem = new QTreeWidgetItem{clustersView};
+            clusterItem->setText(0, tr("Cluster %1 (%2 Notes)").arg(c++).arg(cluster.size()));
+            for(Note* n:cluster) {
+                QTreeWidgetItem* noteItem = new QTreeWidgetItem{clusterItem};
+                noteItem->setText(0, QString::fromStdString(n->getName()));
+                noteItem->setText(1, QString::fromStdString(n->getOutline()->getName()));
+                noteItem->setData(0, Qt::UserRole, static_cast<int>(notes.size()));
+                notes.push_back(n);
+            }
+        }
+        clustersView->expandAll();
+    } else {
+        label->setText(tr("No near-duplicate Notes found."));
+    }
+
+    QDialog::show();
+}
+
+void NearDuplicatesDialog::handleChoice()
+{
+    if(choice) {
+        QDialog::close();
+        emit choiceFinished();
+    }
+}
+
+void NearDuplicatesDialog::slotItemSelected(QTreeWidgetItem* current, QTreeWidgetItem* previous)
+{
+    Q_UNUSED(previous);
+
+    // cluster items don't have N index
+    choice = nullptr;
+    if(current) {
+        QVariant index = current->data(0, Qt::UserRole);
+        if(index.isValid()) {
+            choice = notes[index.toInt()];
+        }
+    }
+    openButton->setEnabled(choice != nullptr);
+}
+
+} // m8r namespace
@@ -0,0 +1,71 @@
+/*
+ near_duplicates_dialog.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8RUI_NEAR_DUPLICATES_DIALOG_H
+#define M8RUI_NEAR_DUPLICATES_DIALOG_H
+
+#include <vector>
+
+#include <QtWidgets>
+
+#include "../../../../lib/src/model/note.h"
+#include "../../../../lib/src/model/outline.h"
+
+#include "../../../../lib/src/debug.h"
+
+namespace m8r {
+
+/**
+ * @brief Report of near-duplicate Note clusters - a Note can be opened from the report.
+ */
+class NearDuplicatesDialog : public QDialog
+{
+    Q_OBJECT
+
+private:
+    // Ns shown in the report (tree items refer Ns by index)
+    std::vector<Note*> notes;
+    Note* choice;
+
+    QLabel* label;
+    QTreeWidget* clustersView;
+    QPushButton* closeButton;
+    QPushButton* openButton;
+
+public:
+    explicit NearDuplicatesDialog(QWidget* parent);
+    NearDuplicatesDialog(const NearDuplicatesDialog&) = delete;
+    NearDuplicatesDialog(const NearDuplicatesDialog&&) = delete;
+    NearDuplicatesDialog &operator=(const NearDuplicatesDialog&) = delete;
+    NearDuplicatesDialog &operator=(const NearDuplicatesDialog&&) = delete;
+    ~NearDuplicatesDialog();
+
+    Note* getChoice() const { return choice; }
+
+    void show(const std::vector<std::vector<Note*>>& clusters);
+
+signals:
+    void choiceFinished();
+
+private slots:
+    void handleChoice();
+    void slotItemSelected(QTreeWidgetItem* current, QTreeWidgetItem* previous);
+};
+
+}
+#endif // M8RUI_NEAR_DUPLICATES_DIALOG_H
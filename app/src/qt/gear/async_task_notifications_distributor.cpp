@@ -23,7 +23,13 @@ namespace m8r {
 using namespace std;
 
 AsyncTaskNotificationsDistributor::AsyncTaskNotificationsDistributor(MainWindowPresenter* mwp)
-    : mwp(mwp)
+    : mwp(mwp),
+      tasksChanged(false),
+      stopped(false),
+      tayRequested(false),
+      tayNote(nullptr),
+      tayOutlineHeader(false),
+      lastTayWNote(nullptr)
 {
     sleepInterval = Configuration::getInstance().getDistributorSleepInterval();
 
@@ -63,116 +69,147 @@ AsyncTaskNotificationsDistributor::~AsyncTaskNotificationsDistributor()
     tasks.clear();
 }
 
+void AsyncTaskNotificationsDistributor::thinkAsYouWrite(const QString& words, Note* note, bool outlineHeader)
+{
+    {
+        std::lock_guard<mutex> criticalSection{tasksMutex};
+        tayRequested = true;
+        tayWords = words;
+        tayNote = note;
+        tayOutlineHeader = outlineHeader;
+    }
+    wakeup.notify_one();
+}
+
+void AsyncTaskNotificationsDistributor::stop()
+{
+    {
+        std::lock_guard<mutex> criticalSection{tasksMutex};
+        stopped = true;
+    }
+    wakeup.notify_one();
+}
+
 void AsyncTaskNotificationsDistributor::run()
 {
-    // avoid re-calculation of TayW word learderboards if it's not needed
-    QString lastTayWords{};
-    Outline* lastTayWOutline{};
-    Note* lastTayWNote{};
+    // Mind wakes up distributor when a future becomes ready - no polling
+    mwp->getMind()->setTaskListener([this]() { notifyTaskFinished(); });
 
+    unique_lock<mutex> criticalSection{tasksMutex};
+    bool dreaming = false;
     while(true) {
-        // IMPROVE consider a condition variable & activiation of checking ONLY if WIP non-empty
-        msleep(sleepInterval);
+        auto isAwake = [this]{ return stopped || tasksChanged || tayRequested; };
+        if(dreaming) {
+            // dreaming progress is the only thing which is refreshed periodically
+            wakeup.wait_for(criticalSection, chrono::milliseconds(sleepInterval.load()), isAwake);
+        } else {
+            wakeup.wait(criticalSection, isAwake);
+        }
+        if(stopped) {
+            break;
+        }
+        tasksChanged = false;
         //MF_DEBUG("AsyncDistributor: wake up...");
 
         /*
-         * AA FTS algorithm - SYNCHRONOUS
+         * Think as you WRITE (both AA FTS and AA BoW algorithms) - SYNCHRONOUS
          */
 
-        // IMPROVE WFTS algorithm is performed SYNCHRONOUSLY - reliable ASYNC protocol was NOT designed yet
-        if(Configuration::getInstance().getAaAlgorithm()==Configuration::AssociationAssessmentAlgorithm::WEIGHTED_FTS) {
-            if(Configuration::getInstance().getMindState()==Configuration::MindState::THINKING) {
-                if(mwp->getOrloj()->isFacetActive(OrlojPresenterFacets::FACET_EDIT_NOTE)) {
-                    // think as you WRITE: detect inactivity AND refresh leadearboard for active word
-                    MF_DEBUG("AsyncDistributor: think as you WRITE (N) hits: " << mwp->getOrloj()->getNoteEdit()->getHitCounter() << endl);
-                    // if there is no activity, then show leaderboard
-                    if(!mwp->getOrloj()->getNoteEdit()->getHitCounter()) {
-                        QString words = mwp->getOrloj()->getNoteEdit()->getRelevantWords();
-                        MF_DEBUG("AsyncDistributor: think as you WRITE (N) words '" << words.toStdString() << "'" << endl);
-                        if(words.size()) {
-                            // refresh leaderboard ONLY if it's different
-                            if(lastTayWNote!=mwp->getOrloj()->getNoteEdit()->getCurrentNote() || lastTayWords!=words) {
-                                lastTayWNote = mwp->getOrloj()->getNoteEdit()->getCurrentNote();
-                                lastTayWords = words;
-
-                                vector<pair<Note*,float>>* associations = new vector<pair<Note*,float>>{};
-                                mwp->getMind()->getAssociatedNotes(words.toStdString(), *associations, mwp->getOrloj()->getNoteEdit()->getCurrentNote());
-                                // send signal(s) to ensure async
-                                emit showStatusBarInfo("Associated Notes for '"+words+"'...");
-                                emit refreshLeaderboardByValue(associations);
-                            } else {
-                                MF_DEBUG("AsyncDistributor: SKIPPING think as you WRITE (N) for words '" << words.toStdString() << "'" << endl);
-                            }
-                        }
-                    }
+        if(tayRequested) {
+            tayRequested = false;
+            QString words{tayWords};
+            Note* note = tayNote;
+            bool outlineHeader = tayOutlineHeader;
 
-                    mwp->getOrloj()->getNoteEdit()->clearHitCounter();
-                } else if(mwp->getOrloj()->isFacetActive(OrlojPresenterFacets::FACET_EDIT_OUTLINE_HEADER)) {
-                    // think as you WRITE: detect inactivity AND refresh leadearboard for word(s) under cursor
-                    if(!mwp->getOrloj()->getOutlineHeaderEdit()->getHitCounter()) {
-                        QString words = mwp->getOrloj()->getOutlineHeaderEdit()->getRelevantWords();
-                        MF_DEBUG("AsyncDistributor: think as you WRITE (O) hits: " << mwp->getOrloj()->getOutlineHeaderEdit()->getHitCounter() << " words '" << words.toStdString() << "'" << endl);
-                        if(words.size()) {
-                            // refresh leaderboard ONLY if it's different
-                            if(lastTayWOutline!=mwp->getOrloj()->getOutlineHeaderEdit()->getCurrentOutline() || lastTayWords!=words) {
-                                lastTayWOutline= mwp->getOrloj()->getOutlineHeaderEdit()->getCurrentOutline();
-                                lastTayWords = words;
-
-                                vector<pair<Note*,float>>* associations = new vector<pair<Note*,float>>{};
-                                mwp->getMind()->getAssociatedNotes(words.toStdString(), *associations, mwp->getOrloj()->getOutlineHeaderEdit()->getCurrentOutline()->getOutlineDescriptorAsNote());
-                                // send signal(s) to ensure async
-                                emit showStatusBarInfo("Associated Notes for Outline '"+words+"'...");
-                                emit refreshHeaderLeaderboardByValue(associations);
-                            }
-                        }
-                    }
-
-                    mwp->getOrloj()->getOutlineHeaderEdit()->clearHitCounter();
-                }
-            }
+            // don't block GUI thread adding tasks while associations are calculated
+            criticalSection.unlock();
+            calculateTayWAssociations(words, note, outlineHeader);
+            criticalSection.lock();
         }
 
         /*
-         * AA BoW algorithm - ASYNCHRONOUS (experimental & buggy as it's unable to handle O/N deletes ~ instable)
+         * AA BoW algorithm - ASYNCHRONOUS (BoW is updated incrementally on O/N create/edit/delete)
          */
 
-        // distribute signals from asynch tasks to frontend components
-        if(Configuration::getInstance().getAaAlgorithm()==Configuration::AssociationAssessmentAlgorithm::BOW && tasks.size()) {
-            std::lock_guard<mutex> criticalSection{tasksMutex};
-
-            MF_DEBUG("AsyncDistributor: AWAKE wip[" << tasks.size() << "]" << endl);
-            vector<Task*> zombies{};
-            for(Task* t:tasks) {
-                // FYI future<> had to be check for f.valid() as get() in other thread destroys it
-                if(t->isReady()) {
-                    MF_DEBUG("AsyncDistributor: future FINISHED w/ " << boolalpha << t->isSuccessful() << endl);
-                    if(t->isSuccessful()) {
-                        switch(t->getType()) {
-                        case TaskType::DREAM_TO_THINK:
-                            emit statusBarShowStatistics();
-                            break;
-                        case TaskType::NOTE_ASSOCIATIONS:
-                            emit leaderboardRefresh(t->getNote());
-                            break;
-                        }
-
-                        zombies.push_back(t);
-                        delete t;
-                        MF_DEBUG("AsyncDistributor: task DELETED" << endl);
-                    }
+        dreaming = distributeTasks();
+    }
+}
+
+void AsyncTaskNotificationsDistributor::calculateTayWAssociations(const QString& words, Note* note, bool outlineHeader)
+{
+    // words associations are calculated SYNCHRONOUSLY - WFTS scans Ns, BoW assesses candidates sharing a word
+    if(Configuration::getInstance().getAaAlgorithm()==Configuration::AssociationAssessmentAlgorithm::WEIGHTED_FTS
+         || Configuration::getInstance().getAaAlgorithm()==Configuration::AssociationAssessmentAlgorithm::BOW)
+    {
+        if(Configuration::getInstance().getMindState()==Configuration::MindState::THINKING) {
+            MF_DEBUG("AsyncDistributor: think as you WRITE (" << (outlineHeader?"O":"N") << ") words '" << words.toStdString() << "'" << endl);
+            // refresh leaderboard ONLY if it's different
+            if(lastTayWNote!=note || lastTayWords!=words) {
+                lastTayWNote = note;
+                lastTayWords = words;
+
+                vector<pair<Note*,float>>* associations = new vector<pair<Note*,float>>{};
+                mwp->getMind()->getAssociatedNotes(words.toStdString(), *associations, note);
+                // send signal(s) to ensure async
+                if(outlineHeader) {
+                    emit showStatusBarInfo("Associated Notes for Outline '"+words+"'...");
+                    emit refreshHeaderLeaderboardByValue(associations);
                 } else {
-                    MF_DEBUG("AsyncDistributor: future NOT FINISHED" << endl);
+                    emit showStatusBarInfo("Associated Notes for '"+words+"'...");
+                    emit refreshLeaderboardByValue(associations);
                 }
+            } else {
+                MF_DEBUG("AsyncDistributor: SKIPPING think as you WRITE for words '" << words.toStdString() << "'" << endl);
             }
+        }
+    }
+}
 
-            if(zombies.size()) {
-                for(Task* t:zombies) {
-                    MF_DEBUG("AsyncDistributor: erasing ZOMBIE task " << t << endl);
-                    tasks.erase(std::remove(tasks.begin(), tasks.end(), t), tasks.end());
+bool AsyncTaskNotificationsDistributor::distributeTasks()
+{
+    bool dreaming = false;
+    if(tasks.size()) {
+        MF_DEBUG("AsyncDistributor: AWAKE wip[" << tasks.size() << "]" << endl);
+        vector<Task*> zombies{};
+        for(Task* t:tasks) {
+            // FYI future<> had to be check for f.valid() as get() in other thread destroys it
+            if(t->isReady()) {
+                MF_DEBUG("AsyncDistributor: future FINISHED w/ " << boolalpha << t->isSuccessful() << endl);
+                if(t->isSuccessful()) {
+                    switch(t->getType()) {
+                    case TaskType::DREAM_TO_THINK:
+                        emit statusBarShowStatistics();
+                        break;
+                    case TaskType::NOTE_ASSOCIATIONS:
+                        emit leaderboardRefresh(t->getNote());
+                        break;
+                    }
+                } else {
+                    if(t->getType()==TaskType::DREAM_TO_THINK) {
+                        // dreaming interrupted
+                        emit statusBarShowStatistics();
+                    } // else leaderboard request cancelled as stale (user navigated to other N)
+                }
+                zombies.push_back(t);
+            } else {
+                MF_DEBUG("AsyncDistributor: future NOT FINISHED" << endl);
+                if(t->getType()==TaskType::DREAM_TO_THINK) {
+                    // dreaming progress
+                    emit statusBarShowStatistics();
+                    dreaming = true;
                 }
             }
         }
+
+        if(zombies.size()) {
+            for(Task* t:zombies) {
+                MF_DEBUG("AsyncDistributor: erasing ZOMBIE task " << t << endl);
+                tasks.erase(std::remove(tasks.begin(), tasks.end(), t), tasks.end());
+                delete t;
+            }
+        }
     }
+    return dreaming;
 }
 
 void AsyncTaskNotificationsDistributor::slotConfigurationUpdated()
@@ -19,6 +19,8 @@
 #ifndef M8RUI_ASYNC_TASK_NOTIFICATIONS_DISTRIBUTOR_H
 #define M8RUI_ASYNC_TASK_NOTIFICATIONS_DISTRIBUTOR_H
 
+#include <atomic>
+#include <condition_variable>
 #include <vector>
 #include <future>
 
@@ -42,8 +44,14 @@ class MainWindowPresenter;
  * Distributor is started from MainWindowPresenter where all MVP components are easily
  * accessible.
  *
- * Summary: distributor gets or pulls tasks, executes them (in its own thread i.e. it doesn't
- * black Qt main thread) and notifies result using signals to Qt frontend (which ensures
+ * Distributor is event-driven - its thread sleeps on a condition variable until a task
+ * is added, Mind notifies that a future became ready or an editor asks to think as you
+ * write (editor's idle timer). Therefore there are no CPU wakeups when nothing happens
+ * and results are delivered as soon as they are ready. Only dreaming progress is refreshed
+ * periodically (async refresh interval) while a dream is running.
+ *
+ * Summary: distributor gets tasks, executes them (in its own thread i.e. it doesn't
+ * block Qt main thread) and notifies result using signals to Qt frontend (which ensures
  * asynchronous dispatch).
  */
 class AsyncTaskNotificationsDistributor : public QThread
@@ -89,9 +97,24 @@ private:
     MainWindowPresenter* mwp;
 
     std::vector<Task*> tasks;
+    // guards tasks, think as you write request and flags below
     std::mutex tasksMutex;
+    std::condition_variable wakeup;
+    // a task was added or a future became ready
+    bool tasksChanged;
+    bool stopped;
+
+    // think as you write request (the latest one wins)
+    bool tayRequested;
+    QString tayWords;
+    Note* tayNote;
+    bool tayOutlineHeader;
+
+    // avoid re-calculation of TayW word leaderboards if it's not needed
+    QString lastTayWords;
+    Note* lastTayWNote;
 
-    int sleepInterval;
+    std::atomic<int> sleepInterval;
 
 public:
     explicit AsyncTaskNotificationsDistributor(MainWindowPresenter* mwp);
@@ -107,10 +130,46 @@ public:
      */
 
     void add(Task* task) {
-        std::lock_guard<std::mutex> criticalSection{tasksMutex};
-        tasks.push_back(task);
+        {
+            std::lock_guard<std::mutex> criticalSection{tasksMutex};
+            tasks.push_back(task);
+            tasksChanged = true;
+        }
+        wakeup.notify_one();
+    }
+
+    /**
+     * @brief Wake up distributor to check futures - called by Mind once a future became ready.
+     */
+    void notifyTaskFinished() {
+        {
+            std::lock_guard<std::mutex> criticalSection{tasksMutex};
+            tasksChanged = true;
+        }
+        wakeup.notify_one();
     }
 
+    /**
+     * @brief Think as you write: calculate associations of words written to N (or O header) and refresh leaderboard.
+     *
+     * Called by editor when user stops typing - associations are calculated in distributor thread.
+     */
+    void thinkAsYouWrite(const QString& words, Note* note, bool outlineHeader);
+
+    /**
+     * @brief Stop distributor thread (caller is expected to wait() for it).
+     */
+    void stop();
+
+private:
+    void calculateTayWAssociations(const QString& words, Note* note, bool outlineHeader);
+    /**
+     * @brief Emit signals for tasks w/ ready futures and delete them (caller must hold tasksMutex).
+     *
+     * @return true if a dream is still running.
+     */
+    bool distributeTasks();
+
 // signals that are sent by distributor to GUI components
 signals:
     void statusBarShowStatistics();
@@ -147,6 +147,9 @@ MainMenuView::MainMenuView(MainWindowView& mainWindowView)
     actionFindNoteByTag->setShortcut(QKeySequence(Qt::CTRL+Qt::SHIFT+Qt::Key_T));
     actionFindNoteByTag->setStatusTip(tr("Find Note by tags"));
 
+    actionFindNearDuplicates = new QAction(tr("Recall Near-&duplicate Notes"), mainWindow);
+    actionFindNearDuplicates->setStatusTip(tr("Find clusters of Notes with nearly the same description"));
+
 #ifdef MF_NER
     actionFindNerPersons = new QAction(tr("Recall &Persons"), mainWindow);
     actionFindNerPersons->setStatusTip(tr("Find persons using Named-entity recognition (NER)"));
@@ -167,6 +170,8 @@ MainMenuView::MainMenuView(MainWindowView& mainWindowView)
     menuFind->addAction(actionFindNoteByName);
     menuFind->addAction(actionFindOutlineByTag);
     menuFind->addAction(actionFindNoteByTag);    
+    menuFind->addSeparator();
+    menuFind->addAction(actionFindNearDuplicates);
 #ifdef MF_NER
     menuFind->addSeparator();
     menuFind->addAction(actionFindNerPersons);
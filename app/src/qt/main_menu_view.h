@@ -83,6 +83,7 @@ public:
     QAction* actionFindNoteByName;
     QAction* actionFindOutlineByTag;
     QAction* actionFindNoteByTag;
+    QAction* actionFindNearDuplicates;
 #ifdef MF_NER
     QAction* actionFindNerPersons;
     QAction* actionFindNerLocations;
@@ -58,6 +58,7 @@ MainWindowPresenter::MainWindowPresenter(MainWindowView& view)
     rowsAndDepthDialog = new RowsAndDepthDialog(&view);
     newRepositoryDialog = new NewRepositoryDialog(&view);
     newFileDialog = new NewFileDialog(&view);
+    nearDuplicatesDialog = new NearDuplicatesDialog(&view);
 #ifdef MF_NER
     nerChooseTagsDialog = new NerChooseTagTypesDialog(&view);
     nerResultDialog = new NerResultDialog(&view);
@@ -79,6 +80,7 @@ MainWindowPresenter::MainWindowPresenter(MainWindowView& view)
     QObject::connect(rowsAndDepthDialog->getGenerateButton(), SIGNAL(clicked()), this, SLOT(handleRowsAndDepth()));
     QObject::connect(newRepositoryDialog->getNewButton(), SIGNAL(clicked()), this, SLOT(handleMindNewRepository()));
     QObject::connect(newFileDialog->getNewButton(), SIGNAL(clicked()), this, SLOT(handleMindNewFile()));
+    QObject::connect(nearDuplicatesDialog, SIGNAL(choiceFinished()), this, SLOT(handleFindNearDuplicates()));
 #ifdef MF_NER
     QObject::connect(nerChooseTagsDialog->getChooseButton(), SIGNAL(clicked()), this, SLOT(handleFindNerEntities()));
     QObject::connect(nerResultDialog, SIGNAL(choiceFinished()), this, SLOT(handleFtsNerEntity()));
@@ -89,6 +91,8 @@ MainWindowPresenter::MainWindowPresenter(MainWindowView& view)
     // setup callback for cleanup when it finishes
     QObject::connect(distributor, SIGNAL(finished()), distributor, SLOT(deleteLater()));
     distributor->start();
+    // near-duplicates worker
+    nearDuplicatesWorker = nullptr;
 #ifdef MF_NER
     // NER worker
     nerWorker = nullptr;
@@ -105,6 +109,12 @@ MainWindowPresenter::MainWindowPresenter(MainWindowView& view)
 
 MainWindowPresenter::~MainWindowPresenter()
 {
+    // distributor must not be notified by Mind which is being deleted
+    if(distributor) {
+        mind->setTaskListener(nullptr);
+        distributor->stop();
+        distributor->wait();
+    }
     if(mind) delete mind;
     if(mainMenu) delete mainMenu;
     if(statusBar) delete statusBar;
@@ -123,7 +133,7 @@ MainWindowPresenter::~MainWindowPresenter()
 void MainWindowPresenter::showInitialView()
 {
     // UI
-    if(mind->getOutlines().size()) {
+    if(mind->getOutlines()->size()) {
         if(config.getActiveRepository()->getMode()==Repository::RepositoryMode::REPOSITORY) {
             if(config.getActiveRepository()->isGithubRepository()) {
                 string key{config.getActiveRepository()->getDir()};
@@ -133,31 +143,31 @@ void MainWindowPresenter::showInitialView()
                 if(o) {
                     orloj->showFacetOutline(o);
                 } else {
-                    orloj->showFacetOutlineList(mind->getOutlines());
+                    orloj->showFacetOutlineList(*mind->getOutlines());
                 }
             } else if(config.getActiveRepository()->getType()==Repository::RepositoryType::MINDFORGER) {
                 if(!doActionViewHome()) {
                     // fallback
                     view.getCli()->setBreadcrumbPath("/outlines");
-                    orloj->showFacetOutlineList(mind->getOutlines());
+                    orloj->showFacetOutlineList(*mind->getOutlines());
                 }
             } else {
                 view.getCli()->setBreadcrumbPath("/outlines");
-                orloj->showFacetOutlineList(mind->getOutlines());
+                orloj->showFacetOutlineList(*mind->getOutlines());
             }
         } else { // file
             // IMPROVE move this method to breadcrumps
             QString m{"/outlines/"};
-            m += QString::fromStdString((*mind->getOutlines().begin())->getName());
+            m += QString::fromStdString((*mind->getOutlines()->begin())->getName());
             view.getCli()->setBreadcrumbPath(m);
 
-            orloj->showFacetOutline(*mind->getOutlines().begin());
+            orloj->showFacetOutline(*mind->getOutlines()->begin());
         }
     } else {
         // NO Os > nothing to show
         // IMPROVE show homepage once it's implemented
         mind->amnesia();
-        orloj->showFacetOutlineList(mind->getOutlines());
+        orloj->showFacetOutlineList(*mind->getOutlines());
     }
 
     // move Mind to configured state
@@ -167,7 +177,7 @@ void MainWindowPresenter::showInitialView()
         if(f.wait_for(chrono::microseconds(0)) == future_status::ready) {
             if(!f.get()) {
                 mainMenu->showFacetMindSleep();
-                statusBar->showError(tr("Cannot think - either Mind already dreaming or repository too big"));
+                statusBar->showError(tr("Cannot think - Mind is already dreaming or thinking"));
             }
             statusBar->showMindStatistics();
         } else {
@@ -371,16 +381,16 @@ void MainWindowPresenter::doActionMindThink()
         if(f.get()) {
             mainMenu->showFacetMindThink();
             if(config.getActiveRepository()->getMode()==Repository::RepositoryMode::REPOSITORY) {
-                orloj->showFacetOutlineList(mind->getOutlines());
+                orloj->showFacetOutlineList(*mind->getOutlines());
             } else {
-                if(mind->getOutlines().size()>0) {
-                    orloj->showFacetOutline(*mind->getOutlines().begin());
+                if(mind->getOutlines()->size()>0) {
+                    orloj->showFacetOutline(*mind->getOutlines()->begin());
                 }
             }
             statusBar->showMindStatistics();
         } else {
             mainMenu->showFacetMindSleep();
-            statusBar->showError(tr("Cannot think - either Mind already dreaming or repository too big"));
+            statusBar->showError(tr("Cannot think - Mind is already dreaming or thinking"));
         }
     } else {
         statusBar->showMindStatistics();
@@ -398,7 +408,7 @@ void MainWindowPresenter::doActionMindSleep()
         statusBar->showMindStatistics();
     } else {
         statusBar->showMindStatistics();
-        statusBar->showError(tr("Cannot start sleeping - please wait until dreaming finishes and then try again"));
+        statusBar->showError(tr("Dreaming is being interrupted - think to resume it or sleep again to discard its progress"));
     }
 }
 
@@ -515,7 +525,7 @@ void MainWindowPresenter::executeFts(const string& searchedString, const bool ig
 void MainWindowPresenter::doActionFindOutlineByName()
 {
     // IMPROVE rebuild model ONLY if dirty i.e. an outline name was changed on save
-    vector<Outline*> os{mind->getOutlines()};
+    vector<Outline*> os{*mind->getOutlines()};
     mind->remind().sortByName(os);
     vector<Thing*> es{os.begin(),os.end()};
 
@@ -536,7 +546,7 @@ void MainWindowPresenter::handleFindOutlineByName()
 void MainWindowPresenter::doActionFindOutlineByTag()
 {
     // IMPROVE rebuild model ONLY if dirty i.e. an outline name was changed on save
-    vector<Outline*> os{mind->getOutlines()};
+    vector<Outline*> os{*mind->getOutlines()};
     mind->remind().sortByName(os);
     vector<Thing*> outlines{os.begin(),os.end()};
 
@@ -576,7 +586,7 @@ void MainWindowPresenter::handleFindNoteByTag()
     if(findNoteByTagDialog->getChoice()) {
         Note* choice = (Note*)findNoteByTagDialog->getChoice();
 
-        choice->incReads();
+        mind->remind().read(choice);
         choice->makeDirty();
 
         orloj->showFacetOutline(choice->getOutline());
@@ -593,7 +603,7 @@ void MainWindowPresenter::handleFindNoteByTag()
 void MainWindowPresenter::doActionRefactorNoteToOutline()
 {
     // IMPROVE rebuild model ONLY if dirty i.e. an outline name was changed on save
-    vector<Outline*> os{mind->getOutlines()};
+    vector<Outline*> os{*mind->getOutlines()};
     mind->remind().sortByName(os);
     vector<Thing*> es{os.begin(),os.end()};
 
@@ -643,7 +653,7 @@ void MainWindowPresenter::handleFindNoteByName()
     if(findNoteByNameDialog->getChoice()) {
         Note* choice = (Note*)findNoteByNameDialog->getChoice();
 
-        choice->incReads();
+        mind->remind().read(choice);
         choice->makeDirty();
 
         orloj->showFacetOutline(choice->getOutline());
@@ -657,56 +667,107 @@ void MainWindowPresenter::handleFindNoteByName()
     }
 }
 
+void MainWindowPresenter::doActionFindNearDuplicates()
+{
+    if(nearDuplicatesWorker) {
+        return;
+    }
+    statusBar->showInfo(tr("Looking for near-duplicate Notes..."));
+
+    // progress dialog is modal - Ns must not be deleted until clusters are shown
+    QDialog* progressDialog = new QDialog{&view};
+    QVBoxLayout* mainLayout = new QVBoxLayout{};
+    QLabel* l = new QLabel{tr(" Looking for near-duplicate Notes... ")};
+    mainLayout->addWidget(l);
+    progressDialog->setLayout(mainLayout);
+    progressDialog->setWindowTitle(tr("Near-duplicate Notes"));
+    progressDialog->setModal(true);
+
+    // launch async worker - dialog is deleted w/ worker
+    QThread* thread = new QThread;
+    nearDuplicatesWorker = new NearDuplicatesMainWindowWorkerThread(
+        thread,
+        mind,
+        new vector<vector<Note*>>{},
+        progressDialog);
+    nearDuplicatesWorker->moveToThread(thread);
+    QObject::connect(thread, SIGNAL(started()), nearDuplicatesWorker, SLOT(process()));
+    QObject::connect(nearDuplicatesWorker, SIGNAL(finished()), this, SLOT(handleNearDuplicatesFound()));
+    // worker's finished signal quits thread ~ thread CANNOT be reused
+    QObject::connect(nearDuplicatesWorker, SIGNAL(finished()), thread, SLOT(quit()));
+    QObject::connect(thread, SIGNAL(finished()), thread, SLOT(deleteLater()));
+    thread->start();
+
+    progressDialog->show();
+}
+
+void MainWindowPresenter::handleNearDuplicatesFound()
+{
+    vector<vector<Note*>>* clusters = nearDuplicatesWorker->getResult();
+
+    // cleanup: thread is deleted by Qt (deleteLater() signal), progress dialog by worker
+    delete nearDuplicatesWorker;
+    nearDuplicatesWorker = nullptr;
+
+    statusBar->showInfo(tr("Found %1 clusters of near-duplicate Notes").arg(clusters->size()));
+    nearDuplicatesDialog->show(*clusters);
+    delete clusters;
+}
+
+void MainWindowPresenter::handleFindNearDuplicates()
+{
+    Note* choice = nearDuplicatesDialog->getChoice();
+    if(choice) {
+        mind->remind().read(choice);
+        choice->makeDirty();
+
+        orloj->showFacetOutline(choice->getOutline());
+        orloj->getNoteView()->refresh(choice);
+        orloj->showFacetNoteView();
+        orloj->getOutlineView()->selectRowByNote(choice);
+        statusBar->showInfo(QString(tr("Note "))+QString::fromStdString(choice->getName()));
+    }
+}
+
 #ifdef MF_NER
 
 void MainWindowPresenter::doActionFindNerPersons()
 {
-    if(orloj->isFacetActiveOutlineManagement()) {
-        nerChooseTagsDialog->clearCheckboxes();
-        nerChooseTagsDialog->getPersonsCheckbox()->setChecked(true);
-        nerChooseTagsDialog->show();
-    } else {
-        statusBar->showInfo(tr("Initializing NER and predicting..."));
-        QMessageBox::critical(&view, tr("NER"), tr("Memory NER not implemented yet."));
-    }
+    // NER in O if O is active, otherwise in memory
+    nerChooseTagsDialog->clearCheckboxes();
+    nerChooseTagsDialog->getPersonsCheckbox()->setChecked(true);
+    nerChooseTagsDialog->show();
 }
 void MainWindowPresenter::doActionFindNerLocations()
 {
-    if(orloj->isFacetActiveOutlineManagement()) {
-        nerChooseTagsDialog->clearCheckboxes();
-        nerChooseTagsDialog->getLocationsCheckbox()->setChecked(true);
-        nerChooseTagsDialog->show();
-    } else {
-        statusBar->showInfo(tr("Initializing NER and predicting..."));
-        QMessageBox::critical(&view, tr("NER"), tr("Memory NER not implemented yet."));
-    }
+    // NER in O if O is active, otherwise in memory
+    nerChooseTagsDialog->clearCheckboxes();
+    nerChooseTagsDialog->getLocationsCheckbox()->setChecked(true);
+    nerChooseTagsDialog->show();
 }
 void MainWindowPresenter::doActionFindNerOrganizations()
 {
-    if(orloj->isFacetActiveOutlineManagement()) {
-        nerChooseTagsDialog->clearCheckboxes();
-        nerChooseTagsDialog->getOrganizationsCheckbox()->setChecked(true);
-        nerChooseTagsDialog->show();
-    } else {
-        statusBar->showInfo(tr("Initializing NER and predicting..."));
-        QMessageBox::critical(&view, tr("NER"), tr("Memory NER not implemented yet."));
-    }
+    // NER in O if O is active, otherwise in memory
+    nerChooseTagsDialog->clearCheckboxes();
+    nerChooseTagsDialog->getOrganizationsCheckbox()->setChecked(true);
+    nerChooseTagsDialog->show();
 }
 void MainWindowPresenter::doActionFindNerMisc()
 {
-    if(orloj->isFacetActiveOutlineManagement()) {
-        nerChooseTagsDialog->clearCheckboxes();
-        nerChooseTagsDialog->getMiscCheckbox()->setChecked(true);
-        nerChooseTagsDialog->show();
-    } else {
-        statusBar->showInfo(tr("Initializing NER and predicting..."));
-        QMessageBox::critical(&view, tr("NER"), tr("Memory NER not implemented yet."));
-    }
+    // NER in O if O is active, otherwise in memory
+    nerChooseTagsDialog->clearCheckboxes();
+    nerChooseTagsDialog->getMiscCheckbox()->setChecked(true);
+    nerChooseTagsDialog->show();
+}
+
+Outline* MainWindowPresenter::getNerScope()
+{
+    return orloj->isFacetActiveOutlineManagement()?orloj->getOutlineView()->getCurrentOutline():nullptr;
 }
 
 NerMainWindowWorkerThread* MainWindowPresenter::startNerWorkerThread(
         Mind* m,
-        OrlojPresenter* o,
+        Outline* o,
         int f,
         std::vector<NerNamedEntity>* r,
         QDialog* d)
@@ -748,10 +809,12 @@ void MainWindowPresenter::handleFindNerEntities()
 
     vector<NerNamedEntity>* result
         = new vector<NerNamedEntity>{};
-    if(mind->isNerInitilized()) {
+    Outline* scope = getNerScope();
+    // memory might not be indexed yet - it's always recognized by worker
+    if(mind->isNerInitilized() && scope) {
         statusBar->showInfo(tr("Recognizing named entities..."));
 
-        mind->recognizePersons(orloj->getOutlineView()->getCurrentOutline(), entityFilter, *result);
+        mind->recognizePersons(scope, entityFilter, *result);
 
         chooseNerEntityResult(result);
     } else {
@@ -761,7 +824,7 @@ void MainWindowPresenter::handleFindNerEntities()
         QDialog* progressDialog
             = new QDialog{&view};
         nerWorker
-            = startNerWorkerThread(mind, orloj, entityFilter, result, progressDialog);
+            = startNerWorkerThread(mind, scope, entityFilter, result, progressDialog);
 
         // show PROGRESS dialog - will be closed by worker
         QVBoxLayout* mainLayout = new QVBoxLayout{};
@@ -806,7 +869,7 @@ void MainWindowPresenter::handleFtsNerEntity()
         executeFts(
             nerResultDialog->getChoice(),
             false,
-            orloj->getOutlineView()->getCurrentOutline());
+            getNerScope());
     }
 }
 
@@ -1019,7 +1082,7 @@ void MainWindowPresenter::doActionFormatTable()
 void MainWindowPresenter::doActionFormatLink()
 {
     // IMPROVE rebuild model ONLY if dirty i.e. an outline name was changed on save
-    vector<Outline*> oss{mind->getOutlines()};
+    vector<Outline*> oss{*mind->getOutlines()};
     mind->remind().sortByName(oss);
     vector<Thing*> os{oss.begin(),oss.end()};
 
@@ -1130,7 +1193,7 @@ void MainWindowPresenter::handleOutlineNew()
 
     if(orloj->isFacetActive(OrlojPresenterFacets::FACET_LIST_OUTLINES)) {
         // IMPROVE PERF add only 1 new outline + sort table (don't load all outlines)
-        orloj->getOutlinesTable()->refresh(mind->getOutlines());
+        orloj->getOutlinesTable()->refresh(*mind->getOutlines());
     }
     // else Outlines are refreshed on facet change
 }
@@ -27,6 +27,7 @@
 #include "main_menu_presenter.h"
 
 #include "gear/async_task_notifications_distributor.h"
+#include "near_duplicates_main_window_worker_thread.h"
 #ifdef MF_NER
     #include "ner_main_window_worker_thread.h"
 #endif
@@ -49,6 +50,7 @@
 #include "dialogs/rows_and_depth_dialog.h"
 #include "dialogs/new_repository_dialog.h"
 #include "dialogs/new_file_dialog.h"
+#include "dialogs/near_duplicates_dialog.h"
 #include "dialogs/ner_choose_tag_types_dialog.h"
 #include "dialogs/ner_result_dialog.h"
 
@@ -63,6 +65,7 @@ class CliAndBreadcrumbsPresenter;
 class OrlojPresenter;
 class StatusBarPresenter;
 class AsyncTaskNotificationsDistributor;
+class NearDuplicatesMainWindowWorkerThread;
 class NerMainWindowWorkerThread;
 
 /**
@@ -86,6 +89,8 @@ private:
     Mind* mind;
 
     AsyncTaskNotificationsDistributor* distributor;
+    // running near-duplicates detection (nullptr if there is none)
+    NearDuplicatesMainWindowWorkerThread* nearDuplicatesWorker;
 #ifdef MF_NER
     NerMainWindowWorkerThread* nerWorker;
 #endif
@@ -114,6 +119,7 @@ private:
     RowsAndDepthDialog* rowsAndDepthDialog;
     NewRepositoryDialog* newRepositoryDialog;
     NewFileDialog* newFileDialog;
+    NearDuplicatesDialog* nearDuplicatesDialog;
     NerChooseTagTypesDialog *nerChooseTagsDialog;
     NerResultDialog* nerResultDialog;
 
@@ -148,7 +154,9 @@ public:
     void handleNoteViewLinkClicked(const QUrl& url);
 
     // NER
-    NerMainWindowWorkerThread* startNerWorkerThread(Mind* m, OrlojPresenter* o, int f, std::vector<NerNamedEntity>* r, QDialog* d);
+    NerMainWindowWorkerThread* startNerWorkerThread(Mind* m, Outline* o, int f, std::vector<NerNamedEntity>* r, QDialog* d);
+    // O to be recognized by NER (nullptr ~ memory)
+    Outline* getNerScope();
 
 public slots:
     // mind
@@ -182,6 +190,9 @@ public slots:
     void handleFindOutlineByTag();
     void doActionFindNoteByTag();
     void handleFindNoteByTag();
+    void doActionFindNearDuplicates();
+    void handleNearDuplicatesFound();
+    void handleFindNearDuplicates();
 #ifdef MF_NER
     void doActionFindNerPersons();
     void doActionFindNerLocations();
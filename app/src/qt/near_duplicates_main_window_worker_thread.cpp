@@ -0,0 +1,37 @@
+/*
+ near_duplicates_main_window_worker_thread.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "near_duplicates_main_window_worker_thread.h"
+
+namespace m8r {
+
+NearDuplicatesMainWindowWorkerThread::~NearDuplicatesMainWindowWorkerThread()
+{
+    delete progressDialog;
+}
+
+void NearDuplicatesMainWindowWorkerThread::process()
+{
+    mind->findNearDuplicateNotes(*result);
+
+    MF_DEBUG("Near-duplicates WORKER finished" << endl);
+    // progress dialog is hidden by GUI thread (slot connected to finished signal)
+    emit finished();
+}
+
+} // m8r namespace
@@ -0,0 +1,76 @@
+/*
+ near_duplicates_main_window_worker_thread.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8RUI_NEAR_DUPLICATES_MAIN_WINDOW_WORKER_THREAD_H
+#define M8RUI_NEAR_DUPLICATES_MAIN_WINDOW_WORKER_THREAD_H
+
+#include <vector>
+
+#include <QtWidgets>
+
+#include "../../lib/src/mind/mind.h"
+
+namespace m8r {
+
+/**
+ * @brief Near-duplicate Ns detection worker thread class.
+ *
+ * Detection is long running on big repositories, therefore it runs on worker
+ * (like NER) while GUI shows progress dialog. See NerMainWindowWorkerThread
+ * for QThread/QObject usage remarks.
+ */
+class NearDuplicatesMainWindowWorkerThread : public QObject
+{
+    Q_OBJECT
+
+    // just (parent) thread handle allowing to delete it when worker finishes
+    QThread* thread;
+
+    Mind* mind;
+    std::vector<std::vector<Note*>>* result;
+    QDialog* progressDialog;
+
+public:
+    explicit NearDuplicatesMainWindowWorkerThread(
+        QThread* t,
+        Mind* m,
+        std::vector<std::vector<Note*>>* r,
+        QDialog* d)
+    {
+        this->thread = t;
+        this->mind = m;
+        this->result = r;
+        this->progressDialog = d;
+    }
+    NearDuplicatesMainWindowWorkerThread(const NearDuplicatesMainWindowWorkerThread&) = delete;
+    NearDuplicatesMainWindowWorkerThread(const NearDuplicatesMainWindowWorkerThread&&) = delete;
+    NearDuplicatesMainWindowWorkerThread &operator=(const NearDuplicatesMainWindowWorkerThread&) = delete;
+    NearDuplicatesMainWindowWorkerThread &operator=(const NearDuplicatesMainWindowWorkerThread&&) = delete;
+    ~NearDuplicatesMainWindowWorkerThread();
+
+    std::vector<std::vector<Note*>>* getResult() { return result; }
+
+public slots:
+    void process();
+
+signals:
+    void finished();
+};
+
+}
+#endif // M8RUI_NEAR_DUPLICATES_MAIN_WINDOW_WORKER_THREAD_H
@@ -27,7 +27,11 @@ NerMainWindowWorkerThread::~NerMainWindowWorkerThread()
 
 void NerMainWindowWorkerThread::process()
 {
-    mind->recognizePersons(orloj->getOutlineView()->getCurrentOutline(), entityFilter, *result);
+    if(outline) {
+        mind->recognizePersons(outline, entityFilter, *result);
+    } else {
+        mind->recognizePersons(entityFilter, *result);
+    }
 
     progressDialog->hide();
 
@@ -50,7 +50,8 @@ class NerMainWindowWorkerThread : public QObject
     QThread* thread;
 
     Mind* mind;
-    OrlojPresenter* orloj;
+    // O to be recognized (nullptr ~ memory)
+    Outline* outline;
     int entityFilter;
     std::vector<NerNamedEntity>* result;
     QDialog* progressDialog;
@@ -59,14 +60,14 @@ public:
     explicit NerMainWindowWorkerThread(
         QThread* t,
         Mind* m,
-        OrlojPresenter* o,
+        Outline* o,
         int f,
         std::vector<NerNamedEntity>* r,
         QDialog* d)
     {
         this->thread = t;
         this->mind = m;
-        this->orloj = o;
+        this->outline = o;
         this->entityFilter = f;
         this->result = r;
         this->progressDialog = d;
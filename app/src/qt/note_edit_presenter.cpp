@@ -50,6 +50,9 @@ NoteEditPresenter::NoteEditPresenter(
     QObject::connect(
         view, SIGNAL(signalSaveAndCloseEditor()),
         this, SLOT(slotSaveAndCloseEditor()));
+    QObject::connect(
+        view->getNoteEditor(), SIGNAL(signalIdle()),
+        this, SLOT(slotThinkAsYouWrite()));
 }
 
 NoteEditPresenter::~NoteEditPresenter()
@@ -67,6 +70,17 @@ void NoteEditPresenter::setNote(Note* note)
     view->setNote(note, mdDescription);    
 }
 
+void NoteEditPresenter::slotThinkAsYouWrite()
+{
+    // timer might fire after editor was closed
+    if(mwp->getOrloj()->isFacetActive(OrlojPresenterFacets::FACET_EDIT_NOTE)) {
+        QString words = getRelevantWords();
+        if(words.size()) {
+            mwp->getDistributor()->thinkAsYouWrite(words, currentNote, false);
+        }
+    }
+}
+
 void NoteEditPresenter::slotCloseEditor()
 {
     mwp->getOrloj()->fromNoteEditBackToView(currentNote);
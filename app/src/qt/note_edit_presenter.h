@@ -58,10 +58,9 @@ public:
     QString getSelectedText() const { return view->getSelectedText(); }
 
     QString getRelevantWords() const { return view->getNoteEditor()->getRelevantWords(); }
-    int getHitCounter() const { return view->getNoteEditor()->getHitCounter(); }
-    void clearHitCounter() { return view->getNoteEditor()->clearHitCounter(); }
 
 public slots:
+    void slotThinkAsYouWrite();
     void slotSaveAndCloseEditor();
     void slotCloseEditor();
     void slotSaveNote();
@@ -30,8 +30,6 @@ inline bool caseInsensitiveLessThan(const QString &a, const QString &b)
 NoteEditorView::NoteEditorView(QWidget* parent)
     : QPlainTextEdit(parent), parent(parent), completedAndSelected(false)
 {
-    hitCounter = 0;
-
     setEditorFont(Configuration::getInstance().getEditorFont());
     setEditorTabWidth(Configuration::getInstance().getUiEditorTabWidth());
 
@@ -51,11 +49,18 @@ NoteEditorView::NoteEditorView(QWidget* parent)
     completer->setModelSorting(QCompleter::CaseInsensitivelySortedModel);
     completer->setCaseSensitivity(Qt::CaseInsensitive);
     completer->setWrapAround(true);
+    // associations
+    idleTimer = new QTimer{this};
+    idleTimer->setSingleShot(true);
+    idleTimer->setInterval(Configuration::getInstance().getDistributorSleepInterval());
 
     // signals
     QObject::connect(this, SIGNAL(blockCountChanged(int)), this, SLOT(updateLineNumberPanelWidth(int)));
     QObject::connect(this, SIGNAL(updateRequest(QRect,int)), this, SLOT(updateLineNumberPanel(QRect,int)));
     QObject::connect(this, SIGNAL(cursorPositionChanged()), this, SLOT(highlightCurrentLine()));
+    // (re)start idle timer on every keystroke and cursor move
+    QObject::connect(this, SIGNAL(cursorPositionChanged()), idleTimer, SLOT(start()));
+    QObject::connect(idleTimer, SIGNAL(timeout()), this, SIGNAL(signalIdle()));
     QObject::connect(completer, SIGNAL(activated(const QString&)), this, SLOT(insertCompletion(const QString&)));
     // shortcut signals
     new QShortcut(QKeySequence(QKeySequence(Qt::ALT+Qt::Key_Slash)), this, SLOT(performCompletion()));
@@ -107,6 +112,8 @@ void NoteEditorView::slotConfigurationUpdated()
 
     setEditorTabWidth(Configuration::getInstance().getUiEditorTabWidth());
     setEditorFont(Configuration::getInstance().getEditorFont());
+
+    idleTimer->setInterval(Configuration::getInstance().getDistributorSleepInterval());
 }
 
 /*
@@ -188,7 +195,7 @@ QString NoteEditorView::getRelevantWords() const
 
 void NoteEditorView::keyPressEvent(QKeyEvent *event)
 {
-    hitCounter++;
+    idleTimer->start();
 
     // IMPROVE get configuration reference and editor mode setting - this must be fast
     if(Configuration::getInstance().getEditorKeyBinding()==Configuration::EditorKeyBindingMode::EMACS) {
@@ -52,8 +52,8 @@ private:
     bool showLineNumbers;
     LineNumberPanel* lineNumberPanel;
 
-    // associations
-    int hitCounter;
+    // associations: think as you write once user stops typing
+    QTimer* idleTimer;
 
     // autocomplete
     bool completedAndSelected;
@@ -80,8 +80,11 @@ public:
 
     // associations
     QString getRelevantWords() const;
-    void clearHitCounter() { hitCounter=0; }
-    int getHitCounter() const { return hitCounter; }
+signals:
+    /**
+     * @brief User stopped typing or moving cursor (think as you write).
+     */
+    void signalIdle();
 
     // autocomplete
 protected:
@@ -65,7 +65,8 @@ NoteViewPresenter::~NoteViewPresenter()
 // IMPROVE first decorate MD with HTML colors > then MD to HTML conversion
 void NoteViewPresenter::refresh(Note* note)
 {
-    note->incReads();
+    mind->remind().read(note);
+    mind->remind().getMemoryDwell().read(note);
     this->currentNote = note;
 
     if(orloj->isFacetActive(OrlojPresenterFacets::FACET_FTS_RESULT) || orloj->isFacetActive(OrlojPresenterFacets::FACET_FTS_VIEW_NOTE)) {
@@ -97,7 +98,7 @@ void NoteViewPresenter::refresh(Note* note)
     shared_future<bool> f = mind->getAssociatedNotes(note, associatedNotesLeaderboard);
     if(f.wait_for(chrono::microseconds(0)) == future_status::ready) {
         if(f.get()) {
-            orloj->getOutlineView()->getAssocLeaderboard()->refresh(associatedNotesLeaderboard);
+            orloj->getOutlineView()->getAssocLeaderboard()->refresh(associatedNotesLeaderboard, note);
         } else {
             orloj->getOutlineView()->getAssocLeaderboard()->getView()->setVisible(false);
         }
@@ -128,7 +129,7 @@ void NoteViewPresenter::slotRefreshLeaderboard(Note* note)
         shared_future<bool> f = mind->getAssociatedNotes(note, associatedNotesLeaderboard);
         if(f.wait_for(chrono::microseconds(0)) == future_status::ready) {
             if(f.get()) {
-                orloj->getOutlineView()->getAssocLeaderboard()->refresh(associatedNotesLeaderboard);
+                orloj->getOutlineView()->getAssocLeaderboard()->refresh(associatedNotesLeaderboard, note);
             }
         }
     }
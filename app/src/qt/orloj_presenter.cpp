@@ -115,7 +115,7 @@ void OrlojPresenter::showFacetOutlineList(const vector<Outline*>& outlines)
 
 void OrlojPresenter::slotShowOutlines()
 {
-    showFacetOutlineList(mind->getOutlines());
+    showFacetOutlineList(*mind->getOutlines());
 }
 
 void OrlojPresenter::showFacetFtsResult(vector<Note*>* result)
@@ -134,7 +134,7 @@ void OrlojPresenter::showFacetOutline(Outline* outline)
     outlineHeaderViewPresenter->refresh(outline);
     view->showFacetOutlineHeaderView();
 
-    outline->incReads();
+    mind->remind().read(outline);
     outline->makeDirty();
 
     mainPresenter->getMainMenu()->showFacetOutlineView();
@@ -267,7 +267,7 @@ void OrlojPresenter::slotShowNote(const QItemSelection& selected, const QItemSel
         // IMPROVE make my role constant
         Note* note = item->data(Qt::UserRole + 1).value<Note*>();
 
-        note->incReads();
+        mind->remind().read(note);
         note->makeDirty();
 
         showFacetNoteView(note);
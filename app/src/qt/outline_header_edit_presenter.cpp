@@ -46,6 +46,9 @@ OutlineHeaderEditPresenter::OutlineHeaderEditPresenter(
     QObject::connect(
         view, SIGNAL(signalSaveAndCloseEditor()),
         this, SLOT(slotSaveAndCloseEditor()));
+    QObject::connect(
+        view->getHeaderEditor(), SIGNAL(signalIdle()),
+        this, SLOT(slotThinkAsYouWrite()));
 }
 
 OutlineHeaderEditPresenter::~OutlineHeaderEditPresenter()
@@ -62,6 +65,17 @@ void OutlineHeaderEditPresenter::setOutline(Outline* outline)
     view->setOutline(outline, mdDescription);
 }
 
+void OutlineHeaderEditPresenter::slotThinkAsYouWrite()
+{
+    // timer might fire after editor was closed
+    if(mwp->getOrloj()->isFacetActive(OrlojPresenterFacets::FACET_EDIT_OUTLINE_HEADER)) {
+        QString words = getRelevantWords();
+        if(words.size()) {
+            mwp->getDistributor()->thinkAsYouWrite(words, outlineHeader, true);
+        }
+    }
+}
+
 void OutlineHeaderEditPresenter::slotCloseEditor()
 {
     mwp->getOrloj()->fromOutlineHeaderEditBackToView(currentOutline);
@@ -58,10 +58,9 @@ public:
     QString getSelectedText() const { return view->getSelectedText(); }
 
     QString getRelevantWords() const { return view->getHeaderEditor()->getRelevantWords(); }
-    int getHitCounter() const { return view->getHeaderEditor()->getHitCounter(); }
-    void clearHitCounter() { return view->getHeaderEditor()->clearHitCounter(); }
 
 public slots:
+    void slotThinkAsYouWrite();
     void slotSaveAndCloseEditor();
     void slotCloseEditor();
     void slotSaveOutlineHeader();
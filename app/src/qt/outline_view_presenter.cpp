@@ -24,6 +24,7 @@ OutlineViewPresenter::OutlineViewPresenter(OutlineViewSplitter* view, OrlojPrese
     : QObject(orloj), currentOutline{nullptr}
 {
     this->view = view;
+    this->mind = orloj->getMind();
     this->outlineTreePresenter
         = new OutlineTreePresenter(view->getOutlineTree(), orloj->getMainWindow(), this);
     this->assocLeaderboardPresenter
@@ -40,7 +41,7 @@ OutlineViewPresenter::~OutlineViewPresenter()
 
 void OutlineViewPresenter::refresh(Outline* outline)
 {
-    outline->incReads();
+    mind->remind().read(outline);
 
     currentOutline = outline;
     view->refreshHeader(outline->getName());
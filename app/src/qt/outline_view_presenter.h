@@ -42,6 +42,8 @@ class OutlineViewPresenter : public QObject
 private:
     Outline* currentOutline;
 
+    Mind* mind;
+
     OutlineViewSplitter* view;
     OutlineTreePresenter* outlineTreePresenter;
     AssocLeaderboardPresenter* assocLeaderboardPresenter;
@@ -59,7 +59,9 @@ void StatusBarPresenter::showMindStatistics()
         status += "Thinking";
         break;
     case Configuration::MindState::DREAMING:
-        status += "Dreaming";
+        status += "Dreaming ";
+        status += QString::number(mind->getDreamProgress());
+        status += "%";
         break;
     case Configuration::MindState::SLEEPING:
         status += "Sleeping";
@@ -84,13 +86,14 @@ void StatusBarPresenter::showMindStatistics()
         break;
     }
 
-    status += cLocale.toString(mind->remind().getOutlinesCount());
+    const MemoryStatistics& statistics = mind->remind().getStatistics();
+    status += cLocale.toString(statistics.getOutlinesCount());
     status += " outlines    ";
-    status += cLocale.toString(mind->remind().getNotesCount());
+    status += cLocale.toString(statistics.getNotesCount());
     status += " notes    ";
     status += cLocale.toString(mind->getTriplesCount());
     status += " triples    ";
-    status += cLocale.toString(mind->remind().getOutlineMarkdownsSize());
+    status += cLocale.toString(statistics.getBytesCount());
     status += " bytes    ";
     if(mind->getScopeAspect().isEnabled()) {
         status += "scope:";
@@ -46,6 +46,8 @@ SOURCES += \
     ./src/gear/datetime_utils.cpp \
     ./src/gear/file_utils.cpp \
     ./src/gear/string_utils.cpp \
+    ./src/gear/work_stealing_pool.cpp \
+    ./src/gear/priority_executor.cpp \
     ./src/mind/ontology/ontology.cpp \
     ./src/model/note_type.cpp \
     ./src/model/note.cpp \
@@ -67,6 +69,9 @@ SOURCES += \
     ./src/mind/galaxy.cpp \
     ./src/mind/memory_dwell.cpp \
     ./src/mind/memory.cpp \
+    ./src/mind/link_graph.cpp \
+    ./src/mind/memory_statistics.cpp \
+    ./src/mind/time_index.cpp \
     ./src/mind/mind.cpp \
     ./src/mind/planner.cpp \
     ./src/mind/working_memory.cpp \
@@ -91,11 +96,17 @@ SOURCES += \
     src/mind/ai/nlp/string_char_provider.cpp \
     src/mind/ai/nn/genann.c \
     src/mind/ai/nlp/word_frequency_list.cpp \
+    src/mind/ai/nlp/word_vector.cpp \
+    src/mind/ai/nlp/word_embeddings.cpp \
     src/gear/trie.cpp \
     src/mind/ai/nlp/stemmer/stemmer.cpp \
     src/mind/ai/ai_aa_bow.cpp \
     src/mind/ai/ai_aa_weighted_fts.cpp \
     src/mind/ai/aa_notes_feature.cpp \
+    src/mind/ai/aa_matrix.cpp \
+    src/mind/ai/aa_top_k.cpp \
+    src/mind/ai/ai_near_duplicates.cpp \
+    src/mind/ai/nlp/min_hash.cpp \
     src/mind/ai/nlp/common_words_blacklist.cpp \
     src/mind/aspect/tag_scope_aspect.cpp \
     src/mind/aspect/mind_scope_aspect.cpp
@@ -122,6 +133,8 @@ HEADERS += \
     ./src/gear/hash_map.h \
     ./src/gear/lang_utils.h \
     ./src/gear/string_utils.h \
+    ./src/gear/work_stealing_pool.h \
+    ./src/gear/priority_executor.h \
     ./src/mind/ontology/ontology_vocabulary.h \
     ./src/mind/ontology/ontology.h \
     ./src/model/note_type.h \
@@ -147,6 +160,9 @@ HEADERS += \
     ./src/mind/galaxy.h \
     ./src/mind/memory_dwell.h \
     ./src/mind/memory.h \
+    ./src/mind/link_graph.h \
+    ./src/mind/memory_statistics.h \
+    ./src/mind/time_index.h \
     ./src/mind/mind.h \
     ./src/mind/planner.h \
     ./src/mind/working_memory.h \
@@ -175,6 +191,8 @@ HEADERS += \
     src/mind/ai/nlp/string_char_provider.h \
     src/mind/ai/nn/genann.h \
     src/mind/ai/nlp/word_frequency_list.h \
+    src/mind/ai/nlp/word_vector.h \
+    src/mind/ai/nlp/word_embeddings.h \
     src/gear/trie.h \
     src/mind/ai/nlp/char_provider.h \
     src/mind/ai/nlp/stemmer/stemmer.h \
@@ -200,6 +218,10 @@ HEADERS += \
     src/mind/ai/ai_aa_weighted_fts.h \
     src/mind/ai/aa_model.h \
     src/mind/ai/aa_notes_feature.h \
+    src/mind/ai/aa_matrix.h \
+    src/mind/ai/aa_top_k.h \
+    src/mind/ai/ai_near_duplicates.h \
+    src/mind/ai/nlp/min_hash.h \
     src/mind/ai/ai_aa.h \
     src/mind/ai/nlp/common_words_blacklist.h \
     src/mind/aspect/tag_scope_aspect.h \
@@ -29,6 +29,7 @@ const std::string Configuration::DEFAULT_UI_HTML_CSS_THEME = std::string{UI_DEFA
 const std::string Configuration::DEFAULT_EDITOR_KEY_BINDING= std::string{UI_DEFAULT_EDITOR_KEY_BINDING};
 const std::string Configuration::DEFAULT_EDITOR_FONT= std::string{UI_DEFAULT_EDITOR_FONT};
 const std::string Configuration::DEFAULT_TIME_SCOPE = std::string{"0y0m0d0h0m"};
+const std::string Configuration::DEFAULT_AI_STEMMER_LANGUAGE = std::string{"english"};
 
 Configuration::Configuration()
     : installer(new Installer{})
@@ -40,6 +41,18 @@ Configuration::Configuration()
     configFilePath += FILE_PATH_SEPARATOR;
     configFilePath += FILENAME_M8R_CONFIGURATION;
 
+    // cache: $XDG_CACHE_HOME/mindforger or ~/.cache/mindforger
+    char *cacheHome = getenv(ENV_VAR_XDG_CACHE_HOME);
+    if(cacheHome && strlen(cacheHome)) {
+        cachePath.assign(cacheHome);
+    } else {
+        cachePath.assign(userHomePath);
+        cachePath += FILE_PATH_SEPARATOR;
+        cachePath += DIRNAME_USER_CACHE;
+    }
+    cachePath += FILE_PATH_SEPARATOR;
+    cachePath += DIRNAME_M8R_CACHE;
+
     clear();
 }
 
@@ -95,6 +108,9 @@ void Configuration::clear()
     }
 
     distributorSleepInterval = DEFAULT_DISTRIBUTOR_SLEEP_INTERVAL;
+    aiThreads = DEFAULT_AI_THREADS;
+    aiStemmerLanguage.assign(DEFAULT_AI_STEMMER_LANGUAGE);
+    aiEmbeddingsPath.clear();
 
     // GUI
     uiViewerShowMetadata = true;
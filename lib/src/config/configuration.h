@@ -41,12 +41,15 @@ constexpr const auto ENV_VAR_HOME = "HOME";
 constexpr const auto ENV_VAR_TERM = "TERM";
 constexpr const auto ENV_VAR_M8R_REPOSITORY = "MINDFORGER_REPOSITORY";
 constexpr const auto ENV_VAR_M8R_EDITOR = "MINDFORGER_EDITOR";
+constexpr const auto ENV_VAR_XDG_CACHE_HOME = "XDG_CACHE_HOME";
 
 constexpr const auto DIRNAME_M8R_REPOSITORY = "mindforger-repository";
 // IMPROVE :-Z C++
 constexpr const auto FILE_PATH_M8R_REPOSITORY = "~/mindforger-repository";
 
 constexpr const auto FILENAME_M8R_CONFIGURATION = ".mindforger.md";
+constexpr const auto DIRNAME_USER_CACHE = ".cache";
+constexpr const auto DIRNAME_M8R_CACHE = "mindforger";
 constexpr const auto FILE_PATH_MEMORY = "memory";
 constexpr const auto FILE_PATH_MIND = "mind";
 constexpr const auto FILE_PATH_LIMBO = "limbo";
@@ -158,9 +161,12 @@ public:
     static constexpr int DEFAULT_ASYNC_MIND_THRESHOLD_BOW = 200;
     static constexpr int DEFAULT_ASYNC_MIND_THRESHOLD_WEIGHTED_FTS = 10000;
     static constexpr int DEFAULT_DISTRIBUTOR_SLEEP_INTERVAL = 3000;
+    // 0 ~ number of CPU cores
+    static constexpr int DEFAULT_AI_THREADS = 0;
 
     static const std::string DEFAULT_ACTIVE_REPOSITORY_PATH;
     static const std::string DEFAULT_TIME_SCOPE;
+    static const std::string DEFAULT_AI_STEMMER_LANGUAGE;
     static constexpr const bool DEFAULT_SAVE_READS_METADATA = true;
 
     static const std::string DEFAULT_UI_THEME_NAME;
@@ -188,6 +194,8 @@ private:
     unsigned int asyncMindThreshold;
 
     std::string userHomePath;
+    // directory w/ data which can be recalculated (like AI models) ~ $XDG_CACHE_HOME/mindforger
+    std::string cachePath;
     std::string configFilePath;
 
     Repository* activeRepository;
@@ -205,7 +213,14 @@ private:
     std::vector<std::string> tagsScope;
     unsigned int md2HtmlOptions;
     AssociationAssessmentAlgorithm aaAlgorithm;
+    // editor idle time before think as you write and dream progress refresh interval (ms)
     int distributorSleepInterval;
+    // number of threads used by CPU intensive AI computations (0 ~ number of CPU cores)
+    unsigned int aiThreads;
+    // language of Ns used to stem words (english, german, french, ...)
+    std::string aiStemmerLanguage;
+    // word embeddings file (GloVe text or converted binary) used to assess associations (empty ~ disabled)
+    std::string aiEmbeddingsPath;
 
     // GUI configuration
     std::string uiThemeName;
@@ -239,11 +254,14 @@ public:
     MindState getDesiredMindState() const { return desiredMindState; }
     void setDesiredMindState(MindState mindState) { this->desiredMindState = mindState; }
     unsigned int getAsyncMindThreshold() const { return asyncMindThreshold; }
+    void setAsyncMindThreshold(unsigned int threshold) { asyncMindThreshold = threshold; }
 
     std::string& getConfigFilePath() { return configFilePath; }
     void setConfigFilePath(const std::string customConfigFilePath) { configFilePath = customConfigFilePath; }
     const std::string& getMemoryPath() const { return memoryPath; }
     const std::string& getLimboPath() const { return limboPath; }
+    const std::string& getCachePath() const { return cachePath; }
+    void setCachePath(const std::string& cachePath) { this->cachePath = cachePath; }
     const char* getRepositoryPathFromEnv();
     /**
      * @brief Create empty Markdown file.
@@ -290,6 +308,12 @@ public:
     void setAaAlgorithm(AssociationAssessmentAlgorithm aaa) { aaAlgorithm = aaa; }
     int getDistributorSleepInterval() const { return distributorSleepInterval; }
     void setDistributorSleepInterval(int sleepInterval) { distributorSleepInterval = sleepInterval; }
+    unsigned int getAiThreads() const { return aiThreads; }
+    void setAiThreads(unsigned int aiThreads) { this->aiThreads = aiThreads; }
+    const std::string& getAiStemmerLanguage() const { return aiStemmerLanguage; }
+    void setAiStemmerLanguage(const std::string& language) { aiStemmerLanguage = language; }
+    const std::string& getAiEmbeddingsPath() const { return aiEmbeddingsPath; }
+    void setAiEmbeddingsPath(const std::string& path) { aiEmbeddingsPath = path; }
 
     /*
      * GUI
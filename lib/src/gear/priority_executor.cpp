@@ -0,0 +1,249 @@
+/*
+ priority_executor.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "priority_executor.h"
+
+namespace m8r {
+
+using namespace std;
+
+PriorityExecutor::PriorityExecutor(size_t size)
+    : sequence{0},
+      running{0},
+      stopped{false},
+      finishListener{}
+{
+    if(!size) {
+        unsigned cores = std::thread::hardware_concurrency();
+        size = cores?cores:1;
+    }
+    this->size = size;
+
+    for(size_t i=0; i<size; i++) {
+        workers.push_back(thread(&PriorityExecutor::work, this));
+    }
+}
+
+PriorityExecutor::~PriorityExecutor()
+{
+    shutdown();
+}
+
+shared_future<bool> PriorityExecutor::submit(const void* key, int priority, Task task, CancelHandler onCancel, bool* queued)
+{
+    unique_lock<std::mutex> criticalSection{mutex};
+    if(queued) *queued = false;
+
+    if(stopped) {
+        criticalSection.unlock();
+        if(onCancel) onCancel();
+        promise<bool> p{};
+        p.set_value(false);
+        return shared_future<bool>(p.get_future());
+    }
+
+    if(key) {
+        auto k = keys.find(key);
+        if(k != keys.end()) {
+            Job* job = k->second;
+            if(priority > job->priority && queue.erase(job)) {
+                job->priority = priority;
+                queue.insert(job);
+            }
+            return job->future;
+        }
+    }
+
+    Job* job = new Job{};
+    job->key = key;
+    job->priority = priority;
+    job->sequence = sequence++;
+    job->task = std::move(task);
+    job->onCancel = std::move(onCancel);
+    job->future = job->promise.get_future().share();
+    queue.insert(job);
+    if(key) {
+        keys[key] = job;
+    }
+    if(queued) *queued = true;
+    // job is deleted by worker once it's finished
+    shared_future<bool> future = job->future;
+    criticalSection.unlock();
+
+    wakeup.notify_one();
+    return future;
+}
+
+void PriorityExecutor::cancel(Job* job, vector<Job*>& cancelled)
+{
+    queue.erase(job);
+    if(job->key) {
+        keys.erase(job->key);
+    }
+    cancelled.push_back(job);
+}
+
+void PriorityExecutor::finishCancelled(vector<Job*>& cancelled)
+{
+    for(Job* job:cancelled) {
+        if(job->onCancel) {
+            job->onCancel();
+        }
+        job->promise.set_value(false);
+        delete job;
+    }
+    if(cancelled.size()) {
+        notifyFinished();
+    }
+}
+
+void PriorityExecutor::setFinishListener(FinishListener listener)
+{
+    lock_guard<std::mutex> criticalSection{mutex};
+    finishListener = std::move(listener);
+}
+
+void PriorityExecutor::notifyFinished()
+{
+    // listener is copied to be called outside of critical section
+    FinishListener listener{};
+    {
+        lock_guard<std::mutex> criticalSection{mutex};
+        listener = finishListener;
+    }
+    if(listener) {
+        listener();
+    }
+}
+
+bool PriorityExecutor::cancel(const void* key)
+{
+    vector<Job*> cancelled{};
+    {
+        lock_guard<std::mutex> criticalSection{mutex};
+        auto k = keys.find(key);
+        if(k != keys.end() && queue.count(k->second)) {
+            cancel(k->second, cancelled);
+        }
+    }
+    finishCancelled(cancelled);
+    return cancelled.size();
+}
+
+size_t PriorityExecutor::cancelQueued(int priority, const void* keep)
+{
+    vector<Job*> cancelled{};
+    {
+        lock_guard<std::mutex> criticalSection{mutex};
+        for(auto i=queue.begin(); i!=queue.end(); ) {
+            Job* job = *i++;
+            if(job->priority == priority && (!keep || job->key != keep)) {
+                cancel(job, cancelled);
+            }
+        }
+    }
+    finishCancelled(cancelled);
+    return cancelled.size();
+}
+
+size_t PriorityExecutor::getQueuedCount()
+{
+    lock_guard<std::mutex> criticalSection{mutex};
+    return queue.size();
+}
+
+size_t PriorityExecutor::getRunningCount()
+{
+    lock_guard<std::mutex> criticalSection{mutex};
+    return running;
+}
+
+void PriorityExecutor::drain()
+{
+    vector<Job*> cancelled{};
+    {
+        lock_guard<std::mutex> criticalSection{mutex};
+        while(!queue.empty()) {
+            cancel(*queue.begin(), cancelled);
+        }
+    }
+    finishCancelled(cancelled);
+
+    unique_lock<std::mutex> criticalSection{mutex};
+    idle.wait(criticalSection, [this]{ return !running; });
+}
+
+void PriorityExecutor::shutdown()
+{
+    vector<Job*> cancelled{};
+    {
+        lock_guard<std::mutex> criticalSection{mutex};
+        stopped = true;
+        while(!queue.empty()) {
+            cancel(*queue.begin(), cancelled);
+        }
+    }
+    finishCancelled(cancelled);
+
+    wakeup.notify_all();
+    for(thread& t:workers) {
+        if(t.joinable()) {
+            t.join();
+        }
+    }
+}
+
+void PriorityExecutor::work()
+{
+    for(;;) {
+        unique_lock<std::mutex> criticalSection{mutex};
+        wakeup.wait(criticalSection, [this]{ return stopped || !queue.empty(); });
+        if(queue.empty()) {
+            return;
+        }
+        Job* job = *queue.begin();
+        queue.erase(queue.begin());
+        running++;
+        criticalSection.unlock();
+
+        bool result;
+        try {
+            result = job->task();
+        } catch(...) {
+            result = false;
+        }
+
+        criticalSection.lock();
+        if(!--running) {
+            idle.notify_all();
+        }
+        if(job->key) {
+            auto k = keys.find(job->key);
+            if(k != keys.end() && k->second == job) {
+                keys.erase(k);
+            }
+        }
+        criticalSection.unlock();
+
+        job->promise.set_value(result);
+        delete job;
+        notifyFinished();
+    }
+}
+
+} // m8r namespace
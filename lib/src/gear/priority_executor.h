@@ -0,0 +1,159 @@
+/*
+ priority_executor.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_PRIORITY_EXECUTOR_H
+#define M8R_PRIORITY_EXECUTOR_H
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace m8r {
+
+/**
+ * @brief Fixed size pool of threads executing (long running) tasks by priority.
+ *
+ * Tasks w/ higher priority are executed first and tasks w/ the same priority
+ * are executed from the most recent one (the most recent request - like
+ * the currently viewed N - is the most relevant one).
+ *
+ * Task may be identified by a key: task submitted w/ the key of a task which is
+ * queued or running is not executed again - future of the submitted task is
+ * returned instead. Queued tasks can be cancelled (e.g. requests which became
+ * stale). Result of a cancelled task is false.
+ *
+ * Future of every task is always made ready (by result, false on exception or
+ * cancel) and its shared state is owned by the future, therefore it stays valid
+ * even if executor is destroyed. Finish listener is notified whenever a future
+ * becomes ready, therefore consumers can wait for results w/o polling.
+ */
+class PriorityExecutor
+{
+public:
+    typedef std::function<bool()> Task;
+    // called instead of task when queued task is cancelled
+    typedef std::function<void()> CancelHandler;
+    // called (in executor or cancelling thread) when future of a task becomes ready
+    typedef std::function<void()> FinishListener;
+
+private:
+    struct Job {
+        const void* key;
+        int priority;
+        unsigned long sequence;
+        Task task;
+        CancelHandler onCancel;
+        std::promise<bool> promise;
+        std::shared_future<bool> future;
+    };
+
+    struct JobOrder {
+        bool operator()(const Job* a, const Job* b) const {
+            if(a->priority != b->priority) {
+                return a->priority > b->priority;
+            }
+            return a->sequence > b->sequence;
+        }
+    };
+
+    size_t size;
+
+    std::mutex mutex;
+    std::condition_variable wakeup;
+    // notified when the last running job finished
+    std::condition_variable idle;
+    // queued jobs ordered by priority (the first one is executed next)
+    std::set<Job*,JobOrder> queue;
+    // queued and running jobs by key
+    std::unordered_map<const void*,Job*> keys;
+    unsigned long sequence;
+    size_t running;
+    bool stopped;
+    FinishListener finishListener;
+
+    std::vector<std::thread> workers;
+
+public:
+    /**
+     * @brief Create executor w/ given number of worker threads (0 ~ number of CPU cores).
+     */
+    explicit PriorityExecutor(size_t size=0);
+    PriorityExecutor(const PriorityExecutor&) = delete;
+    PriorityExecutor(const PriorityExecutor&&) = delete;
+    PriorityExecutor &operator=(const PriorityExecutor&) = delete;
+    PriorityExecutor &operator=(const PriorityExecutor&&) = delete;
+    ~PriorityExecutor();
+
+    size_t getSize() const { return size; }
+
+    /**
+     * @brief Submit task w/ given priority.
+     *
+     * If key is set and task w/ the same key is queued or running, then its future
+     * is returned (queued task gets the higher of both priorities) and queued
+     * is set to false.
+     */
+    std::shared_future<bool> submit(const void* key, int priority, Task task, CancelHandler onCancel=nullptr, bool* queued=nullptr);
+
+    /**
+     * @brief Cancel queued task (running task is finished).
+     */
+    bool cancel(const void* key);
+
+    /**
+     * @brief Cancel queued tasks w/ given priority except the one w/ given key.
+     *
+     * @return number of cancelled tasks.
+     */
+    size_t cancelQueued(int priority, const void* keep=nullptr);
+
+    /**
+     * @brief Set listener notified after future of a task became ready (nullptr to unset).
+     *
+     * Listener must be fast and must not submit tasks.
+     */
+    void setFinishListener(FinishListener listener);
+
+    size_t getQueuedCount();
+    size_t getRunningCount();
+
+    /**
+     * @brief Cancel queued tasks and wait for running tasks to finish (executor stays usable).
+     */
+    void drain();
+
+    /**
+     * @brief Cancel queued tasks, wait for running tasks to finish and stop workers.
+     */
+    void shutdown();
+
+private:
+    void work();
+    // caller must hold mutex
+    void cancel(Job* job, std::vector<Job*>& cancelled);
+    void finishCancelled(std::vector<Job*>& cancelled);
+    void notifyFinished();
+};
+
+}
+#endif // M8R_PRIORITY_EXECUTOR_H
@@ -0,0 +1,172 @@
+/*
+ work_stealing_pool.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "work_stealing_pool.h"
+
+namespace m8r {
+
+using namespace std;
+
+WorkStealingPool::WorkStealingPool(size_t size)
+    : size{size?size:getCpuCoresCount()},
+      queues(this->size),
+      threads{},
+      batch{0},
+      batchWorkers{0},
+      busyWorkers{0},
+      stopped{false},
+      failure{}
+{
+}
+
+WorkStealingPool::~WorkStealingPool()
+{
+    {
+        lock_guard<mutex> criticalSection{batchMutex};
+        stopped = true;
+    }
+    batchStarted.notify_all();
+    for(thread& t:threads) {
+        t.join();
+    }
+}
+
+size_t WorkStealingPool::getCpuCoresCount()
+{
+    unsigned cores = std::thread::hardware_concurrency();
+    return cores?cores:1;
+}
+
+bool WorkStealingPool::pop(Queue& queue, Task& task, bool back)
+{
+    lock_guard<mutex> criticalSection{queue.mutex};
+    if(queue.tasks.empty()) {
+        return false;
+    }
+    if(back) {
+        task = std::move(queue.tasks.back());
+        queue.tasks.pop_back();
+    } else {
+        task = std::move(queue.tasks.front());
+        queue.tasks.pop_front();
+    }
+    return true;
+}
+
+void WorkStealingPool::run(vector<Task>& tasks)
+{
+    if(tasks.empty()) {
+        return;
+    }
+
+    lock_guard<mutex> runCriticalSection{runMutex};
+
+    size_t workers = std::min(size, tasks.size());
+    if(workers == 1) {
+        for(Task& task:tasks) {
+            task();
+        }
+        return;
+    }
+
+    if(threads.empty()) {
+        for(size_t i=1; i<size; i++) {
+            threads.push_back(thread(&WorkStealingPool::loop, this, i));
+        }
+    }
+
+    for(size_t i=0; i<tasks.size(); i++) {
+        queues[i%workers].tasks.push_back(std::move(tasks[i]));
+    }
+    {
+        lock_guard<mutex> criticalSection{batchMutex};
+        failure = nullptr;
+        batchWorkers = workers;
+        busyWorkers = workers-1;
+        batch++;
+    }
+    batchStarted.notify_all();
+
+    // calling thread is the worker 0
+    work(0, workers);
+
+    exception_ptr batchFailure{};
+    {
+        unique_lock<mutex> criticalSection{batchMutex};
+        batchFinished.wait(criticalSection, [this]() { return busyWorkers == 0; });
+        batchFailure = failure;
+        failure = nullptr;
+    }
+    if(batchFailure) {
+        std::rethrow_exception(batchFailure);
+    }
+}
+
+void WorkStealingPool::loop(size_t id)
+{
+    unsigned long done = 0;
+    for(;;) {
+        size_t workers;
+        {
+            unique_lock<mutex> criticalSection{batchMutex};
+            batchStarted.wait(criticalSection, [this,done]() { return stopped || batch != done; });
+            if(stopped) {
+                return;
+            }
+            done = batch;
+            workers = batchWorkers;
+        }
+        // smaller batch than pool
+        if(id >= workers) {
+            continue;
+        }
+
+        work(id, workers);
+
+        lock_guard<mutex> criticalSection{batchMutex};
+        if(--busyWorkers == 0) {
+            batchFinished.notify_one();
+        }
+    }
+}
+
+void WorkStealingPool::work(size_t id, size_t workers)
+{
+    // no tasks are added while running > all queues empty means the batch is done
+    Task task{};
+    for(;;) {
+        bool found = pop(queues[id], task, true);
+        for(size_t i=1; !found && i<workers; i++) {
+            found = pop(queues[(id+i)%workers], task, false);
+        }
+        if(!found) {
+            return;
+        }
+
+        try {
+            task();
+        } catch(...) {
+            lock_guard<mutex> criticalSection{batchMutex};
+            if(!failure) {
+                failure = std::current_exception();
+            }
+        }
+    }
+}
+
+} // m8r namespace
@@ -0,0 +1,105 @@
+/*
+ work_stealing_pool.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_WORK_STEALING_POOL_H
+#define M8R_WORK_STEALING_POOL_H
+
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace m8r {
+
+/**
+ * @brief Work stealing pool of threads for batches of CPU bound tasks.
+ *
+ * Batch tasks are distributed round-robin to per worker queues. Each worker
+ * takes tasks from the back of its own queue and once it's empty, it steals
+ * tasks from the front of other workers' queues. Therefore unbalanced tasks
+ * (like upper triangular matrix rows) keep all the workers busy.
+ *
+ * Worker threads are started by the first batch and they're reused by the next
+ * batches until the pool is destroyed. Batches are run one at a time, therefore
+ * a pool shared by concurrent callers never runs more than size threads.
+ */
+class WorkStealingPool
+{
+public:
+    typedef std::function<void()> Task;
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    size_t size;
+    std::vector<Queue> queues;
+    // workers 1..size-1 (calling thread is the worker 0)
+    std::vector<std::thread> threads;
+
+    // batches are run one at a time
+    std::mutex runMutex;
+    std::mutex batchMutex;
+    std::condition_variable batchStarted;
+    std::condition_variable batchFinished;
+    unsigned long batch;
+    size_t batchWorkers;
+    size_t busyWorkers;
+    bool stopped;
+    std::exception_ptr failure;
+
+public:
+    /**
+     * @brief Create pool w/ given number of workers (0 ~ number of CPU cores).
+     */
+    explicit WorkStealingPool(size_t size=0);
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool(const WorkStealingPool&&) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool&) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool&&) = delete;
+    ~WorkStealingPool();
+
+    size_t getSize() const { return size; }
+
+    /**
+     * @brief Run tasks and wait for all of them to finish.
+     *
+     * Tasks must not run batches in the same pool (concurrent runs wait for each other).
+     *
+     * The first exception thrown by a task (if any) is re-thrown to the caller.
+     */
+    void run(std::vector<Task>& tasks);
+
+    /**
+     * @brief Get number of CPU cores (at least 1).
+     */
+    static size_t getCpuCoresCount();
+
+private:
+    void loop(size_t id);
+    void work(size_t id, size_t workers);
+    static bool pop(Queue& queue, Task& task, bool back);
+};
+
+}
+#endif // M8R_WORK_STEALING_POOL_H
@@ -0,0 +1,68 @@
+/*
+ aa_matrix.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "aa_matrix.h"
+
+namespace m8r {
+
+using namespace std;
+
+constexpr float AaMatrix::NOT_SET;
+constexpr float AaMatrix::MAX_AA;
+constexpr AaMatrix::Cell AaMatrix::CELL_NOT_SET;
+constexpr float AaMatrix::CELL_SCALE;
+
+AaMatrix::AaMatrix()
+    : size{0},
+      cells{}
+{
+}
+
+AaMatrix::~AaMatrix()
+{
+}
+
+void AaMatrix::reset(size_t size)
+{
+    this->size = size;
+    cells.assign(size*(size+1)/2, CELL_NOT_SET);
+}
+
+void AaMatrix::resize(size_t size)
+{
+    if(size > this->size) {
+        this->size = size;
+        cells.resize(size*(size+1)/2, CELL_NOT_SET);
+    }
+}
+
+void AaMatrix::clearRow(size_t y)
+{
+    for(size_t x=0; x<size; x++) {
+        cells[index(x,y)] = CELL_NOT_SET;
+    }
+}
+
+void AaMatrix::clear()
+{
+    size = 0;
+    cells.clear();
+    cells.shrink_to_fit();
+}
+
+} // m8r namespace
@@ -0,0 +1,135 @@
+/*
+ aa_matrix.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_AA_MATRIX_H
+#define M8R_AA_MATRIX_H
+
+#include <cstdint>
+#include <cmath>
+#include <vector>
+#include <utility>
+
+namespace m8r {
+
+/**
+ * @brief Symmetric associations assessment matrix w/ packed triangular storage.
+ *
+ * Only cells on and above diagonal are stored - column by column in a single contiguous
+ * allocation (column y holds cells [0..y][y]) - and accessor handles the symmetry.
+ * Cell index doesn't depend on matrix size, therefore matrix can grow (new Ns) w/o
+ * moving already calculated cells.
+ * Rankings are quantized to 16-bit cells, therefore N x N matrix needs N*(N+1) bytes
+ * (instead of N*N*4 bytes of full float matrix) e.g. 2.5GB instead of 10GB for 50k Ns.
+ *
+ * Cell value 0 is reserved for NOT SET ranking. Diagonal cell is set once AA row/column
+ * cross of the N has been calculated i.e. it is a compact "row computed" marker.
+ *
+ * Different cells may be written by different threads concurrently.
+ */
+class AaMatrix
+{
+public:
+    typedef std::uint16_t Cell;
+
+    static constexpr float NOT_SET = -1.;
+    // AA rankings are expected in <0, MAX_AA> - higher rankings are saturated
+    static constexpr float MAX_AA = 2.;
+    static constexpr Cell CELL_NOT_SET = 0;
+
+private:
+    static constexpr float CELL_SCALE = (UINT16_MAX-1)/MAX_AA;
+
+    size_t size;
+    std::vector<Cell> cells;
+
+public:
+    explicit AaMatrix();
+    AaMatrix(const AaMatrix&) = delete;
+    AaMatrix(const AaMatrix&&) = delete;
+    AaMatrix &operator=(const AaMatrix&) = delete;
+    AaMatrix &operator=(const AaMatrix&&) = delete;
+    ~AaMatrix();
+
+    size_t getSize() const { return size; }
+    size_t getBytesize() const { return cells.size()*sizeof(Cell); }
+
+    /**
+     * @brief Resize matrix to size x size and set all rankings to NOT SET.
+     */
+    void reset(size_t size);
+    /**
+     * @brief Grow matrix to size x size - new rankings are NOT SET.
+     */
+    void resize(size_t size);
+    void clear();
+
+    float get(size_t x, size_t y) const {
+        return decode(cells[index(x,y)]);
+    }
+    void set(size_t x, size_t y, float aa) {
+        cells[index(x,y)] = encode(aa);
+    }
+    bool isSet(size_t x, size_t y) const {
+        return cells[index(x,y)] != CELL_NOT_SET;
+    }
+
+    /**
+     * @brief Raw (quantized) cells of the packed matrix e.g. to persist AA.
+     */
+    size_t getCellsCount() const { return cells.size(); }
+    Cell getCell(size_t i) const { return cells[i]; }
+    void setCell(size_t i, Cell cell) { cells[i] = cell; }
+    Cell getCell(size_t x, size_t y) const { return cells[index(x,y)]; }
+    void setCell(size_t x, size_t y, Cell cell) { cells[index(x,y)] = cell; }
+
+    /**
+     * @brief Has been AA row/column cross of given N calculated?
+     */
+    bool isRowCalculated(size_t y) const { return isSet(y,y); }
+    void setRowCalculated(size_t y) { set(y,y,1.); }
+
+    /**
+     * @brief Set all rankings of AA row/column cross of given N (incl. diagonal) to NOT SET.
+     */
+    void clearRow(size_t y);
+
+    static Cell encode(float aa) {
+        if(aa < 0.) {
+            return CELL_NOT_SET;
+        }
+        if(aa > MAX_AA) {
+            aa = MAX_AA;
+        }
+        return static_cast<Cell>(std::lround(aa*CELL_SCALE))+1;
+    }
+    static float decode(Cell cell) {
+        return cell==CELL_NOT_SET ? NOT_SET : (cell-1)/CELL_SCALE;
+    }
+
+private:
+    size_t index(size_t x, size_t y) const {
+        if(x > y) {
+            std::swap(x,y);
+        }
+        // offset of column y + row in column
+        return y*(y+1)/2 + x;
+    }
+};
+
+}
+#endif // M8R_AA_MATRIX_H
@@ -19,14 +19,201 @@
 
 #include "aa_model.h"
 
+#include <algorithm>
+#include <cmath>
+
 namespace m8r {
 
+using namespace std;
+
+constexpr int AssociationAssessmentModel::HIDDEN_NEURONS;
+constexpr int AssociationAssessmentModel::TRAINING_EPOCHS;
+constexpr double AssociationAssessmentModel::TRAINING_LEARNING_RATE;
+constexpr int AssociationAssessmentModel::FEATURES_SIZE;
+constexpr size_t AssociationAssessmentModel::WEIGHTS_SIZE;
+constexpr size_t AssociationAssessmentModel::CHUNK_SIZE;
+
+namespace {
+
+// deterministic pseudo-random numbers (genann uses rand())
+uint64_t nextRandom(uint64_t& state)
+{
+    uint64_t x = (state += 0x9e3779b97f4a7c15ull);
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+inline float sigmoid(float a)
+{
+    return 1.f/(1.f+std::exp(-a));
+}
+
+}
+
 AssociationAssessmentModel::AssociationAssessmentModel()
+    : weights{}
 {
 }
 
 AssociationAssessmentModel::~AssociationAssessmentModel()
 {
+    forget();
+}
+
+void AssociationAssessmentModel::forget()
+{
+    weights.clear();
+}
+
+bool AssociationAssessmentModel::setWeights(const vector<float>& weights)
+{
+    if(weights.size() != WEIGHTS_SIZE) {
+        forget();
+        return weights.empty();
+    }
+    this->weights = weights;
+    return true;
+}
+
+bool AssociationAssessmentModel::train(
+        const AssociationAssessmentFeatureBatch& samples,
+        const vector<float>& labels,
+        int epochs,
+        double learningRate)
+{
+    forget();
+    const size_t size = samples.getSize();
+    if(!size || labels.size() != size) {
+        return false;
+    }
+
+    genann* ann = genann_init(FEATURES_SIZE, 1, HIDDEN_NEURONS, 1);
+    if(!ann) {
+        return false;
+    }
+    // exact sigmoid (cached one is a lookup table) so that inference gives the same rankings
+    ann->activation_hidden = genann_act_sigmoid;
+    ann->activation_output = genann_act_sigmoid;
+    uint64_t random = 0x61612d6d6f64656cull;
+    for(int i=0; i<ann->total_weights; i++) {
+        ann->weight[i] = static_cast<double>(nextRandom(random)>>11)/static_cast<double>(1ull<<53) - 0.5;
+    }
+
+    // samples are stored as columns - network is trained row by row
+    vector<double> rows(size*FEATURES_SIZE);
+    for(int f=0; f<FEATURES_SIZE; f++) {
+        const float* column = samples.getColumn(f);
+        for(size_t i=0; i<size; i++) {
+            rows[i*FEATURES_SIZE+f] = column[i];
+        }
+    }
+
+    vector<size_t> order(size);
+    for(size_t i=0; i<size; i++) {
+        order[i] = i;
+    }
+    for(int e=0; e<epochs; e++) {
+        // shuffle samples so that network doesn't learn their order
+        for(size_t i=size-1; i>0; i--) {
+            std::swap(order[i], order[nextRandom(random)%(i+1)]);
+        }
+        for(size_t i:order) {
+            double desired = labels[i];
+            genann_train(ann, rows.data()+i*FEATURES_SIZE, &desired, learningRate);
+        }
+    }
+
+    // network is needed for training only - inference uses weights
+    weights.assign(ann->weight, ann->weight+ann->total_weights);
+    genann_free(ann);
+    MF_DEBUG("AA model trained w/ " << size << " samples in " << epochs << " epochs" << endl);
+    return true;
+}
+
+uint64_t AssociationAssessmentModel::getFingerprint() const
+{
+    if(weights.empty()) {
+        return 0;
+    }
+
+    // FNV-1a of weights
+    uint64_t hash = 14695981039346656037ULL;
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(weights.data());
+    for(size_t i=0; i<weights.size()*sizeof(float); i++) {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+void AssociationAssessmentModel::assess(const AssociationAssessmentFeatureBatch& batch, float* scores) const
+{
+    const float* columns[FEATURES_SIZE];
+    for(int f=0; f<FEATURES_SIZE; f++) {
+        columns[f] = batch.getColumn(f);
+    }
+    assess(columns, batch.getSize(), scores);
+}
+
+float AssociationAssessmentModel::assess(const AssociationAssessmentNotesFeature& feature) const
+{
+    const float* columns[FEATURES_SIZE];
+    for(int f=0; f<FEATURES_SIZE; f++) {
+        columns[f] = feature.getFeatures()+f;
+    }
+    float score;
+    assess(columns, 1, &score);
+    return score;
+}
+
+void AssociationAssessmentModel::assess(const float* const* columns, size_t count, float* scores) const
+{
+    if(weights.empty()) {
+        // hand-weighted metric
+        const float* types = columns[AssociationAssessmentNotesFeature::IDX_TYPE_MATCHES];
+        const float* outlines = columns[AssociationAssessmentNotesFeature::IDX_SAME_OUTLINE];
+        const float* tags = columns[AssociationAssessmentNotesFeature::IDX_SIMILARITY_BY_TAGS];
+        const float* titles = columns[AssociationAssessmentNotesFeature::IDX_SIMILARITY_BY_TITLES];
+        const float* descriptions = columns[AssociationAssessmentNotesFeature::IDX_SIMILARITY_BY_DESCRIPTIONS];
+        const float* rels = columns[AssociationAssessmentNotesFeature::IDX_SIMILARITY_BY_SAME_TARGETS_RELS];
+        for(size_t i=0; i<count; i++) {
+            scores[i] = AssociationAssessmentNotesFeature::metric(
+                types[i], outlines[i], tags[i], titles[i], descriptions[i], rels[i]);
+        }
+        return;
+    }
+
+    // genann neuron: activation(-bias + sum(weight*input))
+    const float* output = weights.data()+HIDDEN_NEURONS*(1+FEATURES_SIZE);
+    float hidden[CHUNK_SIZE];
+    float sums[CHUNK_SIZE];
+    for(size_t from=0; from<count; from+=CHUNK_SIZE) {
+        const size_t n = std::min(CHUNK_SIZE, count-from);
+        for(size_t i=0; i<n; i++) {
+            sums[i] = -output[0];
+        }
+        for(int h=0; h<HIDDEN_NEURONS; h++) {
+            const float* w = weights.data()+h*(1+FEATURES_SIZE);
+            for(size_t i=0; i<n; i++) {
+                hidden[i] = -w[0];
+            }
+            for(int f=0; f<FEATURES_SIZE; f++) {
+                const float wf = w[1+f];
+                const float* column = columns[f]+from;
+                for(size_t i=0; i<n; i++) {
+                    hidden[i] += wf*column[i];
+                }
+            }
+            const float wh = output[1+h];
+            for(size_t i=0; i<n; i++) {
+                sums[i] += wh*sigmoid(hidden[i]);
+            }
+        }
+        for(size_t i=0; i<n; i++) {
+            scores[from+i] = sigmoid(sums[i]);
+        }
+    }
 }
 
 } // m8r namespace
@@ -19,15 +19,47 @@
 #ifndef M8R_ASSOCIATION_ASSESSMENT_MODEL_H
 #define M8R_ASSOCIATION_ASSESSMENT_MODEL_H
 
+#include <cstdint>
+#include <vector>
+
+#include "../../debug.h"
 #include "aa_notes_feature.h"
+#include "nn/genann.h"
 
 namespace m8r {
 
 /**
  * @brief Associations assessment neural network model.
+ *
+ * Model is a genann network w/ FEATURES_SIZE inputs, a single hidden layer and
+ * the association ranking as output. Until the network is trained, model assesses
+ * features using hand-weighted AssociationAssessmentNotesFeature::areNotesAssociatedMetric().
+ *
+ * Network is trained offline (when Memory is dreamed) using samples of associations
+ * accepted or rejected by user. Inference doesn't use genann (one call per pair w/
+ * double precision): batch of features stored as structure of arrays is assessed
+ * by loops over feature columns w/ network weights - loops are vectorized by compiler.
+ * Single feature is assessed by the same code (batch of size 1), therefore both give
+ * the same ranking.
  */
 class AssociationAssessmentModel
 {
+public:
+    static constexpr int HIDDEN_NEURONS = 8;
+    static constexpr int TRAINING_EPOCHS = 300;
+    static constexpr double TRAINING_LEARNING_RATE = 0.5;
+
+private:
+    static constexpr int FEATURES_SIZE = AssociationAssessmentNotesFeature::FEATURES_SIZE;
+    // hidden neurons (bias + FEATURES_SIZE weights each) and output neuron (bias + HIDDEN_NEURONS weights)
+    static constexpr size_t WEIGHTS_SIZE = HIDDEN_NEURONS*(1+FEATURES_SIZE) + 1+HIDDEN_NEURONS;
+    // rows assessed at once (hidden neuron activations are kept on stack)
+    static constexpr size_t CHUNK_SIZE = 64;
+
+    // inference weights copied from trained network (empty until trained): hidden neurons
+    // (bias + FEATURES_SIZE weights each) followed by output neuron (bias + HIDDEN_NEURONS weights)
+    std::vector<float> weights;
+
 public:
     explicit AssociationAssessmentModel();
     AssociationAssessmentModel(const AssociationAssessmentModel&) = delete;
@@ -35,6 +67,58 @@ public:
     AssociationAssessmentModel &operator=(const AssociationAssessmentModel&) = delete;
     AssociationAssessmentModel &operator=(const AssociationAssessmentModel&&) = delete;
     ~AssociationAssessmentModel();
+
+    bool isTrained() const { return !weights.empty(); }
+
+    /**
+     * @brief Train network using labeled features (1 ~ associated, 0 ~ not associated).
+     *
+     * Training is deterministic i.e. the same samples give the same model.
+     *
+     * @return false if there are no samples (model is forgotten).
+     */
+    bool train(
+            const AssociationAssessmentFeatureBatch& samples,
+            const std::vector<float>& labels,
+            int epochs=TRAINING_EPOCHS,
+            double learningRate=TRAINING_LEARNING_RATE);
+
+    /**
+     * @brief Forget trained network i.e. use hand-weighted metric.
+     */
+    void forget();
+
+    /**
+     * @brief Get trained weights (empty if not trained) e.g. to persist model.
+     */
+    const std::vector<float>& getWeights() const { return weights; }
+    /**
+     * @brief Restore persisted weights - empty weights or weights of different network are forgotten.
+     *
+     * @return false if weights don't match network.
+     */
+    bool setWeights(const std::vector<float>& weights);
+
+    /**
+     * @brief Assess batch of features - rankings are written to scores (batch size).
+     */
+    void assess(const AssociationAssessmentFeatureBatch& batch, float* scores) const;
+
+    /**
+     * @brief Assess single feature.
+     */
+    float assess(const AssociationAssessmentNotesFeature& feature) const;
+
+    /**
+     * @brief Get hash of trained weights (0 if not trained).
+     */
+    std::uint64_t getFingerprint() const;
+
+private:
+    /**
+     * @brief Assess count rows - columns[i] points to contiguous values of i-th feature.
+     */
+    void assess(const float* const* columns, size_t count, float* scores) const;
 };
 
 }
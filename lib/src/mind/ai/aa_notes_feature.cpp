@@ -35,4 +35,17 @@ void AssociationAssessmentNotesFeature::clearFeatures()
     for(int i=0; i<FEATURES_SIZE; i++) features[i]=0.;
 }
 
+constexpr size_t AssociationAssessmentFeatureBatch::DEFAULT_CAPACITY;
+
+AssociationAssessmentFeatureBatch::AssociationAssessmentFeatureBatch(size_t capacity)
+    : capacity(capacity),
+      size(0),
+      columns(AssociationAssessmentNotesFeature::FEATURES_SIZE*capacity)
+{
+}
+
+AssociationAssessmentFeatureBatch::~AssociationAssessmentFeatureBatch()
+{
+}
+
 } // m8r namespace
@@ -20,6 +20,7 @@
 #define M8R_ASSOCIATION_ASSESSMENT_NOTES_FEATURE_H
 
 #include <map>
+#include <vector>
 
 #include "../../debug.h"
 #include "../../model/note.h"
@@ -61,6 +62,9 @@ public:
 
     void clearFeatures();
 
+    float getFeature(int idx) const { return features[idx]; }
+    const float* getFeatures() const { return features; }
+
     void setHaveMutualRel(bool haveRel) {
         features[IDX_HAVE_MUTUAL_REL] = haveRel?1.:0.;
     }
@@ -128,17 +132,83 @@ public:
 //                "by-descs  : " << features[IDX_SIMILARITY_BY_DESCRIPTIONS] << std::endl
 //                ;
 #endif
+        return metric(
+            features[IDX_TYPE_MATCHES],
+            features[IDX_SAME_OUTLINE],
+            features[IDX_SIMILARITY_BY_TAGS],
+            features[IDX_SIMILARITY_BY_TITLES],
+            features[IDX_SIMILARITY_BY_DESCRIPTIONS],
+            features[IDX_SIMILARITY_BY_SAME_TARGETS_RELS]);
+    }
+
+    /**
+     * @brief Hand-weighted metric of feature values (AA model applies it to feature columns).
+     */
+    static float metric(
+            float typeMatches,
+            float sameOutline,
+            float similarityByTags,
+            float similarityByTitles,
+            float similarityByDescriptions,
+            float similarityBySameTargetRels)
+    {
         return
-            // features[IDX_HAVE_MUTUAL_REL] * 0.25 + ... temporarily added to TEXT
-            features[IDX_TYPE_MATCHES] * 0.1 +
-            features[IDX_SAME_OUTLINE] * 0.05 +
-            features[IDX_SIMILARITY_BY_TAGS] * 0.2 +
-            features[IDX_SIMILARITY_BY_TITLES] * 0.2 +
-            features[IDX_SIMILARITY_BY_DESCRIPTIONS] * (0.2+0.25) +
-            features[IDX_SIMILARITY_BY_SAME_TARGETS_RELS] * 0.1
+            // haveMutualRel * 0.25 + ... temporarily added to TEXT
+            typeMatches * 0.1 +
+            sameOutline * 0.05 +
+            similarityByTags * 0.2 +
+            similarityByTitles * 0.2 +
+            similarityByDescriptions * (0.2+0.25) +
+            similarityBySameTargetRels * 0.1
             ;
     }
 };
 
+/**
+ * @brief Batch of Notes Association Assessment features stored as structure of arrays.
+ *
+ * Every feature is stored in its own contiguous column, therefore model can assess
+ * whole batch using (vectorizable) loops over columns instead of assessing features
+ * pair by pair.
+ */
+class AssociationAssessmentFeatureBatch
+{
+public:
+    // batch fits L1/L2 cache
+    static constexpr size_t DEFAULT_CAPACITY = 256;
+
+private:
+    size_t capacity;
+    size_t size;
+    // FEATURES_SIZE columns w/ capacity rows
+    std::vector<float> columns;
+
+public:
+    explicit AssociationAssessmentFeatureBatch(size_t capacity=DEFAULT_CAPACITY);
+    AssociationAssessmentFeatureBatch(const AssociationAssessmentFeatureBatch&) = delete;
+    AssociationAssessmentFeatureBatch(const AssociationAssessmentFeatureBatch&&) = delete;
+    AssociationAssessmentFeatureBatch &operator=(const AssociationAssessmentFeatureBatch&) = delete;
+    AssociationAssessmentFeatureBatch &operator=(const AssociationAssessmentFeatureBatch&&) = delete;
+    ~AssociationAssessmentFeatureBatch();
+
+    size_t getCapacity() const { return capacity; }
+    size_t getSize() const { return size; }
+    bool isFull() const { return size == capacity; }
+    void clear() { size = 0; }
+
+    /**
+     * @brief Append feature (batch must not be full).
+     */
+    void add(const AssociationAssessmentNotesFeature& feature) {
+        const float* f = feature.getFeatures();
+        for(int i=0; i<AssociationAssessmentNotesFeature::FEATURES_SIZE; i++) {
+            columns[i*capacity+size] = f[i];
+        }
+        size++;
+    }
+
+    const float* getColumn(int idx) const { return columns.data()+idx*capacity; }
+};
+
 }
 #endif // M8R_ASSOCIATION_ASSESSMENT_NOTES_FEATURE_H
@@ -0,0 +1,75 @@
+/*
+ aa_top_k.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "aa_top_k.h"
+
+namespace m8r {
+
+using namespace std;
+
+AaTopK::AaTopK()
+    : size{0},
+      k{0},
+      entries{},
+      counts{},
+      calculated{}
+{
+}
+
+AaTopK::~AaTopK()
+{
+}
+
+void AaTopK::reset(size_t size, size_t k)
+{
+    this->size = size;
+    this->k = k;
+    entries.assign(size*k, Entry{0,0.});
+    counts.assign(size, 0);
+    calculated.assign(size, 0);
+}
+
+void AaTopK::resize(size_t size)
+{
+    if(size > this->size) {
+        this->size = size;
+        entries.resize(size*k, Entry{0,0.});
+        counts.resize(size, 0);
+        calculated.resize(size, 0);
+    }
+}
+
+void AaTopK::clear()
+{
+    size = k = 0;
+    entries.clear();
+    entries.shrink_to_fit();
+    counts.clear();
+    counts.shrink_to_fit();
+    calculated.clear();
+    calculated.shrink_to_fit();
+}
+
+void AaTopK::setRowCalculated(size_t y)
+{
+    // sorting min-heap w/ inverted comparator gives descending order
+    std::sort_heap(entries.begin()+y*k, entries.begin()+y*k+counts[y], compare);
+    calculated[y] = 1;
+}
+
+} // m8r namespace
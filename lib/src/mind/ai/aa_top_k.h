@@ -0,0 +1,129 @@
+/*
+ aa_top_k.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_AA_TOP_K_H
+#define M8R_AA_TOP_K_H
+
+#include <cstdint>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+namespace m8r {
+
+/**
+ * @brief Sparse associations assessment store w/ K best associations of every N.
+ *
+ * Unlike AaMatrix, which keeps rankings of all N1/N2 tuples, only a bounded top-K
+ * list is kept for every row i.e. N and the dense matrix is never materialized.
+ * Rows are stored in a single contiguous allocation (K entries per row) and while
+ * a row is being calculated it's kept as a min-heap - the weakest association is on
+ * top and it's replaced once a better association is offered. Therefore the store
+ * needs N*K*8 bytes e.g. 8MB for 100k Ns and leaderboard of 10 Ns.
+ *
+ * Different rows may be written by different threads concurrently.
+ */
+class AaTopK
+{
+public:
+    // N index (to AI Ns vector) and AA ranking
+    typedef std::pair<std::uint32_t,float> Entry;
+
+private:
+    size_t size;
+    size_t k;
+    std::vector<Entry> entries;
+    std::vector<std::uint16_t> counts;
+    std::vector<std::uint8_t> calculated; // not vector<bool> - rows are marked by different threads
+
+public:
+    explicit AaTopK();
+    AaTopK(const AaTopK&) = delete;
+    AaTopK(const AaTopK&&) = delete;
+    AaTopK &operator=(const AaTopK&) = delete;
+    AaTopK &operator=(const AaTopK&&) = delete;
+    ~AaTopK();
+
+    size_t getSize() const { return size; }
+    size_t getK() const { return k; }
+    size_t getBytesize() const {
+        return entries.size()*sizeof(Entry) + counts.size()*sizeof(std::uint16_t) + calculated.size();
+    }
+
+    /**
+     * @brief Resize store to size rows w/ (up to) k entries and clear all rows.
+     */
+    void reset(size_t size, size_t k);
+    /**
+     * @brief Grow store to size rows - new rows are empty.
+     */
+    void resize(size_t size);
+    void clear();
+
+    /**
+     * @brief Offer association of N x to row y - kept only if it's among K best.
+     */
+    void offer(size_t y, size_t x, float aa) {
+        offer(&entries[y*k], counts[y], k, x, aa);
+    }
+
+    /**
+     * @brief Offer association to a min-heap w/ given capacity.
+     */
+    static void offer(Entry* heap, std::uint16_t& count, size_t capacity, size_t x, float aa) {
+        if(count < capacity) {
+            heap[count++] = Entry{static_cast<std::uint32_t>(x), aa};
+            std::push_heap(heap, heap+count, compare);
+        } else if(capacity && aa > heap[0].second) {
+            std::pop_heap(heap, heap+count, compare);
+            heap[count-1] = Entry{static_cast<std::uint32_t>(x), aa};
+            std::push_heap(heap, heap+count, compare);
+        }
+    }
+
+    bool isRowCalculated(size_t y) const { return calculated[y]; }
+
+    /**
+     * @brief Mark row as calculated - row heap is sorted from the best association (no more offers).
+     */
+    void setRowCalculated(size_t y);
+
+    /**
+     * @brief Clear row to be calculated again (e.g. when associations of N changed).
+     */
+    void invalidateRow(size_t y) {
+        counts[y] = 0;
+        calculated[y] = 0;
+    }
+
+    /**
+     * @brief Get row entries (ordered from the best association if the row is calculated).
+     */
+    void getRow(size_t y, std::vector<Entry>& result) const {
+        result.insert(result.end(), entries.begin()+y*k, entries.begin()+y*k+counts[y]);
+    }
+
+private:
+    // min-heap ~ weakest association on top
+    static bool compare(const Entry& e1, const Entry& e2) {
+        return e1.second > e2.second;
+    }
+};
+
+}
+#endif // M8R_AA_TOP_K_H
@@ -23,8 +23,10 @@ namespace m8r {
 using namespace std;
 
 Ai::Ai(Memory& memory, Mind& mind)
+    : memory(memory),
+      nearDuplicates{}
 #ifdef MF_NER
-    : ner{}
+    , ner{}
 #endif
 {
     switch(Configuration::getInstance().getAaAlgorithm()) {
@@ -43,18 +45,14 @@ Ai::Ai(Memory& memory, Mind& mind)
     static std::string nerModelPath{"/home/dvorka/p/mindforger/lab/ner/MITIE/MITIE-models/english/ner_model.dat"};
     ner.setNerModel(nerModelPath);
 #endif
+
+    memory.setObserver(this);
 }
 
 Ai::~Ai()
 {
+    memory.setObserver(nullptr);
     if(aa) delete aa;
 }
 
-void Ai::trainAaNn()
-{
-    MF_DEBUG("AI: training AA NN..." << endl);
-    // TODO train NN using a reasonable number of features: createAaFeature()
-    MF_DEBUG("AI: AA NN trained!" << endl);
-}
-
 } // m8r namespace
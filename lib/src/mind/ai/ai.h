@@ -29,6 +29,7 @@
 #include "./aa_model.h"
 #include "./ai_aa_weighted_fts.h"
 #include "./ai_aa_bow.h"
+#include "./ai_near_duplicates.h"
 #ifdef MF_NER
     #include "./nlp/named_entity_recognition.h"
 #endif
@@ -65,9 +66,10 @@ namespace m8r {
  *  SLEEPING
  *
  */
-class Ai
+class Ai : public MemoryObserver
 {
 private:
+    Memory& memory;
 
     /*
      * Associations
@@ -76,19 +78,19 @@ private:
     // Associations assessment implemenations: AA @ weighted FTS, AA @ BoW
     AiAssociationsAssessment* aa;
 
-#ifdef MF_NER
     /*
-     * Named-entity recognition (NER)
+     * Near-duplicates
      */
 
-    NamedEntityRecognition ner;
-#endif
+    AiNearDuplicates nearDuplicates;
 
+#ifdef MF_NER
     /*
-     * Neural network models
+     * Named-entity recognition (NER)
      */
 
-    // TODO AssociationAssessmentModel* aaModel;
+    NamedEntityRecognition ner;
+#endif
 
 public:
     explicit Ai(Memory& memory, Mind& mind);
@@ -96,7 +98,7 @@ public:
     Ai(const Ai&&) = delete;
     Ai &operator=(const Ai&) = delete;
     Ai &operator=(const Ai&&) = delete;
-    ~Ai();
+    virtual ~Ai();
 
     /**
      * @brief Learn what's in memory to get ready for thinking.
@@ -109,6 +111,20 @@ public:
         return aa->dream();
     }
 
+    int getDreamProgress() const {
+        return aa->getDreamProgress();
+    }
+    void interruptDream() {
+        aa->interruptDream();
+    }
+
+    /**
+     * @brief Set listener notified when async dream or associations calculation finishes.
+     */
+    void setTaskListener(std::function<void()> listener) {
+        if(aa) aa->setTaskListener(listener);
+    }
+
     /**
      * @brief Get best Note associations.
      *
@@ -127,6 +143,25 @@ public:
         return aa->getAssociatedNotes(words, associations, self);
     }
 
+    /**
+     * @brief Learn from associated N chosen by user in the leaderboard.
+     *
+     * Accepted (and skipped) associations are used to train AA model.
+     */
+    void acceptAssociation(const Note* note, const Note* accepted, const std::vector<std::pair<Note*,float>>& leaderboard) {
+        if(aa) aa->acceptAssociation(note, accepted, leaderboard);
+    }
+
+    /**
+     * @brief Find clusters of near-duplicate Ns given by copies of their descriptions.
+     *
+     * Can be LONG running on big repositories. No synchronization is needed as Ns
+     * are not accessed.
+     */
+    void findNearDuplicateNotes(const std::vector<std::string>& descriptions, std::vector<std::vector<size_t>>& clusters) {
+        nearDuplicates.findNearDuplicates(descriptions, clusters);
+    }
+
 #ifdef MF_NER
     bool isNerInitialized() const { return ner.isInitialized(); }
 
@@ -136,7 +171,40 @@ public:
     void recognizePersons(const Outline* outline, int entityFilter, std::vector<NerNamedEntity>& result) {
         ner.recognizePersons(outline, entityFilter, result);
     }
+
+    /**
+     * @brief Recognize person names in Os using entity index (Os which are not indexed are recognized in batch).
+     */
+    void recognizePersons(const std::vector<Outline*>& outlines, int entityFilter, std::vector<NerNamedEntity>& result) {
+        ner.recognizePersons(outlines, entityFilter, result);
+    }
+
+    /**
+     * @brief Index named entities of Os in the background.
+     */
+    void recognizeInBackground(const std::vector<Outline*>& outlines) {
+        ner.recognizeInBackground(outlines);
+    }
+#endif
+
+    /**
+     * @brief Keep learned model up to date as Os/Ns are created, modified and deleted.
+     */
+    virtual void onReindex(Outline* outline) {
+        if(aa) aa->remember(outline);
+    }
+    virtual void onForget(Outline* outline) {
+        if(aa) aa->forget(outline);
+#ifdef MF_NER
+        ner.forget(outline);
 #endif
+    }
+    /**
+     * @brief Ns are about to be deleted from O - O is reindexed afterwards.
+     */
+    void onForget(const std::vector<Note*>& notes) {
+        if(aa) aa->forget(notes);
+    }
 
     /**
      * @brief Clear, but don't deallocate.
@@ -156,14 +224,6 @@ public:
         return aa->amnesia();
     }
 
-private:
-
-    /**
-     * @brief Train associations assessment neural network once memory is learned.
-     */
-    void trainAaNn();
-
-public:
 #ifdef DO_MF_DEBUG
     static void print(const Note* n, std::vector<std::pair<Note*,float>>& leaderboard) {
         std::cout << "Note '" << n->getName() << "' AA leaderboard("<< leaderboard.size() <<"):" << std::endl;
@@ -19,9 +19,11 @@
 #ifndef M8R_AI_ASSOCIATIONS_ASSESSMENT_H
 #define M8R_AI_ASSOCIATIONS_ASSESSMENT_H
 
+#include <functional>
 #include <future>
 #include <vector>
 
+#include "../../gear/lang_utils.h"
 #include "../../model/outline.h"
 
 namespace m8r {
@@ -61,7 +63,8 @@ public:
      *                       to provided vector to avoid race conditions in the future).
      *   - future VALID
      *     > true  ... associated Ns can be found in vector
-     *     > false ... associated Ns will NOT be computed - Mind's not thinking, memory empty, ...
+     *     > false ... associated Ns will NOT be computed - Mind's not thinking, memory empty,
+     *                 request cancelled as stale (associations of other N requested), ...
      *
      * Can be LONG running (asynchronous execution handled by AI).
      */
@@ -73,6 +76,48 @@ public:
      */
     virtual std::shared_future<bool> getAssociatedNotes(const std::string& words, std::vector<std::pair<Note*,float>>& associations, const Note* self) = 0;
 
+    /**
+     * @brief O and/or its Ns were created, modified or deleted - update learned model incrementally.
+     *
+     * Implementations which cannot be updated incrementally keep the model until the next dream.
+     */
+    virtual void remember(Outline* outline) { UNUSED_ARG(outline); }
+
+    /**
+     * @brief O was forgotten - remove its Ns from learned model.
+     */
+    virtual void forget(Outline* outline) { UNUSED_ARG(outline); }
+
+    /**
+     * @brief Ns are about to be deleted - they must be removed from learned model before
+     * they're deallocated (O is remembered afterwards).
+     */
+    virtual void forget(const std::vector<Note*>& notes) { UNUSED_ARG(notes); }
+
+    /**
+     * @brief User accepted association from N's leaderboard - implementations may learn from it.
+     */
+    virtual void acceptAssociation(const Note* note, const Note* accepted, const std::vector<std::pair<Note*,float>>& leaderboard) {
+        UNUSED_ARG(note); UNUSED_ARG(accepted); UNUSED_ARG(leaderboard);
+    }
+
+    /**
+     * @brief Set listener notified (in AI thread) once a future which was not ready becomes ready.
+     *
+     * Synchronous implementations return ready futures therefore they never notify.
+     */
+    virtual void setTaskListener(std::function<void()> listener) { UNUSED_ARG(listener); }
+
+    /**
+     * @brief Get dream progress in percent.
+     */
+    virtual int getDreamProgress() const { return 100; }
+
+    /**
+     * @brief Ask dream running in the background to stop - next dream resumes it.
+     */
+    virtual void interruptDream() {}
+
     /**
      * @brief Clear.
      */
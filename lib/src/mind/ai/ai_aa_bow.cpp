@@ -18,119 +18,334 @@
 */
 #include "ai_aa_bow.h"
 
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <cstdio>
+#include <unordered_set>
+#include <deque>
+#include <sys/stat.h>
+
 namespace m8r {
 
 using namespace std;
 
+constexpr uint32_t AiAaBoW::SNAPSHOT_MAGIC;
+constexpr uint32_t AiAaBoW::SNAPSHOT_VERSION;
+constexpr size_t AiAaBoW::AA_SEMANTIC_NEIGHBOURS;
+constexpr size_t AiAaBoW::AA_DREAM_CHUNK_SIZE;
+constexpr size_t AiAaBoW::AA_EXECUTOR_THREADS;
+constexpr int AiAaBoW::AA_TASK_PRIORITY_DREAM;
+constexpr int AiAaBoW::AA_TASK_PRIORITY_LEADERBOARD;
+constexpr size_t AiAaBoW::AA_TRAINING_MIN_ACCEPTED;
+constexpr size_t AiAaBoW::AA_TRAINING_MAX_SAMPLES;
+constexpr size_t AiAaBoW::AA_TRAINING_SET_MAX_BYTES;
+
+// FNV-1a
+static inline uint64_t hashBytes(uint64_t hash, const char* bytes, size_t size)
+{
+    for(size_t i=0; i<size; i++) {
+        hash ^= static_cast<unsigned char>(bytes[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static inline uint64_t hashString(uint64_t hash, const string& s)
+{
+    // terminator ensures that "ab"+"c" and "a"+"bc" differ
+    return hashBytes(hashBytes(hash, s.data(), s.size()), "", 1);
+}
+
+template<typename T> static inline void writeBinary(ostream& out, const T& value)
+{
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+template<typename T> static inline bool readBinary(istream& in, T& value)
+{
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(&value), sizeof(T)));
+}
+
 AiAaBoW::AiAaBoW(Memory& memory, Mind& mind)
     : mind(mind),
       memory(memory),
       lexicon{},
       wordBlacklist{},
-      tokenizer{lexicon,wordBlacklist}
+      tokenizer{lexicon,wordBlacklist},
+      titleLexicon{},
+      titleTokenizer{titleLexicon,wordBlacklist},
+      queryLexicon{},
+      queryTokenizer{queryLexicon,wordBlacklist},
+      dreamed{0},
+      dreamProgress{100},
+      dreamInterrupted{false},
+      dreamChunkListener{},
+      aaStorage{AaStorage::AUTO},
+      aaSparse{false},
+      aaModel{},
+      fingerprints{},
+      snapshotLoaded{false},
+      snapshotDirty{false},
+      snapshotAaModelFingerprint{0},
+      trainingSetSize{0},
+      trainingSetModified{0},
+      aaPool{getAaThreads()},
+      executor{AA_EXECUTOR_THREADS}
 {
 }
 
 AiAaBoW::~AiAaBoW()
 {
-}
-
-void AiAaBoW::addWorkerAndCleanZombies(thread* t)
-{
-    lock_guard<mutex> criticalSection{runningWorkersMutex};
-    MF_DEBUG("AA.BoW: workers+zombies " << runningWorkers.size() << endl);
-
-    // PROBLEM: if zombies is erased > future/promise is deleted as well > frontend that has future calls a method on it > crash
-    // delete dead threads
-    //auto zombieIterator
-    //    = std::remove_if(runningWorkers.begin(),
-    //                     runningWorkers.end(),
-    //                     [](const thread* t) { if(!t->joinable()) { delete t; return true; } else return false; });
-    //runningWorkers.erase(zombieIterator, runningWorkers.end());
+    // running tasks access model > finish them (dream is interrupted) before model is destroyed
+    dreamInterrupted = true;
+    executor.shutdown();
 
-    // add new one
-    runningWorkers.push_back(t);
-
-    MF_DEBUG("AA.BoW: workers " << runningWorkers.size() << endl);
+    // keep AA calculated on demand for the next MindForger run
+    if(notes.size()) {
+        saveSnapshot();
+    }
 }
 
 // it's presumed that caller ensures the correct Mind state & synchronization
 shared_future<bool> AiAaBoW::dream() {
+    dreamInterrupted = false;
     if(memory.getNotesCount() > Configuration::getInstance().getAsyncMindThreshold()) {
         MF_DEBUG("AA.BoW: ASYNC dream..." << endl);
         mind.incActiveProcesses();
 
-        // packaged task is parametrized by function/method signature (not return type)
-        std::packaged_task<bool (AiAaBoW*,thread*)> learnMemoryTask([](AiAaBoW* a,thread* t) { return a->learnMemorySync(t); });
-        future<bool> result = learnMemoryTask.get_future(); // move
-        thread* t = new thread{};
-        *t = thread(std::move(learnMemoryTask), this, t);
-        addWorkerAndCleanZombies(t);
-
-        return shared_future<bool>(std::move(result));
+        return executor.submit(
+            &dreamNotes,
+            AA_TASK_PRIORITY_DREAM,
+            [this]() { return learnMemorySync(); },
+            [this]() {
+                mind.persistMindState(Configuration::MindState::SLEEPING);
+                mind.decActiveProcesses();
+            });
     } else {
         MF_DEBUG("AA.BoW: SYNC dream..." << endl);
+        // learning decrements active processes (both sync and async)
+        mind.incActiveProcesses();
         promise<bool> p{};
         bool status = learnMemorySync();
         p.set_value(status);
 
-        mind.persistMindState(Configuration::MindState::THINKING);
-
         return shared_future<bool>(p.get_future());
     }
 }
 
-bool AiAaBoW::learnMemorySync(thread* t)
+bool AiAaBoW::learnMemorySync()
 {
-    MF_DEBUG("AA.BoW: LEARNING memory to BoW..." << endl);
-    notes.clear();
-    memory.getAllNotes(notes);
-    // let N know it's indexed in AI
-    for(size_t i=0; i<notes.size(); i++) notes[i]->setAiAaMatrixIndex(i);
+    if(dreamed < dreamNotes.size()) {
+        MF_DEBUG("AA.BoW: RESUMING dream at " << dreamed << "/" << dreamNotes.size() << " Ns..." << endl);
+    } else {
+        MF_DEBUG("AA.BoW: LEARNING memory to BoW..." << endl);
+        lock_guard<mutex> criticalSection{modelMutex};
+        startDream();
+    }
 
-    // build lexicon and BoW
-    lexicon.clear();
-    bow.clear();
-    for(Note* n:notes) {
-        NoteCharProvider chars{n};
-        WordFrequencyList* wfl = new WordFrequencyList{&lexicon};
-        tokenizer.tokenize(chars, *wfl);
-        bow.add(n, wfl);
+    // tokenize Ns in chunks - dream can be interrupted between chunks and associations
+    // of already dreamed Ns are provided (word weights are refined w/ every chunk)
+    while(dreamed < dreamNotes.size()) {
+        if(dreamInterrupted) {
+            MF_DEBUG("AA.BoW: dream INTERRUPTED at " << dreamed << "/" << dreamNotes.size() << " Ns" << endl);
+            dreamInterrupted = false;
+            mind.persistMindState(Configuration::MindState::SLEEPING);
+            mind.decActiveProcesses();
+            return false;
+        }
+
+        {
+            lock_guard<mutex> criticalSection{modelMutex};
+            // Os changed during dream are learned incrementally (their Ns might be deleted)
+            dropChangedNotes();
+            applyPendingOutlines();
+
+            // slots of changed Ns might be reused by pending Os (w/ vectors built) > only tokenized Ns are built
+            vector<size_t> chunk{};
+            const size_t toY = std::min(dreamed+AA_DREAM_CHUNK_SIZE, dreamNotes.size());
+            for(size_t y=dreamed; y<toY; y++) {
+                if(dreamNotes[y]) {
+                    notes[y] = dreamNotes[y];
+                    WordFrequencyList* wfl = new WordFrequencyList{&lexicon};
+                    tokenizer.tokenize(notes[y], *wfl);
+                    bow.add(notes[y], wfl);
+                    buildTitleVector(y);
+                    chunk.push_back(y);
+                }
+            }
+            dreamed = toY;
+            dreamProgress = static_cast<int>(dreamed*100/dreamNotes.size());
+
+            // vectors of the last chunk are built w/ final word weights below
+            if(dreamed < dreamNotes.size()) {
+                lexicon.recalculateWeights();
+                wordPostings.resize(lexicon.size());
+                for(size_t y:chunk) {
+                    buildNoteVectors(y);
+                }
+                // leaderboards don't reflect Ns of this chunk
+                if(leaderboardCache.size()) {
+                    leaderboardCache.clear();
+                    if(aaSparse) {
+                        aaTopK.reset(notes.size(), AA_LEADERBOARD_SIZE);
+                    } else {
+                        aaMatrix.reset(notes.size());
+                    }
+                }
+            }
+        }
+        if(dreamChunkListener) {
+            dreamChunkListener(dreamed);
+        }
     }
-    // prepare DATA to quickly create association assessment features
-    lexicon.recalculateWeights();
-    bow.reorderDocVectorsByWeight();
+
+    {
+        lock_guard<mutex> criticalSection{modelMutex};
+        // prepare DATA to quickly create association assessment features
+        lexicon.recalculateWeights();
+        bow.reorderDocVectorsByWeight();
+        for(size_t i=0; i<notes.size(); i++) {
+            if(notes[i]) {
+                wordVectors[i].build(*bow.get(notes[i]), lexicon, AA_WORD_RELEVANCY_THRESHOLD);
+                buildNoteEmbedding(i);
+            }
+        }
+        calculateSemanticNeighbours();
+        buildPostings();
+        // AA model is trained offline i.e. once Ns are dreamed and before AA is calculated
+        trainAaModel();
+        // AA loaded from snapshot was calculated by a different model
+        const bool aaObsolete = snapshotLoaded && snapshotAaModelFingerprint != aaModel.getFingerprint();
+        if((!snapshotLoaded && leaderboardCache.size()) || aaObsolete) {
+            leaderboardCache.clear();
+            if(aaSparse) {
+                aaTopK.reset(notes.size(), AA_LEADERBOARD_SIZE);
+            } else {
+                aaMatrix.reset(notes.size());
+            }
+        }
+        dreamNotes.clear();
+        dreamed = 0;
+        dreamProgress = 100;
 
 #ifdef DO_MF_DEBUG
-    lexicon.print();
-    bow.print();
+        lexicon.print();
+        bow.print();
 #endif
 
-    // AA to be built incrementally - just initialize it
-    if(notes.size() != aaMatrix.size()) {
-        aaMatrix.clear();
-        aaMatrix.resize(notes.size());
-        for(size_t i=0; i<aaMatrix.size(); ++i) {
-            aaMatrix[i].resize(aaMatrix.size(),(float)AiAaBoW::AA_NOT_SET); // C++ :-Z constexpr w/ internal linkage does NOT have to be solved in compile time > workaround via temporary var
-        }
-    } else {
-        for(size_t i=0; i<aaMatrix.size(); ++i) {
-            std::fill(aaMatrix[i].begin(), aaMatrix[i].end(), (float)AiAaBoW::AA_NOT_SET); // C++ :-Z constexpr w/ internal linkage does NOT have to be solved in compile time > workaround via temporary var
+        if(aaObsolete) {
+            snapshotDirty = true;
         }
+        saveSnapshot();
     }
 
-    // NN to be trained on demand - just initialize it
-
     mind.persistMindState(Configuration::MindState::THINKING);
     mind.decActiveProcesses();
-    if(t) t->detach(); // indicate that thread finished
 
     MF_DEBUG("AA.BoW: memory LEARNED!" << endl);
     return true;
 }
 
+void AiAaBoW::startDream()
+{
+    {
+        // Os changed so far are learned by this dream
+        lock_guard<mutex> criticalSection{pendingOutlinesMutex};
+        pendingOutlines.clear();
+    }
+    dreamNotes.clear();
+    memory.getAllNotes(dreamNotes);
+    dreamed = 0;
+    dreamProgress = 0;
+    leaderboardCache.clear();
+
+    noteOutlines.clear();
+    freeSlots.clear();
+    // let N know it's indexed in AI
+    for(size_t i=0; i<dreamNotes.size(); i++) {
+        dreamNotes[i]->setAiAaMatrixIndex(i);
+        noteOutlines.push_back(dreamNotes[i]->getOutline());
+    }
+
+    // AA to be built incrementally - just initialize it
+    aaSparse = aaStorage==AaStorage::TOP_K
+        || (aaStorage==AaStorage::AUTO && dreamNotes.size()>AA_DENSE_MATRIX_MAX_NOTES);
+    if(aaSparse) {
+        aaMatrix.clear();
+        aaTopK.reset(dreamNotes.size(), AA_LEADERBOARD_SIZE);
+        MF_DEBUG("AA.BoW: AA top-K store " << aaTopK.getSize() << "x" << aaTopK.getK() << " allocated w/ " << aaTopK.getBytesize() << "B" << endl);
+    } else {
+        aaTopK.clear();
+        aaMatrix.reset(dreamNotes.size());
+        MF_DEBUG("AA.BoW: AA matrix " << aaMatrix.getSize() << "x" << aaMatrix.getSize() << " allocated w/ " << aaMatrix.getBytesize() << "B" << endl);
+    }
+
+    // build lexicon and BoW (or load them from snapshot)
+    fingerprints.clear();
+    for(Note* n:dreamNotes) {
+        fingerprints.push_back(calculateFingerprint(n));
+    }
+    lexicon.clear();
+    bow.clear();
+    wordVectors.clear();
+    wordVectors.resize(dreamNotes.size());
+    wordPostings.clear();
+    tagPostings.clear();
+    // tokenize titles just once (not for every N pair)
+    titleLexicon.clear();
+    titleVectors.clear();
+    titleVectors.resize(dreamNotes.size());
+    tokenizer.setStemmerLanguage(Stemmer::toLanguage(Configuration::getInstance().getAiStemmerLanguage()));
+    queryTokenizer.setStemmerLanguage(tokenizer.getStemmerLanguage());
+    openEmbeddings();
+    noteEmbeddings.clear();
+    semanticNeighbours.clear();
+    notes = dreamNotes;
+    snapshotLoaded = loadSnapshot();
+    snapshotDirty = !snapshotLoaded;
+    if(snapshotLoaded) {
+        for(size_t i=0; i<notes.size(); i++) {
+            buildTitleVector(i);
+        }
+        dreamed = dreamNotes.size();
+        dreamProgress = 100;
+    } else {
+        // Ns are made available (in Ns vector) as they are dreamed
+        notes.assign(dreamNotes.size(), nullptr);
+    }
+}
+
+void AiAaBoW::dropChangedNotes()
+{
+    unordered_set<const Outline*> changed{};
+    {
+        lock_guard<mutex> criticalSection{pendingOutlinesMutex};
+        for(auto& o:pendingOutlines) {
+            changed.insert(o.first);
+        }
+    }
+    if(changed.empty()) {
+        return;
+    }
+
+    for(size_t y=dreamed; y<dreamNotes.size(); y++) {
+        if(dreamNotes[y] && changed.count(noteOutlines[y])) {
+            dreamNotes[y] = nullptr;
+            noteOutlines[y] = nullptr;
+            freeSlots.push_back(y);
+        }
+    }
+}
+
 // it's presumed that caller ensures the correct Mind state & synchronization
 shared_future<bool> AiAaBoW::getAssociatedNotes(const Note* note, vector<pair<Note*,float>>& associations) {
+    // Os changed since the last request - no calculation may be in progress
+    if(mind.isActiveProcesses()) {
+        updatePendingOutlines();
+    }
+
+    unique_lock<mutex> criticalSection{modelMutex};
     auto cachedLeaderboard = leaderboardCache.find(note);
     if(cachedLeaderboard != leaderboardCache.end()) {
         MF_DEBUG("AA.BoW: SYNC leaderboard calculation for '" << note->getName() << "'" << endl);
@@ -142,382 +357,1710 @@ shared_future<bool> AiAaBoW::getAssociatedNotes(const Note* note, vector<pair<No
         promise<bool> p{};
         p.set_value(true);
         return shared_future<bool>(p.get_future());
-    } else {        
+    } else {
+        // dream running in the background might hold model
+        criticalSection.unlock();
         MF_DEBUG("AA.BoW: ASYNC leaderboard calculation for '" << note->getName() << "'" << endl);
-        if(leaderboardWip.find(note) != leaderboardWip.end()) {
-            // calculation WIP & future OWNER will update what needs to be updated -> intentionally NOT sharing futures
-            promise<bool> p{};
-            p.set_value(false);
-            MF_DEBUG("AA.BoW: leaderboard WIP for '" << note->getName() << "'" << endl);
-            return p.get_future(); // move
-        } else {
-            mind.incActiveProcesses();
-            MF_DEBUG("AA.BoW: starting THREAD for '" << note->getName() << "'" << endl);
 
-            // packaged task is parametrized by function/method signature (not return type)
-            packaged_task<bool (AiAaBoW*,const Note*,thread*)> calculateLeaderboardTask([](AiAaBoW* a, const Note* n, thread* t) { return a->calculateLeaderboardSync(n,t); });
-            future<bool> result = calculateLeaderboardTask.get_future(); // move
-            thread* t = new thread{};
-            *t = thread(std::move(calculateLeaderboardTask), this, note, t); // run task w/ handle to self thread
-            addWorkerAndCleanZombies(t);
+        // the most recent request is for the currently viewed N > requests for other Ns are stale
+        if(executor.cancelQueued(AA_TASK_PRIORITY_LEADERBOARD, note)) {
+            MF_DEBUG("AA.BoW: stale leaderboard calculations cancelled" << endl);
+        }
 
-            return shared_future<bool>(std::move(result));
+        // task is active process until it's finished or cancelled (request for N in progress is shared)
+        bool queued;
+        mind.incActiveProcesses();
+        shared_future<bool> result = executor.submit(
+            note,
+            AA_TASK_PRIORITY_LEADERBOARD,
+            [this,note]() { return calculateLeaderboardSync(note); },
+            [this]() { mind.decActiveProcesses(); },
+            &queued);
+        if(!queued) {
+            MF_DEBUG("AA.BoW: leaderboard calculation for '" << note->getName() << "' already in progress" << endl);
+            mind.decActiveProcesses();
         }
+        return result;
     }
 }
 
-// Pre-calculate/calculate code CANNOT be reused as pre-calculate relies on rows w/ lower index
-// to fill the beginning of the line.
-// This is a private method called from AI ~ AI state/async/critical sections handled by caller.
-void AiAaBoW::calculateAaRow(size_t y)
+shared_future<bool> AiAaBoW::getAssociatedNotes(Outline* outline, vector<pair<Note*,float>>& associations)
 {
-    MF_DEBUG("AA.BoW: Calculating AA row " << y << "..." << endl);
-    // calculate row and column that cross diagonal on [y][y]
-
-    // check diagonal to find out whether the cross has been already calculated
-    if(aaMatrix[y][y] == 1.) {
-        return;
+    // Os changed since the last request - no calculation may be in progress
+    if(mind.isActiveProcesses()) {
+        updatePendingOutlines();
     }
 
-    float aa;
-    AssociationAssessmentNotesFeature aaFeature{};
-
-    notes[y]->setAiAaMatrixIndex(y);
-    for(size_t x=0; x<aaMatrix.size(); x++) {
-        // set diagonal at the end
-        if(x!=y) {
-            // skip if value has been already calculated
-            if(aaMatrix[y][x] == AA_NOT_SET) {
-                Note* n1 = notes[x];
-                Note* n2 = notes[y];
-
-                aaFeature.setHaveMutualRel(false); // TODO
-                aaFeature.setTypeMatches(n1->getType()==n2->getType());
-                aaFeature.setSimilaritySameOutline(n1->getOutline()==n2->getOutline());
-                aaFeature.setSimilarityByTags(calculateSimilarityByTags(n1->getTags(),n2->getTags()));
-                aaFeature.setSimilarityByTitles(calculateSimilarityByTitles(n1->getName(),n2->getName()));
-                aaFeature.setSimilarityByDescription(calculateSimilarityByWords(*bow.get(n1),*bow.get(n2),AA_WORD_RELEVANCY_THRESHOLD));
-                aaFeature.setSimilarityBySameTargetRels(0.0); // TODO nice
-
-                aa = aaFeature.areNotesAssociatedMetric();
+    lock_guard<mutex> criticalSection{modelMutex};
 
-                // set AA ranking both below and above diagonal - detection will be faster later (no check x>y needed)
-                aaMatrix[x][y] = aa;
-                aaMatrix[y][x] = aa;
+    // aggregate relevant words of O's Ns - words relevant in more Ns are more relevant for O
+    WordFrequencyList wfl{&lexicon};
+    string text{outline->getName()};
+    for(const string* line:outline->getDescription()) {
+        if(line) {
+            text += "\n";
+            text += *line;
+        }
+    }
+    tokenizeQuery(text, wfl);
+    vector<uint32_t> ids{};
+    unordered_map<uint32_t,float> relevance{};
+    for(auto& w:wfl.iterable()) {
+        uint32_t id = lexicon.getId(w.first);
+        ids.push_back(id);
+        relevance[id] += lexicon.getWeight(id);
+    }
+    for(Note* n:outline->getNotes()) {
+        if(isLearned(n)) {
+            const WordVector& v = wordVectors[n->getAiAaMatrixIndex()];
+            ids.insert(ids.end(), v.getIds().begin(), v.getIds().end());
+            for(size_t i=0; i<v.getRelevantSize(); i++) {
+                relevance[v.getRelevantIds()[i]] += v.getRelevantWeights()[i];
             }
         }
     }
+    vector<pair<uint32_t,float>> relevant(relevance.begin(), relevance.end());
+    std::sort(
+        relevant.begin(),
+        relevant.end(),
+        [](const pair<uint32_t,float>& r1, const pair<uint32_t,float>& r2) {
+            return r1.second > r2.second || (r1.second == r2.second && r1.first < r2.first);
+        });
+    if(relevant.size() > AA_WORD_RELEVANCY_THRESHOLD) {
+        relevant.resize(AA_WORD_RELEVANCY_THRESHOLD);
+    }
+    for(auto& r:relevant) {
+        r.second = lexicon.getWeight(r.first);
+    }
+    WordVector query{};
+    query.build(ids, relevant);
 
-    // set diagonal at the end to indicate calculation is done (consider reentrancy)
-    aaMatrix[y][y] = 1.;
+    vector<uint32_t> titleVector{};
+    tokenizeQueryTitle(outline->getName(), titleVector);
 
-#ifdef DO_MF_DEBUG
-    MF_DEBUG("AA.BoW: AA row calculated!" << endl);
-    //printAa();
-    //assertAaSymmetry();
-#endif
+    calculateQueryLeaderboard(query, titleVector, outline->getTags(), outline, nullptr, associations);
+
+    promise<bool> p{};
+    p.set_value(true);
+    return shared_future<bool>(p.get_future());
 }
 
-// This is a private method called from AI ~ AI state/async/critical sections handled by caller.
-void AiAaBoW::precalculateAa()
+shared_future<bool> AiAaBoW::getAssociatedNotes(const string& words, vector<pair<Note*,float>>& associations, const Note* self)
 {
-#ifdef DO_MF_DEBUG
-    static const float UNIQUE_AA_CELLS = (float)(notes.size()*notes.size()/2.+notes.size()/2.);
-    MF_DEBUG("  Building AA matrix w/ " << UNIQUE_AA_CELLS << " UNIQUE rankings..." << endl);
-    float c=0;
-    float p;
-#endif
-
-    // calculate FULL matrix of Ns associativity assessment for every N1 and N2 tuple
-    float aa;
-    AssociationAssessmentNotesFeature aaFeature{};
-    for(size_t y=0; y<aaMatrix.size(); y++) {
-        notes[y]->setAiAaMatrixIndex(y); // sets index for ALL notes in notes vector
+    // Os changed since the last request - no calculation may be in progress
+    if(mind.isActiveProcesses()) {
+        updatePendingOutlines();
+    }
 
-#ifdef DO_MF_DEBUG
-        p = c/(UNIQUE_AA_CELLS/100.);
-        MF_DEBUG("    " << (int)p << "% AA matrix rankings for '" << notes[y]->getName() << "'" << endl);
-#endif
+    lock_guard<mutex> criticalSection{modelMutex};
 
-        // calculate only values ABOVE diagonal i.e. initialize x=y
-        for(size_t x=y; x<aaMatrix.size(); x++) {
-#ifdef DO_MF_DEBUG
-            c++;
-#endif
+    WordFrequencyList wfl{&lexicon};
+    tokenizeQuery(words, wfl);
+    wfl.sort();
+    WordVector query{};
+    query.build(wfl, lexicon, AA_WORD_RELEVANCY_THRESHOLD);
 
-            if(x==y) {
-                aaMatrix[x][y] = 1.;
-            } else {
-                Note* n1 = notes[x];
-                Note* n2 = notes[y];
+    vector<uint32_t> titleVector{};
+    tokenizeQueryTitle(words, titleVector);
 
-                aaFeature.setHaveMutualRel(false); // TODO
-                aaFeature.setTypeMatches(n1->getType()==n2->getType());
-                aaFeature.setSimilaritySameOutline(n1->getOutline()==n2->getOutline());
-                aaFeature.setSimilarityByTags(calculateSimilarityByTags(n1->getTags(),n2->getTags()));
-                aaFeature.setSimilarityByTitles(calculateSimilarityByTitles(n1->getName(),n2->getName()));
-                aaFeature.setSimilarityByDescription(calculateSimilarityByWords(*bow.get(n1),*bow.get(n2),AA_WORD_RELEVANCY_THRESHOLD));
-                aaFeature.setSimilarityBySameTargetRels(0.0); // TODO nice
+    calculateQueryLeaderboard(query, titleVector, nullptr, nullptr, self, associations);
 
-                aa = aaFeature.areNotesAssociatedMetric();
+    promise<bool> p{};
+    p.set_value(true);
+    return shared_future<bool>(p.get_future());
+}
 
-                // set AA ranking both below and above diagonal - detection will be faster later (no check x>y needed)
-                aaMatrix[x][y] = aa;
-                aaMatrix[y][x] = aa;
-            }
+void AiAaBoW::tokenizeQuery(const string& text, WordFrequencyList& wfl)
+{
+    WordFrequencyList tokens{&queryLexicon};
+    queryTokenizer.tokenize(text.data(), text.data()+text.size(), tokens);
+    for(auto& t:tokens.iterable()) {
+        uint32_t id = lexicon.getId(t.first);
+        if(id != Lexicon::NO_WORD) {
+            wfl[&lexicon.getWord(id)] += t.second;
         }
     }
-
-#ifdef DO_MF_DEBUG
-    MF_DEBUG("  AA matrix built!" << endl);
-    //printAa();
-    assertAaSymmetry();
-#endif
+    queryLexicon.clear();
 }
 
-float AiAaBoW::calculateSimilarityByTitles(const string& t1, const string& t2)
+void AiAaBoW::tokenizeQueryTitle(const string& title, vector<uint32_t>& titleVector)
 {
-    StringCharProvider cp1{t1};
-    WordFrequencyList v1{&lexicon};
-    tokenizer.tokenize(cp1, v1, false, true, false);
-    StringCharProvider cp2{t2};
-    WordFrequencyList v2{&lexicon};
-    tokenizer.tokenize(cp2, v2, false, true, false);
-
-    // calculate overlap
-    if(!v1.size() || !v2.size()) {
-        return 0.;
-    } else {
-        // direct access for efficiency
-        WordFrequencyList intersection{&lexicon};
-        float iWeight=0, uWeight=0;
-
-        for(auto& e:v1.iterable()) {
-            uWeight += 1;
-            if(v2.contains(e.first)) {
-                iWeight += 1;
-                intersection.add(e.first);
-            }
-        }
-
-        for(auto& e:v2.iterable()) {
-            if(!intersection.contains(e.first)) {
-                uWeight += 1;
-                if(v1.contains(e.first)) {
-                    iWeight += 1;
-                    // no need to update iVector as it won't be needed
-                }
-            }
+    // tokenized like Ns' titles
+    WordFrequencyList tokens{&queryLexicon};
+    queryTokenizer.tokenize(title.data(), title.data()+title.size(), tokens, false, true, false);
+    for(auto& t:tokens.iterable()) {
+        uint32_t id = titleLexicon.getId(t.first);
+        if(id != Lexicon::NO_WORD) {
+            titleVector.push_back(id);
         }
-
-        //MF_DEBUG("  titleSimilarity = "<<iWeight<<" / "<<uWeight << endl);
-        // intersection % of union
-        return (iWeight/(uWeight/100.))/100;
     }
+    std::sort(titleVector.begin(), titleVector.end());
+    queryLexicon.clear();
 }
 
-// algorithm is based on similarity by words (for now there are no weights - might be added later if needed by other lib functions)
-float AiAaBoW::calculateSimilarityByTags(const vector<const Tag*>* t1, const vector<const Tag*>* t2)
+void AiAaBoW::calculateQueryLeaderboard(
+        const WordVector& query,
+        const vector<uint32_t>& titleVector,
+        const vector<const Tag*>* tags,
+        const Outline* outline,
+        const Note* self,
+        vector<pair<Note*,float>>& leaderboard)
 {
-    if(!t1->size()) {
-        if(!t2->size()) {
-            return 1.;
-        } else {
-            return 0.;
+    // Ns which share a relevant word/tag w/ query
+    vector<uint32_t> candidates{};
+    for(uint32_t id:query.getRelevantIds()) {
+        if(id < wordPostings.size()) {
+            const vector<uint32_t>& p = wordPostings[id];
+            candidates.insert(candidates.end(), p.begin(), p.end());
         }
-    } else {
-        // direct access for efficiency
-        vector<const Tag*> intersection{};
-        float iWeight=0, uWeight=0;
-
-        // iterate at most *threashold* words from v1: all + to UNION, matching + to INTERSECTION
-        for(auto& t:*t1) {
-            uWeight += 1;
-            if(std::find(t2->begin(),t2->end(),t) != t2->end()) {
-                iWeight += 1;
-                intersection.push_back(t);
+    }
+    if(tags) {
+        for(const Tag* tag:*tags) {
+            auto p = tagPostings.find(tag);
+            if(p != tagPostings.end()) {
+                candidates.insert(candidates.end(), p->second.begin(), p->second.end());
             }
         }
-        // uWeight contains weight of v1's tags, iWeight weight of v1 intersection v2
-
-        // iterate tags from v2: w in intersection HANDLED both u&i, w in v2&v1 > intersection else union
-        for(auto& t:*t2) {
-            if(std::find(intersection.begin(),intersection.end(),t) == intersection.end()) {
-                uWeight += 1;
-                if(std::find(t1->begin(),t1->end(),t) != t1->end()) {
-                    iWeight += 1;
-                    // no need to update iVector as it won't be needed
-                }
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    vector<AaTopK::Entry> heap(AA_LEADERBOARD_SIZE);
+    std::uint16_t count = 0;
+    auto offer = [&](size_t x) {
+        if(notes[x] && notes[x]!=self && (!outline || noteOutlines[x]!=outline)) {
+            float aa = calculateQueryAa(query, titleVector, tags, x);
+            // Ns w/o anything in common w/ query are not associated
+            if(aa > 0.) {
+                AaTopK::offer(heap.data(), count, AA_LEADERBOARD_SIZE, x, aa);
             }
         }
-
-        //MF_DEBUG("  tagSimilarity = "<<iWeight<<" / "<<uWeight << endl);
-        // intersection % of union
-        return (iWeight/(uWeight/100.))/100;
+    };
+    if(candidates.size() >= AA_CANDIDATES_MIN) {
+        for(uint32_t x:candidates) {
+            offer(x);
+        }
+    } else {
+        for(size_t x=0; x<notes.size(); x++) {
+            offer(x);
+        }
+    }
+    MF_DEBUG("AA.BoW: query assessed w/ " << candidates.size() << " candidates of " << notes.size() << " Ns" << endl);
+
+    vector<AaTopK::Entry> entries(heap.begin(), heap.begin()+count);
+    std::sort(
+        entries.begin(),
+        entries.end(),
+        [](const AaTopK::Entry& e1, const AaTopK::Entry& e2) {
+            return e1.second > e2.second || (e1.second == e2.second && e1.first < e2.first);
+        });
+    for(AaTopK::Entry& e:entries) {
+        leaderboard.push_back(std::make_pair(notes[e.first],e.second));
     }
 }
 
-// consider ONLY most valuable words via threshold - many irrelevat words would kill the score (irrelevant words make noise)
-float AiAaBoW::calculateSimilarityByWords(WordFrequencyList& v1, WordFrequencyList& v2, int threshold)
+float AiAaBoW::calculateQueryAa(const WordVector& query, const vector<uint32_t>& titleVector, const vector<const Tag*>* tags, size_t x)
 {
-    if(!v1.size() || !v2.size()) {
-        return 0.;
-    } else {
-        // direct access for efficiency
-        WordFrequencyList intersection{&lexicon};
-        float iWeight=0, uWeight=0;
-        int t=0;
+    AssociationAssessmentNotesFeature aaFeature{};
 
-        // iterate at most *threashold* words from v1: all + to UNION, matching + to INTERSECTION
-        for(auto& e:v1.iterable()) {
-            if(t++>=threshold) break;
+    aaFeature.setHaveMutualRel(false);
+    aaFeature.setTypeMatches(false);
+    aaFeature.setSimilaritySameOutline(false);
+    aaFeature.setSimilarityByTags(tags && tags->size()?calculateSimilarityByTags(tags,notes[x]->getTags()):0.);
+    aaFeature.setSimilarityByTitles(calculateSimilarityByTitles(titleVector,titleVectors[x]));
+    aaFeature.setSimilarityByDescription(WordVector::similarity(query,wordVectors[x]));
+    aaFeature.setSimilarityBySameTargetRels(0.0);
 
-            float w = lexicon.get(e.first)->weight;
-            uWeight += w;
-            if(v2.contains(e.first)) {
-                iWeight += w;
-                intersection.add(e.first);
-            }
-        }
-        // uWeight contains weight of 1st 10 v1's words, iWeight weight of v1 intersection v2
+    return aaFeature.areNotesAssociatedMetric();
+}
 
-        // iterate at most *threashold* words from v2: w in intersection HANDLED both u&i, w in v2&v1 > intersection else union
-        t=0;
-        for(auto& e:v2.iterable()) {
-            // consider at most threashold words from v2
-            if(++t>=threshold) break;
+size_t AiAaBoW::getAaThreads() const
+{
+    size_t threads = Configuration::getInstance().getAiThreads();
+    return threads?threads:WorkStealingPool::getCpuCoresCount();
+}
 
-            if(!intersection.contains(e.first)) {
-                float w = lexicon.get(e.first)->weight;
-                uWeight += w;
-                if(v1.contains(e.first)) {
-                    iWeight += w;
-                    // no need to update iVector as it won't be needed
-                }
-            }
+void AiAaBoW::buildPostings()
+{
+    // word IDs are dense
+    wordPostings.clear();
+    wordPostings.resize(lexicon.size());
+    tagPostings.clear();
+    for(size_t i=0; i<notes.size(); i++) {
+        if(notes[i]) {
+            addPostings(i);
         }
-
-        // intersection % of union
-        float result = (iWeight/(uWeight/100.))/100;
-        //MF_DEBUG("  wordSimilarity = "<<iWeight<<" / "<<uWeight <<" (t="<<t<<") -> " << result << endl);
-        return result;
     }
+    MF_DEBUG("AA.BoW: postings of " << wordPostings.size() << " words and " << tagPostings.size() << " tags built" << endl);
 }
 
-bool AiAaBoW::calculateLeaderboardSync(const Note* n, thread* t)
+void AiAaBoW::addPostings(size_t y)
 {
-    MF_DEBUG("AA.BoW: SYNC leaderboard calculation for '" << n->getName() << "' in thread " << t << endl);
+    for(uint32_t id:wordVectors[y].getRelevantIds()) {
+        wordPostings[id].push_back(y);
+    }
+    for(const Tag* tag:*notes[y]->getTags()) {
+        tagPostings[tag].push_back(y);
+    }
+}
 
-    // If N was REMOVED, then nobody will ask for leaderboard.
-    // If N was MODIFIED, then leaderboard will not be accurate (but it's not critical).
-    // If N was ADDED, then I don't have data - no leaderboard provided.
-    if(n->getAiAaMatrixIndex() != AA_NOT_SET) {
-        // check cache
-        auto cachedLeaderboard = leaderboardCache.find(n);
-        if(cachedLeaderboard != leaderboardCache.end()) {
-            return true;
-        }
+void AiAaBoW::buildTitleVector(size_t y)
+{
+    const string& name = notes[y]->getName();
+    WordFrequencyList wfl{&titleLexicon};
+    titleTokenizer.tokenize(name.data(), name.data()+name.size(), wfl, false, true, false);
+    titleVectors[y].clear();
+    for(auto& e:wfl.iterable()) {
+        titleVectors[y].push_back(titleLexicon.getId(e.first));
+    }
+    std::sort(titleVectors[y].begin(), titleVectors[y].end());
+}
 
-        // calculate row/column of AA matrix & build leaderboard
-        calculateAaRow(n->getAiAaMatrixIndex());
+bool AiAaBoW::getAaCandidates(size_t y, vector<uint32_t>& candidates)
+{
+    Note* n = notes[y];
 
-        int aaLeaderboard[AA_LEADERBOARD_SIZE][2];
-        for(int i=0; i<AA_LEADERBOARD_SIZE; i++) {
-            aaLeaderboard[i][0] = aaLeaderboard[i][1] = AA_NOT_SET;
+    for(uint32_t id:wordVectors[y].getRelevantIds()) {
+        const vector<uint32_t>& p = wordPostings[id];
+        candidates.insert(candidates.end(), p.begin(), p.end());
+    }
+    for(const Tag* tag:*n->getTags()) {
+        auto p = tagPostings.find(tag);
+        if(p != tagPostings.end()) {
+            candidates.insert(candidates.end(), p->second.begin(), p->second.end());
         }
-
-        float aa;
-        for(size_t x=0, y=n->getAiAaMatrixIndex(); x<notes.size(); x++) {
-            if(x==y) continue; // self on diagonal
-
-            aa = aaMatrix[x][y];
-
-            if(aa > aaLeaderboard[AA_LEADERBOARD_SIZE-1][0]) { // covers also lb[][]==NOT_SET (== -1)
-                // find target leaderboard row
-                size_t target;
-                for(target=0; target<AA_LEADERBOARD_SIZE; target++) {
-                    if(aaLeaderboard[target][0] == AA_NOT_SET) {
-                        break; // fill empty row -> no shift needed
-                    } else {
-                        if(aa > aaMatrix[aaLeaderboard[target][0]][aaLeaderboard[target][1]]) {
-                            break;
-                        }
-                    }
-                }
-
-                /// empty row > no shift needed
-                if(aaLeaderboard[target][0] != AA_NOT_SET) {
-                    // shift leaderboard
-                    int sx = aaLeaderboard[target][0];
-                    int sy = aaLeaderboard[target][1];
-                    for(size_t ll=target; ll<AA_LEADERBOARD_SIZE; ll++) {
-                        if(aaLeaderboard[ll][0]!=AA_NOT_SET) {
-                            int tx=aaLeaderboard[ll][0];
-                            int ty=aaLeaderboard[ll][1];
-                            aaLeaderboard[ll][0]=sx;
-                            aaLeaderboard[ll][1]=sy;
-                            sx=tx;
-                            sy=ty;
-                        } else {
-                            aaLeaderboard[ll][0]=sx;
-                            aaLeaderboard[ll][1]=sy;
-                            break;
-                        }
-                    }
-                }
-
-                // assign value
-                aaLeaderboard[target][0]=x;
-                aaLeaderboard[target][1]=y;
-            }
+    }
+    // Ns from the same O (if indexed i.e. not created after dream)
+    for(Note* o:n->getOutline()->getNotes()) {
+        if(isLearned(o)) {
+            candidates.push_back(o->getAiAaMatrixIndex());
         }
-
-        MF_DEBUG("Leaderboard of " << n->getName() << " (" << n->getOutline()->getName() << "):" << endl);
-        vector<pair<Note*,float>> leaderboard{};
-        for(int i=0; i<AA_LEADERBOARD_SIZE && aaLeaderboard[i][0]!=AA_NOT_SET; i++) {
-            MF_DEBUG("  #" << i << " " <<
-                     notes[aaLeaderboard[i][0]]->getName() << " (" << notes[aaLeaderboard[i][0]]->getOutline()->getName() << ")" <<
-                     " ~ " << aaMatrix[aaLeaderboard[i][0]][aaLeaderboard[i][1]] << endl);
-            leaderboard.push_back(std::make_pair(notes[aaLeaderboard[i][0]],aaMatrix[aaLeaderboard[i][0]][aaLeaderboard[i][1]]));
+    }
+    // Ns w/ the most similar meaning (they may share no word) - calculated by dream
+    if(y < semanticNeighbours.size()) {
+        for(uint32_t x:semanticNeighbours[y]) {
+            if(notes[x]) {
+                candidates.push_back(x);
+            }
         }
-
-        // cache leaderboard (copied)
-        leaderboardCache[n] = leaderboard;
     }
 
-    leaderboardWip.erase(n);
-    mind.decActiveProcesses();
-    if(t) t->detach(); // indicate that thread finished
-    return true;
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+    candidates.erase(std::remove(candidates.begin(), candidates.end(), y), candidates.end());
+
+    MF_DEBUG("AA.BoW: " << candidates.size() << " AA candidates of " << notes.size() << " Ns for '" << n->getName() << "'" << endl);
+    return candidates.size() >= AA_CANDIDATES_MIN;
 }
 
-void AiAaBoW::assertAaSymmetry()
+void AiAaBoW::calculateAaFeature(size_t x, size_t y, AssociationAssessmentNotesFeature& aaFeature)
 {
-    MF_DEBUG("AI: checking AA symmetry..." << endl);
-    for(size_t i=0; i<aaMatrix.size(); ++i) {
-        for(size_t j=0; i<aaMatrix.size(); ++i) {
-            if(aaMatrix[i][j] != aaMatrix[j][i]) {
-                MF_DEBUG("  Symmetry ERROR: aa["<<i<<"]["<<j<<"]" << endl);
-            }
-        }
+    Note* n1 = notes[x];
+    Note* n2 = notes[y];
+
+    aaFeature.setHaveMutualRel(false); // TODO
+    aaFeature.setTypeMatches(n1->getType()==n2->getType());
+    aaFeature.setSimilaritySameOutline(n1->getOutline()==n2->getOutline());
+    aaFeature.setSimilarityByTags(calculateSimilarityByTags(n1->getTags(),n2->getTags()));
+    aaFeature.setSimilarityByTitles(calculateSimilarityByTitles(titleVectors[x],titleVectors[y]));
+    float similarity = WordVector::similarity(wordVectors[x],wordVectors[y]);
+    if(hasNoteEmbedding(x) && hasNoteEmbedding(y)) {
+        // synonyms make Ns similar even if they don't share words
+        similarity = std::max(similarity, calculateSimilarityByEmbeddings(x, y));
     }
-    MF_DEBUG("AI: AA symmetry checked!" << endl);
+    aaFeature.setSimilarityByDescription(similarity);
+    aaFeature.setSimilarityBySameTargetRels(0.0); // TODO nice
 }
 
-// it's presumed that caller ensures the correct Mind state & synchronization
-bool AiAaBoW::sleep() {
-    lexicon.clear();
-    notes.clear();
-    outlines.clear();
-    bow.clear();
+float AiAaBoW::calculateAa(size_t x, size_t y)
+{
+    AssociationAssessmentNotesFeature aaFeature{};
+    calculateAaFeature(x, y, aaFeature);
+    return aaModel.assess(aaFeature);
+}
 
-    return true;
+void AiAaBoW::calculateAa(size_t y, const uint32_t* xs, size_t count, float* aa)
+{
+    AssociationAssessmentNotesFeature aaFeature{};
+    AssociationAssessmentFeatureBatch batch{};
+    for(size_t from=0; from<count; from+=batch.getCapacity()) {
+        const size_t to = std::min(from+batch.getCapacity(), count);
+        batch.clear();
+        for(size_t i=from; i<to; i++) {
+            calculateAaFeature(xs[i], y, aaFeature);
+            batch.add(aaFeature);
+        }
+        aaModel.assess(batch, aa+from);
+    }
 }
 
-// it's presumed that caller ensures the correct Mind state & synchronization
+// Pre-calculate/calculate code CANNOT be reused as pre-calculate relies on rows w/ lower index
+// to fill the beginning of the line.
+// This is a private method called from AI ~ AI state/async/critical sections handled by caller.
+void AiAaBoW::calculateAaRow(size_t y)
+{
+    MF_DEBUG("AA.BoW: Calculating AA row " << y << "..." << endl);
+    // calculate row and column that cross diagonal on [y][y]
+
+    // check diagonal to find out whether the cross has been already calculated
+    if(aaMatrix.isRowCalculated(y)) {
+        return;
+    }
+
+    notes[y]->setAiAaMatrixIndex(y);
+    if(aaMatrix.getSize() < AA_PARALLEL_ROW_THRESHOLD) {
+        calculateAaRow(y, 0, aaMatrix.getSize());
+    } else {
+        // column blocks write disjoint cells [y][x] and [x][y]
+        size_t blockSize = aaMatrix.getSize()/(aaPool.getSize()*AA_BLOCKS_PER_THREAD)+1;
+        vector<WorkStealingPool::Task> tasks{};
+        for(size_t x=0; x<aaMatrix.getSize(); x+=blockSize) {
+            size_t toX = std::min(x+blockSize, aaMatrix.getSize());
+            tasks.push_back([this,y,x,toX]() {
+                calculateAaRow(y, x, toX);
+            });
+        }
+        aaPool.run(tasks);
+    }
+
+    // set diagonal at the end to indicate calculation is done (consider reentrancy)
+    aaMatrix.setRowCalculated(y);
+    snapshotDirty = true;
+
+#ifdef DO_MF_DEBUG
+    MF_DEBUG("AA.BoW: AA row calculated!" << endl);
+    //printAa();
+#endif
+}
+
+void AiAaBoW::calculateAaRow(size_t y, size_t fromX, size_t toX)
+{
+    vector<uint32_t> xs{};
+    for(size_t x=fromX; x<toX; x++) {
+        // set diagonal at the end, skip deleted Ns and values which have been already calculated
+        if(x!=y && notes[x] && !aaMatrix.isSet(x,y)) {
+            xs.push_back(x);
+        }
+    }
+    vector<float> aa(xs.size());
+    calculateAa(y, xs.data(), xs.size(), aa.data());
+    for(size_t i=0; i<xs.size(); i++) {
+        // single cell represents both [x][y] and [y][x] rankings
+        aaMatrix.set(xs[i], y, aa[i]);
+    }
+}
+
+// This is a private method called from AI ~ AI state/async/critical sections handled by caller.
+void AiAaBoW::calculateAaTopKRow(size_t y)
+{
+    MF_DEBUG("AA.BoW: Calculating sparse AA row " << y << "..." << endl);
+    if(aaTopK.isRowCalculated(y)) {
+        return;
+    }
+
+    notes[y]->setAiAaMatrixIndex(y);
+    const size_t size = aaTopK.getSize();
+    vector<uint32_t> candidates{};
+    if(getAaCandidates(y, candidates)) {
+        vector<float> aa(candidates.size());
+        calculateAa(y, candidates.data(), candidates.size(), aa.data());
+        for(size_t i=0; i<candidates.size(); i++) {
+            aaTopK.offer(y, candidates[i], aa[i]);
+        }
+    } else if(size < AA_PARALLEL_ROW_THRESHOLD) {
+        vector<AaTopK::Entry> heap(aaTopK.getK());
+        std::uint16_t count = 0;
+        calculateAaTopKRow(y, 0, size, heap.data(), count);
+        for(std::uint16_t i=0; i<count; i++) {
+            aaTopK.offer(y, heap[i].first, heap[i].second);
+        }
+    } else {
+        // column blocks fill their own heaps which are merged to the row
+        const size_t blockSize = size/(aaPool.getSize()*AA_BLOCKS_PER_THREAD)+1;
+        const size_t blocks = (size+blockSize-1)/blockSize;
+        vector<vector<AaTopK::Entry>> heaps(blocks, vector<AaTopK::Entry>(aaTopK.getK()));
+        vector<std::uint16_t> counts(blocks, 0);
+        vector<WorkStealingPool::Task> tasks{};
+        for(size_t b=0; b<blocks; b++) {
+            tasks.push_back([this,y,b,blockSize,size,&heaps,&counts]() {
+                calculateAaTopKRow(y, b*blockSize, std::min((b+1)*blockSize, size), heaps[b].data(), counts[b]);
+            });
+        }
+        aaPool.run(tasks);
+        for(size_t b=0; b<blocks; b++) {
+            for(std::uint16_t i=0; i<counts[b]; i++) {
+                aaTopK.offer(y, heaps[b][i].first, heaps[b][i].second);
+            }
+        }
+    }
+
+    aaTopK.setRowCalculated(y);
+    snapshotDirty = true;
+}
+
+void AiAaBoW::calculateAaTopKRow(size_t y, size_t fromX, size_t toX, AaTopK::Entry* heap, std::uint16_t& count)
+{
+    const size_t k = aaTopK.getK();
+    // Ns are assessed in batches
+    uint32_t xs[AssociationAssessmentFeatureBatch::DEFAULT_CAPACITY];
+    float aa[AssociationAssessmentFeatureBatch::DEFAULT_CAPACITY];
+    size_t size = 0;
+    for(size_t x=fromX; x<toX; x++) {
+        // self on diagonal, skip deleted Ns
+        if(x!=y && notes[x]) {
+            xs[size++] = x;
+        }
+        if(size == AssociationAssessmentFeatureBatch::DEFAULT_CAPACITY || (x+1 == toX && size)) {
+            calculateAa(y, xs, size, aa);
+            for(size_t i=0; i<size; i++) {
+                AaTopK::offer(heap, count, k, xs[i], aa[i]);
+            }
+            size = 0;
+        }
+    }
+}
+
+// This method is called from AI ~ AI state/async/critical sections handled by caller.
+void AiAaBoW::precalculateAa(size_t threads)
+{
+    // explicit number of threads (e.g. benchmark) > dedicated pool
+    unique_ptr<WorkStealingPool> dedicatedPool{};
+    if(threads && threads!=aaPool.getSize()) {
+        dedicatedPool.reset(new WorkStealingPool{threads});
+    }
+    WorkStealingPool& pool = dedicatedPool?*dedicatedPool:aaPool;
+
+    if(aaSparse) {
+        const size_t size = aaTopK.getSize();
+        MF_DEBUG("  Building sparse AA w/ " << size << " rows using " << pool.getSize() << " threads..." << endl);
+
+        // rows have the same cost, therefore blocks w/ the same number of rows are good enough
+        const size_t blockSize = size/(pool.getSize()*AA_BLOCKS_PER_THREAD)+1;
+        vector<WorkStealingPool::Task> tasks{};
+        for(size_t fromY=0; fromY<size; fromY+=blockSize) {
+            size_t toY = std::min(fromY+blockSize, size);
+            tasks.push_back([this,fromY,toY,size]() {
+                vector<AaTopK::Entry> heap(aaTopK.getK());
+                for(size_t y=fromY; y<toY; y++) {
+                    if(notes[y] && !aaTopK.isRowCalculated(y)) {
+                        notes[y]->setAiAaMatrixIndex(y);
+                        std::uint16_t count = 0;
+                        calculateAaTopKRow(y, 0, size, heap.data(), count);
+                        for(std::uint16_t i=0; i<count; i++) {
+                            aaTopK.offer(y, heap[i].first, heap[i].second);
+                        }
+                        aaTopK.setRowCalculated(y);
+                    }
+                }
+            });
+        }
+        pool.run(tasks);
+        snapshotDirty = true;
+
+        MF_DEBUG("  Sparse AA built!" << endl);
+        return;
+    }
+
+    const size_t size = aaMatrix.getSize();
+
+#ifdef DO_MF_DEBUG
+    const float UNIQUE_AA_CELLS = (float)(size*size/2.+size/2.);
+    MF_DEBUG("  Building AA matrix w/ " << UNIQUE_AA_CELLS << " UNIQUE rankings using " << pool.getSize() << " threads..." << endl);
+    auto begin = chrono::high_resolution_clock::now();
+#endif
+
+    // split triangular matrix to column blocks w/ (roughly) the same number of cells:
+    // column y has y+1 cells above (and including) the diagonal
+    const size_t cells = size*(size+1)/2;
+    const size_t blockCells = cells/(pool.getSize()*AA_BLOCKS_PER_THREAD)+1;
+    vector<WorkStealingPool::Task> tasks{};
+    for(size_t fromY=0, toY, c; fromY<size; fromY=toY) {
+        for(toY=fromY, c=0; toY<size && c<blockCells; toY++) {
+            c += toY+1;
+        }
+        tasks.push_back([this,fromY,toY]() {
+            vector<uint32_t> xs{};
+            vector<float> aa{};
+            for(size_t y=fromY; y<toY; y++) {
+                // skip deleted Ns
+                if(!notes[y]) continue;
+                notes[y]->setAiAaMatrixIndex(y); // sets index for ALL notes in notes vector
+
+                // calculate only values ABOVE diagonal i.e. x<y:
+                // block owns packed columns fromY..toY, therefore blocks write disjoint cells
+                xs.clear();
+                for(size_t x=0; x<y; x++) {
+                    if(notes[x]) {
+                        xs.push_back(x);
+                    }
+                }
+                aa.resize(xs.size());
+                calculateAa(y, xs.data(), xs.size(), aa.data());
+                for(size_t i=0; i<xs.size(); i++) {
+                    aaMatrix.set(xs[i], y, aa[i]);
+                }
+                aaMatrix.setRowCalculated(y);
+            }
+        });
+    }
+    pool.run(tasks);
+    snapshotDirty = true;
+
+#ifdef DO_MF_DEBUG
+    auto end = chrono::high_resolution_clock::now();
+    MF_DEBUG("  AA matrix built in " << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0 << "ms (" << tasks.size() << " blocks)" << endl);
+    //printAa();
+#endif
+}
+
+float AiAaBoW::calculateSimilarityByTitles(const vector<uint32_t>& t1, const vector<uint32_t>& t2)
+{
+    if(!t1.size() || !t2.size()) {
+        return 0.;
+    }
+
+    // merge sorted token IDs: intersection % of union
+    size_t i1=0, i2=0, intersection=0;
+    while(i1<t1.size() && i2<t2.size()) {
+        if(t1[i1] < t2[i2]) {
+            i1++;
+        } else if(t2[i2] < t1[i1]) {
+            i2++;
+        } else {
+            intersection++;
+            i1++;
+            i2++;
+        }
+    }
+    return ((float)intersection)/(t1.size()+t2.size()-intersection);
+}
+
+// algorithm is based on similarity by words (for now there are no weights - might be added later if needed by other lib functions)
+float AiAaBoW::calculateSimilarityByTags(const vector<const Tag*>* t1, const vector<const Tag*>* t2)
+{
+    if(!t1->size()) {
+        if(!t2->size()) {
+            return 1.;
+        } else {
+            return 0.;
+        }
+    } else {
+        // direct access for efficiency
+        vector<const Tag*> intersection{};
+        float iWeight=0, uWeight=0;
+
+        // iterate at most *threashold* words from v1: all + to UNION, matching + to INTERSECTION
+        for(auto& t:*t1) {
+            uWeight += 1;
+            if(std::find(t2->begin(),t2->end(),t) != t2->end()) {
+                iWeight += 1;
+                intersection.push_back(t);
+            }
+        }
+        // uWeight contains weight of v1's tags, iWeight weight of v1 intersection v2
+
+        // iterate tags from v2: w in intersection HANDLED both u&i, w in v2&v1 > intersection else union
+        for(auto& t:*t2) {
+            if(std::find(intersection.begin(),intersection.end(),t) == intersection.end()) {
+                uWeight += 1;
+                if(std::find(t1->begin(),t1->end(),t) != t1->end()) {
+                    iWeight += 1;
+                    // no need to update iVector as it won't be needed
+                }
+            }
+        }
+
+        //MF_DEBUG("  tagSimilarity = "<<iWeight<<" / "<<uWeight << endl);
+        // intersection % of union
+        return (iWeight/(uWeight/100.))/100;
+    }
+}
+
+// consider ONLY most valuable words via threshold - many irrelevat words would kill the score (irrelevant words make noise)
+bool AiAaBoW::calculateLeaderboardSync(const Note* n)
+{
+    MF_DEBUG("AA.BoW: SYNC leaderboard calculation for '" << n->getName() << "'" << endl);
+
+    // model is modified by dream running in the background
+    unique_lock<mutex> criticalSection{modelMutex};
+
+    // If N was REMOVED, then nobody will ask for leaderboard.
+    // If N was MODIFIED or ADDED, then leaderboard is provided once AI is updated (Mind is idle).
+    // If N was not DREAMED yet, then leaderboard is provided once N is dreamed.
+    // If leaderboard is cached, then there is nothing to do.
+    if(isLearned(n) && leaderboardCache.find(n) == leaderboardCache.end()) {
+        if(aaSparse) {
+            // sparse AA row IS leaderboard
+            calculateAaTopKRow(n->getAiAaMatrixIndex());
+
+            vector<AaTopK::Entry> row{};
+            aaTopK.getRow(n->getAiAaMatrixIndex(), row);
+            vector<pair<Note*,float>> leaderboard{};
+            for(AaTopK::Entry& e:row) {
+                leaderboard.push_back(std::make_pair(notes[e.first],e.second));
+            }
+            leaderboardCache[n] = leaderboard;
+        } else {
+            // calculate row/column of AA matrix (cells of candidates only if possible) & build leaderboard
+            const size_t y = n->getAiAaMatrixIndex();
+            vector<uint32_t> xs{};
+            if(getAaCandidates(y, xs)) {
+                vector<uint32_t> unset{};
+                for(uint32_t x:xs) {
+                    if(!aaMatrix.isSet(x,y)) {
+                        unset.push_back(x);
+                    }
+                }
+                vector<float> aa(unset.size());
+                calculateAa(y, unset.data(), unset.size(), aa.data());
+                for(size_t i=0; i<unset.size(); i++) {
+                    aaMatrix.set(unset[i], y, aa[i]);
+                }
+            } else {
+                calculateAaRow(y);
+                xs.clear();
+                for(size_t x=0; x<notes.size(); x++) {
+                    if(x!=y && notes[x]) xs.push_back(x);
+                }
+            }
+
+            int aaLeaderboard[AA_LEADERBOARD_SIZE][2];
+            for(int i=0; i<AA_LEADERBOARD_SIZE; i++) {
+                aaLeaderboard[i][0] = aaLeaderboard[i][1] = AA_NOT_SET;
+            }
+
+            float aa;
+            for(size_t x:xs) {
+                aa = aaMatrix.get(x,y);
+
+                if(aa > aaLeaderboard[AA_LEADERBOARD_SIZE-1][0]) { // covers also lb[][]==NOT_SET (== -1)
+                    // find target leaderboard row
+                    size_t target;
+                    for(target=0; target<AA_LEADERBOARD_SIZE; target++) {
+                        if(aaLeaderboard[target][0] == AA_NOT_SET) {
+                            break; // fill empty row -> no shift needed
+                        } else {
+                            if(aa > aaMatrix.get(aaLeaderboard[target][0],aaLeaderboard[target][1])) {
+                                break;
+                            }
+                        }
+                    }
+
+                    /// empty row > no shift needed
+                    if(aaLeaderboard[target][0] != AA_NOT_SET) {
+                        // shift leaderboard
+                        int sx = aaLeaderboard[target][0];
+                        int sy = aaLeaderboard[target][1];
+                        for(size_t ll=target; ll<AA_LEADERBOARD_SIZE; ll++) {
+                            if(aaLeaderboard[ll][0]!=AA_NOT_SET) {
+                                int tx=aaLeaderboard[ll][0];
+                                int ty=aaLeaderboard[ll][1];
+                                aaLeaderboard[ll][0]=sx;
+                                aaLeaderboard[ll][1]=sy;
+                                sx=tx;
+                                sy=ty;
+                            } else {
+                                aaLeaderboard[ll][0]=sx;
+                                aaLeaderboard[ll][1]=sy;
+                                break;
+                            }
+                        }
+                    }
+
+                    // assign value
+                    aaLeaderboard[target][0]=x;
+                    aaLeaderboard[target][1]=y;
+                }
+            }
+
+            MF_DEBUG("Leaderboard of " << n->getName() << " (" << n->getOutline()->getName() << "):" << endl);
+            vector<pair<Note*,float>> leaderboard{};
+            for(int i=0; i<AA_LEADERBOARD_SIZE && aaLeaderboard[i][0]!=AA_NOT_SET; i++) {
+                MF_DEBUG("  #" << i << " " <<
+                         notes[aaLeaderboard[i][0]]->getName() << " (" << notes[aaLeaderboard[i][0]]->getOutline()->getName() << ")" <<
+                         " ~ " << aaMatrix.get(aaLeaderboard[i][0],aaLeaderboard[i][1]) << endl);
+                leaderboard.push_back(std::make_pair(notes[aaLeaderboard[i][0]],aaMatrix.get(aaLeaderboard[i][0],aaLeaderboard[i][1])));
+            }
+
+            // cache leaderboard (copied)
+            leaderboardCache[n] = leaderboard;
+        }
+    }
+
+    criticalSection.unlock();
+    mind.decActiveProcesses();
+    return true;
+}
+
+uint64_t AiAaBoW::calculateFingerprint(const Note* n)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    hash = hashString(hash, n->getOutline()->getKey());
+    hash = hashString(hash, n->getName());
+    for(const string* line:n->getDescription()) {
+        if(line) hash = hashString(hash, *line);
+    }
+    hash = hashString(hash, n->getType()?n->getType()->getName():string{});
+    for(const Tag* tag:*n->getTags()) {
+        hash = hashString(hash, tag->getName());
+    }
+    return hash;
+}
+
+void AiAaBoW::remember(Outline* outline)
+{
+    enqueueOutline(outline, false);
+}
+
+void AiAaBoW::forget(Outline* outline)
+{
+    {
+        lock_guard<mutex> criticalSection{modelMutex};
+        for(size_t y=0; y<noteOutlines.size(); y++) {
+            if(noteOutlines[y]==outline) {
+                forgetSlot(y);
+            }
+        }
+    }
+    // the last change of O wins i.e. pending updates of O are dropped
+    enqueueOutline(outline, true);
+}
+
+void AiAaBoW::forget(const vector<Note*>& forgotten)
+{
+    lock_guard<mutex> criticalSection{modelMutex};
+    for(const Note* n:forgotten) {
+        const size_t y = static_cast<size_t>(n->getAiAaMatrixIndex());
+        if(n->getAiAaMatrixIndex() >= 0 && y < noteOutlines.size()
+             && (notes[y]==n || (y < dreamNotes.size() && dreamNotes[y]==n)))
+        {
+            forgetSlot(y);
+        }
+    }
+}
+
+void AiAaBoW::enqueueOutline(Outline* outline, bool forgotten)
+{
+    // nothing learned yet - the next dream will learn everything
+    if(notes.empty()) {
+        return;
+    }
+
+    {
+        lock_guard<mutex> criticalSection{pendingOutlinesMutex};
+        pendingOutlines.push_back(make_pair(outline, forgotten));
+    }
+    // update immediately if Mind is thinking and idle, otherwise on the next AA request
+    if(Configuration::getInstance().getMindState()==Configuration::MindState::THINKING
+         && mind.isActiveProcesses())
+    {
+        updatePendingOutlines();
+    }
+}
+
+void AiAaBoW::updatePendingOutlines()
+{
+    lock_guard<mutex> criticalSection{modelMutex};
+    applyPendingOutlines();
+}
+
+// it's presumed that caller holds model mutex
+void AiAaBoW::applyPendingOutlines()
+{
+    vector<pair<Outline*,bool>> pending{};
+    {
+        lock_guard<mutex> criticalSection{pendingOutlinesMutex};
+        pending.swap(pendingOutlines);
+    }
+    if(pending.empty() || notes.empty()) {
+        return;
+    }
+    MF_DEBUG("AA.BoW: updating " << pending.size() << " Os..." << endl);
+    snapshotDirty = true;
+
+    // the last change of O wins
+    vector<pair<Outline*,bool>> outlines{};
+    unordered_set<const Outline*> seen{};
+    for(auto o=pending.rbegin(); o!=pending.rend(); ++o) {
+        if(seen.insert(o->first).second) {
+            outlines.push_back(*o);
+        }
+    }
+
+    // retire Ns deleted from ALL Os first - pointers to deleted Ns might be
+    // still stored in slots and they must NOT be dereferenced
+    unordered_set<const Note*> live{};
+    for(auto& o:outlines) {
+        live.clear();
+        if(!o.second) {
+            live.insert(o.first->getNotes().begin(), o.first->getNotes().end());
+        }
+        for(size_t y=0; y<notes.size(); y++) {
+            if(notes[y] && noteOutlines[y]==o.first
+                 // N moved to another slot (e.g. new N allocated at address of deleted N)
+                 && (!live.count(notes[y]) || static_cast<size_t>(notes[y]->getAiAaMatrixIndex())!=y))
+            {
+                retireNote(y);
+            }
+        }
+    }
+
+    // (re)learn new and modified Ns
+    vector<size_t> updated{};
+    for(auto& o:outlines) {
+        if(!o.second) {
+            for(Note* n:o.first->getNotes()) {
+                size_t y;
+                if(isLearned(n)) {
+                    y = n->getAiAaMatrixIndex();
+                    noteOutlines[y] = o.first;
+                    uint64_t fingerprint = calculateFingerprint(n);
+                    if(fingerprint == fingerprints[y]) {
+                        continue;
+                    }
+                    unlearnNote(y);
+                    fingerprints[y] = fingerprint;
+                } else {
+                    y = allocateSlot(n, o.first);
+                }
+                WordFrequencyList* wfl = new WordFrequencyList{&lexicon};
+                tokenizer.tokenize(n, *wfl);
+                bow.add(n, wfl);
+                updated.push_back(y);
+            }
+        }
+    }
+
+    // IMPROVE vectors of other Ns keep word weights of dream (drift is negligible for small changes)
+    lexicon.recalculateWeights();
+    if(wordPostings.size() < lexicon.size()) {
+        wordPostings.resize(lexicon.size());
+    }
+    for(size_t y:updated) {
+        buildNoteVectors(y);
+    }
+    // IMPROVE neighbours of other Ns are refreshed by the next dream
+    for(size_t y:updated) {
+        calculateSemanticNeighbours(y);
+    }
+    for(size_t y:updated) {
+        invalidateAa(y);
+    }
+    MF_DEBUG("AA.BoW: " << updated.size() << " Ns updated, " << freeSlots.size() << " free slots" << endl);
+}
+
+size_t AiAaBoW::allocateSlot(Note* n, const Outline* outline)
+{
+    size_t y;
+    if(freeSlots.size()) {
+        y = freeSlots.back();
+        freeSlots.pop_back();
+    } else {
+        y = notes.size();
+        notes.push_back(nullptr);
+        noteOutlines.push_back(nullptr);
+        fingerprints.push_back(0);
+        wordVectors.emplace_back();
+        titleVectors.emplace_back();
+        if(aaSparse) {
+            aaTopK.resize(notes.size());
+        } else {
+            aaMatrix.resize(notes.size());
+        }
+    }
+
+    notes[y] = n;
+    noteOutlines[y] = outline;
+    fingerprints[y] = calculateFingerprint(n);
+    n->setAiAaMatrixIndex(y);
+    return y;
+}
+
+void AiAaBoW::unlearnNote(size_t y)
+{
+    WordFrequencyList* wfl = bow.get(notes[y]);
+    if(wfl) {
+        for(auto& e:wfl->iterable()) {
+            lexicon.remove(lexicon.getId(e.first), e.second);
+        }
+    }
+    bow.remove(notes[y]);
+
+    for(uint32_t id:wordVectors[y].getRelevantIds()) {
+        vector<uint32_t>& p = wordPostings[id];
+        p.erase(std::remove(p.begin(), p.end(), y), p.end());
+    }
+    // N's tags cannot be used - N might be deleted
+    for(auto& p:tagPostings) {
+        p.second.erase(std::remove(p.second.begin(), p.second.end(), y), p.second.end());
+    }
+    wordVectors[y] = WordVector{};
+    titleVectors[y].clear();
+}
+
+void AiAaBoW::retireNote(size_t y)
+{
+    const Note* n = notes[y];
+    MF_DEBUG("AA.BoW: retiring N slot " << y << endl);
+
+    unlearnNote(y);
+    if(aaSparse) {
+        aaTopK.invalidateRow(y);
+        vector<AaTopK::Entry> row{};
+        for(size_t x=0; x<notes.size(); x++) {
+            if(x!=y && notes[x] && aaTopK.isRowCalculated(x)) {
+                row.clear();
+                aaTopK.getRow(x, row);
+                for(AaTopK::Entry& e:row) {
+                    if(e.first==y) {
+                        aaTopK.invalidateRow(x);
+                        break;
+                    }
+                }
+            }
+        }
+    } else {
+        aaMatrix.clearRow(y);
+    }
+
+    // leaderboards of and with N
+    leaderboardCache.erase(n);
+    for(auto l=leaderboardCache.begin(); l!=leaderboardCache.end();) {
+        if(std::find_if(l->second.begin(), l->second.end(), [n](const pair<Note*,float>& p) { return p.first==n; })
+             != l->second.end())
+        {
+            l = leaderboardCache.erase(l);
+        } else {
+            ++l;
+        }
+    }
+
+    notes[y] = nullptr;
+    noteOutlines[y] = nullptr;
+    fingerprints[y] = 0;
+    freeSlots.push_back(y);
+}
+
+// it's presumed that caller holds model mutex
+void AiAaBoW::forgetSlot(size_t y)
+{
+    if(notes[y]) {
+        retireNote(y);
+    } else if(y < dreamNotes.size() && dreamNotes[y]) {
+        // not dreamed yet
+        dreamNotes[y] = nullptr;
+        noteOutlines[y] = nullptr;
+        freeSlots.push_back(y);
+    }
+}
+
+void AiAaBoW::buildNoteVectors(size_t y)
+{
+    WordFrequencyList* wfl = bow.get(notes[y]);
+    wfl->sort();
+    wordVectors[y].build(*wfl, lexicon, AA_WORD_RELEVANCY_THRESHOLD);
+    buildNoteEmbedding(y);
+    buildTitleVector(y);
+    addPostings(y);
+}
+
+void AiAaBoW::buildNoteEmbedding(size_t y)
+{
+    if(!embeddings.isOpen()) {
+        return;
+    }
+
+    const size_t dimension = embeddings.getDimension();
+    if(noteEmbeddings.size() < (y+1)*dimension) {
+        noteEmbeddings.resize((y+1)*dimension, 0.);
+    }
+    float* e = noteEmbeddings.data() + y*dimension;
+    std::fill(e, e+dimension, 0.);
+    // relevant words weighted by their (Lexicon) weight
+    const vector<uint32_t>& ids = wordVectors[y].getRelevantIds();
+    const vector<float>& weights = wordVectors[y].getRelevantWeights();
+    for(size_t i=0; i<ids.size(); i++) {
+        const float* v = embeddings.get(lexicon.getWord(ids[i]));
+        if(v) {
+            for(size_t d=0; d<dimension; d++) {
+                e[d] += weights[i]*v[d];
+            }
+        }
+    }
+    WordEmbeddings::normalize(e, dimension);
+}
+
+void AiAaBoW::calculateSemanticNeighbours()
+{
+    semanticNeighbours.clear();
+    if(!embeddings.isOpen()) {
+        return;
+    }
+    semanticNeighbours.resize(notes.size());
+
+    const size_t size = notes.size();
+    const size_t blockSize = size/(aaPool.getSize()*AA_BLOCKS_PER_THREAD)+1;
+    vector<WorkStealingPool::Task> tasks{};
+    for(size_t fromY=0; fromY<size; fromY+=blockSize) {
+        size_t toY = std::min(fromY+blockSize, size);
+        tasks.push_back([this,fromY,toY]() {
+            for(size_t y=fromY; y<toY; y++) {
+                calculateSemanticNeighbours(y);
+            }
+        });
+    }
+    aaPool.run(tasks);
+}
+
+void AiAaBoW::calculateSemanticNeighbours(size_t y)
+{
+    if(!embeddings.isOpen()) {
+        return;
+    }
+    if(semanticNeighbours.size() <= y) {
+        semanticNeighbours.resize(notes.size());
+    }
+    vector<uint32_t>& neighbours = semanticNeighbours[y];
+    neighbours.clear();
+    if(!notes[y] || !hasNoteEmbedding(y)) {
+        return;
+    }
+
+    vector<pair<float,uint32_t>> semantic{};
+    for(size_t x=0; x<notes.size(); x++) {
+        if(x!=y && notes[x] && hasNoteEmbedding(x)) {
+            float s = calculateSimilarityByEmbeddings(x, y);
+            if(s > 0.) {
+                semantic.push_back(make_pair(s, static_cast<uint32_t>(x)));
+            }
+        }
+    }
+    const size_t k = std::min(semantic.size(), AA_SEMANTIC_NEIGHBOURS);
+    std::partial_sort(semantic.begin(), semantic.begin()+k, semantic.end(), std::greater<pair<float,uint32_t>>());
+    for(size_t i=0; i<k; i++) {
+        neighbours.push_back(semantic[i].second);
+    }
+}
+
+float AiAaBoW::calculateSimilarityByEmbeddings(size_t x, size_t y) const
+{
+    const size_t dimension = embeddings.getDimension();
+    float cosine = WordEmbeddings::dot(
+        noteEmbeddings.data() + x*dimension,
+        noteEmbeddings.data() + y*dimension,
+        dimension);
+    // zero vector (N w/o known words) gives 0
+    return cosine > AA_EMBEDDING_SIMILARITY_FLOOR
+        ? (cosine-AA_EMBEDDING_SIMILARITY_FLOOR) / (1.-AA_EMBEDDING_SIMILARITY_FLOOR)
+        : 0.;
+}
+
+void AiAaBoW::openEmbeddings()
+{
+    const string& path = Configuration::getInstance().getAiEmbeddingsPath();
+    if(path.empty() || !isFile(path.c_str())) {
+        embeddings.close();
+        return;
+    }
+
+    string binaryPath{path};
+    if(!WordEmbeddings::isBinary(path)) {
+        // text embeddings are converted just once (and again if changed) - stems depend on language
+        const string& cachePath = Configuration::getInstance().getCachePath();
+        char name[64];
+        snprintf(name, sizeof(name), "embeddings-%016llx-%u.bin",
+                 static_cast<unsigned long long>(hashString(14695981039346656037ULL, path)),
+                 static_cast<unsigned>(tokenizer.getStemmerLanguage()));
+        binaryPath = cachePath;
+        binaryPath += FILE_PATH_SEPARATOR;
+        binaryPath += name;
+        if(!isFile(binaryPath.c_str()) || fileModificationTime(&binaryPath) < fileModificationTime(&path)) {
+            if(cachePath.empty()
+                 || !ensureCacheDirectory()
+                 || !WordEmbeddings::convert(path, binaryPath, tokenizer.getStemmerLanguage()))
+            {
+                MF_DEBUG("AA.BoW: unable to convert word embeddings " << path << endl);
+                embeddings.close();
+                return;
+            }
+        }
+    }
+
+    if(!embeddings.open(binaryPath) || embeddings.getStemmerLanguage() != tokenizer.getStemmerLanguage()) {
+        MF_DEBUG("AA.BoW: word embeddings " << binaryPath << " are invalid or stemmed for another language" << endl);
+        embeddings.close();
+    }
+}
+
+void AiAaBoW::invalidateAa(size_t y)
+{
+    const Note* n = notes[y];
+    leaderboardCache.erase(n);
+
+    if(aaSparse) {
+        // N's row is calculated on demand, other rows are invalidated if N is in the row
+        // (its AA changed) or if N would enter the row
+        aaTopK.invalidateRow(y);
+        vector<AaTopK::Entry> row{};
+        for(size_t x=0; x<notes.size(); x++) {
+            if(x!=y && notes[x] && aaTopK.isRowCalculated(x)) {
+                row.clear();
+                aaTopK.getRow(x, row);
+                bool invalid = row.size()<aaTopK.getK();
+                for(size_t i=0; !invalid && i<row.size(); i++) {
+                    invalid = row[i].first==y;
+                }
+                if(invalid || calculateAa(x, y) > row.back().second) {
+                    aaTopK.invalidateRow(x);
+                    leaderboardCache.erase(notes[x]);
+                }
+            }
+        }
+    } else {
+        // recalculate N's cross, but only cells of calculated rows (to keep them complete) and candidates
+        aaMatrix.clearRow(y);
+        for(size_t x=0; x<notes.size(); x++) {
+            if(x!=y && notes[x] && aaMatrix.isRowCalculated(x)) {
+                aaMatrix.set(x, y, calculateAa(x, y));
+            }
+        }
+        vector<uint32_t> xs{};
+        getAaCandidates(y, xs);
+        for(uint32_t x:xs) {
+            if(!aaMatrix.isSet(x,y)) {
+                aaMatrix.set(x, y, calculateAa(x, y));
+            }
+        }
+
+        // leaderboards which N entered, left or moved in
+        for(auto l=leaderboardCache.begin(); l!=leaderboardCache.end();) {
+            const size_t x = l->first->getAiAaMatrixIndex();
+            bool invalid = l->second.size()<AA_LEADERBOARD_SIZE;
+            for(size_t i=0; !invalid && i<l->second.size(); i++) {
+                invalid = l->second[i].first==n;
+            }
+            if(!invalid) {
+                if(!aaMatrix.isSet(x,y)) {
+                    aaMatrix.set(x, y, calculateAa(x, y));
+                }
+                invalid = aaMatrix.get(x,y) > l->second.back().second;
+            }
+            if(invalid) {
+                l = leaderboardCache.erase(l);
+            } else {
+                ++l;
+            }
+        }
+    }
+}
+
+string AiAaBoW::getCacheFilePath(const char* prefix, const char* extension)
+{
+    Configuration& config = Configuration::getInstance();
+    if(!config.isActiveRepository() || config.getCachePath().empty()) {
+        return string{};
+    }
+
+    // repository is identified by its path
+    char name[64];
+    snprintf(name, sizeof(name), "%s-%016llx.%s",
+             prefix,
+             static_cast<unsigned long long>(hashString(14695981039346656037ULL, config.getActiveRepository()->getPath())),
+             extension);
+    string path{config.getCachePath()};
+    path += FILE_PATH_SEPARATOR;
+    path += name;
+    return path;
+}
+
+string AiAaBoW::getSnapshotPath() const
+{
+    return getCacheFilePath("aa-bow", "bin");
+}
+
+string AiAaBoW::getTrainingSetPath() const
+{
+    return getCacheFilePath("aa-training", "tsv");
+}
+
+bool AiAaBoW::ensureCacheDirectory()
+{
+    const string& cachePath = Configuration::getInstance().getCachePath();
+    if(!isDirectoryOrFileExists(cachePath.c_str())) {
+        string parent{}, name{};
+        pathToDirectoryAndFile(cachePath, parent, name);
+        if(parent.size() && !isDirectoryOrFileExists(parent.c_str())) {
+            createDirectory(parent);
+        }
+        if(!createDirectory(cachePath)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+string AiAaBoW::getNoteKey(const Note* n)
+{
+    string key{n->getOutline()->getKey()};
+    key += "#";
+    key += n->getMangledName();
+    return key;
+}
+
+/*
+ * Training set format (TSV): label (1 ~ accepted, 0 ~ skipped), N key, associated N key
+ */
+void AiAaBoW::acceptAssociation(const Note* note, const Note* accepted, const vector<pair<Note*,float>>& leaderboard)
+{
+    string path = getTrainingSetPath();
+    if(path.empty() || !note || !accepted || note == accepted || !ensureCacheDirectory()) {
+        return;
+    }
+
+    {
+        ofstream out(path, ios::app);
+        if(!out) {
+            return;
+        }
+        const string key = getNoteKey(note);
+        for(const pair<Note*,float>& a:leaderboard) {
+            if(a.first == accepted) {
+                out << "1\t" << key << "\t" << getNoteKey(accepted) << "\n";
+                break;
+            }
+            // user skipped associations ranked above the accepted one
+            out << "0\t" << key << "\t" << getNoteKey(a.first) << "\n";
+        }
+    }
+
+    struct stat info;
+    if(!stat(path.c_str(), &info) && static_cast<size_t>(info.st_size) > AA_TRAINING_SET_MAX_BYTES) {
+        rotateTrainingSet();
+    }
+}
+
+void AiAaBoW::rotateTrainingSet()
+{
+    string path = getTrainingSetPath();
+    deque<string> lines{};
+    {
+        ifstream in(path);
+        string line{};
+        while(std::getline(in, line)) {
+            lines.push_back(line);
+            if(lines.size() > AA_TRAINING_MAX_SAMPLES) {
+                lines.pop_front();
+            }
+        }
+    }
+
+    // only the last samples are used for training
+    string tmpPath{path};
+    tmpPath += ".tmp";
+    ofstream out(tmpPath);
+    for(const string& l:lines) {
+        out << l << "\n";
+    }
+    out.close();
+    if(!out || std::rename(tmpPath.c_str(), path.c_str())) {
+        std::remove(tmpPath.c_str());
+        return;
+    }
+    MF_DEBUG("AA.BoW: training set rotated to " << lines.size() << " samples" << endl);
+}
+
+// it's presumed that caller ensures the correct Mind state & synchronization
+void AiAaBoW::trainAaModel()
+{
+    string path = getTrainingSetPath();
+    uint64_t size = 0;
+    int64_t modified = 0;
+    struct stat info;
+    if(!path.empty() && !stat(path.c_str(), &info)) {
+        size = info.st_size;
+        modified = info.st_mtime;
+    }
+    if(size == trainingSetSize && modified == trainingSetModified) {
+        MF_DEBUG("AA.BoW: training set didn't change - AA model is NOT retrained" << endl);
+        return;
+    }
+    trainingSetSize = size;
+    trainingSetModified = modified;
+
+    ifstream in(path);
+    if(path.empty() || !in) {
+        aaModel.forget();
+        return;
+    }
+    deque<string> lines{};
+    string line{};
+    while(std::getline(in, line)) {
+        lines.push_back(line);
+        if(lines.size() > AA_TRAINING_MAX_SAMPLES) {
+            lines.pop_front();
+        }
+    }
+
+    unordered_map<string,size_t> keys{};
+    for(size_t i=0; i<notes.size(); i++) {
+        if(notes[i]) {
+            keys[getNoteKey(notes[i])] = i;
+        }
+    }
+
+    // every accepted association is complemented by a random (negative) association
+    AssociationAssessmentFeatureBatch samples{2*lines.size()};
+    vector<float> labels{};
+    AssociationAssessmentNotesFeature aaFeature{};
+    size_t accepted = 0;
+    uint64_t random = 0;
+    for(const string& l:lines) {
+        size_t t1 = l.find('\t'), t2;
+        if(t1 == string::npos || (t2 = l.find('\t', t1+1)) == string::npos) {
+            continue;
+        }
+        auto y = keys.find(l.substr(t1+1, t2-t1-1));
+        auto x = keys.find(l.substr(t2+1));
+        if(y == keys.end() || x == keys.end() || x->second == y->second) {
+            continue;
+        }
+        const bool positive = l[0] == '1';
+
+        calculateAaFeature(x->second, y->second, aaFeature);
+        samples.add(aaFeature);
+        labels.push_back(positive?1.:0.);
+        if(positive) {
+            accepted++;
+            // LCG - training must be deterministic to match AA in snapshot
+            random = random*6364136223846793005ULL + 1442695040888963407ULL;
+            size_t z = (random >> 33) % notes.size();
+            if(notes[z] && z != x->second && z != y->second) {
+                calculateAaFeature(z, y->second, aaFeature);
+                samples.add(aaFeature);
+                labels.push_back(0.);
+            }
+        }
+    }
+
+    if(accepted < AA_TRAINING_MIN_ACCEPTED) {
+        MF_DEBUG("AA.BoW: " << accepted << " accepted associations are NOT enough to train AA model" << endl);
+        aaModel.forget();
+        return;
+    }
+    aaModel.train(samples, labels);
+}
+
+/*
+ * Snapshot format (native byte order):
+ *
+ *   header      ... magic, version, stemmer language, word relevancy threshold, sparse AA flag,
+ *                   AA model fingerprint, word embeddings fingerprint, AA model, count(N)
+ *   AA model    ... training set size, training set modification time, count(weight), weights
+ *   fingerprints ... N fingerprint for every N
+ *   lexicon     ... count(word), (length, word, frequency) for every word
+ *   BoW         ... (count(word), (word ID, frequency) for every word) for every N
+ *   AA          ... count(row), (N ID, cells of row/column cross w/o cells of calculated rows
+ *                   w/ lower ID - they were written w/ those rows) for every calculated row of dense AA
+ *                   OR count(row), (N ID, count(entry), (N ID, AA) for every entry) for every calculated row of top-K AA
+ *
+ * Snapshot is written only if model or AA changed since it was loaded/saved.
+ */
+bool AiAaBoW::saveSnapshot()
+{
+    if(!snapshotDirty) {
+        return true;
+    }
+    string path = getSnapshotPath();
+    // snapshot w/ deleted Ns would never match the next dream
+    if(path.empty() || notes.empty() || fingerprints.size() != notes.size() || freeSlots.size() || dreamNotes.size()) {
+        return false;
+    }
+    if(!ensureCacheDirectory()) {
+        return false;
+    }
+    // AA calculated while snapshot is written makes it dirty again
+    snapshotDirty = false;
+
+    // write to temporary file and rename it to never leave a broken snapshot
+    string tmpPath{path};
+    tmpPath += ".tmp";
+    ofstream out(tmpPath, ios::binary);
+    if(!out) {
+        return false;
+    }
+
+    writeBinary(out, SNAPSHOT_MAGIC);
+    writeBinary(out, SNAPSHOT_VERSION);
+    writeBinary(out, static_cast<uint32_t>(tokenizer.getStemmerLanguage()));
+    writeBinary(out, static_cast<uint32_t>(AA_WORD_RELEVANCY_THRESHOLD));
+    writeBinary(out, static_cast<uint8_t>(aaSparse));
+    writeBinary(out, aaModel.getFingerprint());
+    writeBinary(out, embeddings.getFingerprint());
+    writeBinary(out, trainingSetSize);
+    writeBinary(out, trainingSetModified);
+    const vector<float>& weights = aaModel.getWeights();
+    writeBinary(out, static_cast<uint32_t>(weights.size()));
+    out.write(reinterpret_cast<const char*>(weights.data()), weights.size()*sizeof(float));
+    writeBinary(out, static_cast<uint64_t>(notes.size()));
+    out.write(reinterpret_cast<const char*>(fingerprints.data()), fingerprints.size()*sizeof(uint64_t));
+
+    writeBinary(out, static_cast<uint32_t>(lexicon.size()));
+    for(uint32_t id=0; id<lexicon.size(); id++) {
+        const string& w = lexicon.getWord(id);
+        writeBinary(out, static_cast<uint32_t>(w.size()));
+        out.write(w.data(), w.size());
+        writeBinary(out, static_cast<int32_t>(lexicon.getFrequency(id)));
+    }
+
+    for(Note* n:notes) {
+        const WordFrequencyList* wfl = bow.get(n);
+        writeBinary(out, static_cast<uint32_t>(wfl?wfl->size():0));
+        if(wfl) {
+            for(auto& e:wfl->iterable()) {
+                writeBinary(out, lexicon.getId(e.first));
+                writeBinary(out, static_cast<int32_t>(e.second));
+            }
+        }
+    }
+
+    if(aaSparse) {
+        uint32_t rows = 0;
+        for(size_t y=0; y<aaTopK.getSize(); y++) {
+            if(aaTopK.isRowCalculated(y)) rows++;
+        }
+        writeBinary(out, rows);
+        vector<AaTopK::Entry> row{};
+        for(size_t y=0; y<aaTopK.getSize(); y++) {
+            if(aaTopK.isRowCalculated(y)) {
+                row.clear();
+                aaTopK.getRow(y, row);
+                writeBinary(out, static_cast<uint32_t>(y));
+                writeBinary(out, static_cast<uint16_t>(row.size()));
+                for(AaTopK::Entry& e:row) {
+                    writeBinary(out, e.first);
+                    writeBinary(out, e.second);
+                }
+            }
+        }
+    } else {
+        // the diagonal marks calculated rows - only cells of calculated rows are written
+        vector<uint32_t> rows{};
+        for(size_t y=0; y<aaMatrix.getSize(); y++) {
+            if(aaMatrix.isRowCalculated(y)) rows.push_back(y);
+        }
+        writeBinary(out, static_cast<uint32_t>(rows.size()));
+        vector<AaMatrix::Cell> cross{};
+        for(size_t r=0; r<rows.size(); r++) {
+            const size_t y = rows[r];
+            cross.clear();
+            for(size_t x=0, previous=0; x<aaMatrix.getSize(); x++) {
+                // cell shared w/ calculated row w/ lower ID was written w/ that row
+                if(previous<r && rows[previous]==x) {
+                    previous++;
+                    continue;
+                }
+                cross.push_back(aaMatrix.getCell(x, y));
+            }
+            writeBinary(out, static_cast<uint32_t>(y));
+            out.write(reinterpret_cast<const char*>(cross.data()), cross.size()*sizeof(AaMatrix::Cell));
+        }
+    }
+
+    out.close();
+    if(!out || std::rename(tmpPath.c_str(), path.c_str())) {
+        std::remove(tmpPath.c_str());
+        snapshotDirty = true;
+        return false;
+    }
+    MF_DEBUG("AA.BoW: snapshot of " << notes.size() << " Ns saved to " << path << endl);
+    return true;
+}
+
+bool AiAaBoW::loadSnapshot()
+{
+    string path = getSnapshotPath();
+    if(path.empty()) {
+        return false;
+    }
+    ifstream in(path, ios::binary);
+    if(!in) {
+        return false;
+    }
+
+    uint32_t magic, version, language, threshold;
+    uint8_t sparse;
+    uint64_t embeddingsFingerprint, count;
+    if(!readBinary(in, magic) || magic != SNAPSHOT_MAGIC
+         || !readBinary(in, version) || version != SNAPSHOT_VERSION
+         || !readBinary(in, language) || language != static_cast<uint32_t>(tokenizer.getStemmerLanguage())
+         || !readBinary(in, threshold) || threshold != static_cast<uint32_t>(AA_WORD_RELEVANCY_THRESHOLD)
+         || !readBinary(in, sparse)
+         || !readBinary(in, snapshotAaModelFingerprint)
+         || !readBinary(in, embeddingsFingerprint) || embeddingsFingerprint != embeddings.getFingerprint())
+    {
+        MF_DEBUG("AA.BoW: snapshot " << path << " is obsolete" << endl);
+        return false;
+    }
+
+    // AA model is restored even if Ns changed - it's retrained only if training set changed
+    uint64_t modelTrainingSetSize;
+    int64_t modelTrainingSetModified;
+    uint32_t weightsCount;
+    if(readBinary(in, modelTrainingSetSize)
+         && readBinary(in, modelTrainingSetModified)
+         && readBinary(in, weightsCount))
+    {
+        vector<float> weights(weightsCount);
+        if(in.read(reinterpret_cast<char*>(weights.data()), weightsCount*sizeof(float))
+             && aaModel.setWeights(weights)
+             && aaModel.getFingerprint() == snapshotAaModelFingerprint)
+        {
+            trainingSetSize = modelTrainingSetSize;
+            trainingSetModified = modelTrainingSetModified;
+        } else {
+            aaModel.forget();
+            trainingSetSize = 0;
+            trainingSetModified = 0;
+        }
+    }
+
+    if(!readBinary(in, count) || count != notes.size()) {
+        MF_DEBUG("AA.BoW: snapshot " << path << " is obsolete" << endl);
+        return false;
+    }
+    vector<uint64_t> snapshotFingerprints(count);
+    in.read(reinterpret_cast<char*>(snapshotFingerprints.data()), count*sizeof(uint64_t));
+    if(!in || snapshotFingerprints != fingerprints) {
+        MF_DEBUG("AA.BoW: snapshot " << path << " fingerprints do NOT match" << endl);
+        return false;
+    }
+
+    bool ok = true;
+    uint32_t words;
+    ok = readBinary(in, words);
+    string w{};
+    for(uint32_t i=0; ok && i<words; i++) {
+        uint32_t size;
+        int32_t frequency;
+        if((ok = readBinary(in, size))) {
+            w.resize(size);
+            ok = in.read(&w[0], size) && readBinary(in, frequency) && lexicon.add(w, frequency)==i;
+        }
+    }
+
+    for(size_t n=0; ok && n<notes.size(); n++) {
+        uint32_t size;
+        if((ok = readBinary(in, size))) {
+            WordFrequencyList* wfl = new WordFrequencyList{&lexicon};
+            bow.add(notes[n], wfl);
+            for(uint32_t i=0; ok && i<size; i++) {
+                uint32_t id;
+                int32_t frequency;
+                if((ok = readBinary(in, id) && readBinary(in, frequency) && id<lexicon.size())) {
+                    wfl->set(&lexicon.getWord(id), frequency);
+                }
+            }
+        }
+    }
+
+    // AA is reused only if it's stored the same way
+    if(ok && static_cast<bool>(sparse) == aaSparse) {
+        if(aaSparse) {
+            uint32_t rows;
+            ok = readBinary(in, rows);
+            for(uint32_t r=0; ok && r<rows; r++) {
+                uint32_t y;
+                uint16_t size;
+                if((ok = readBinary(in, y) && readBinary(in, size) && y<notes.size())) {
+                    for(uint16_t i=0; ok && i<size; i++) {
+                        AaTopK::Entry e;
+                        if((ok = readBinary(in, e.first) && readBinary(in, e.second) && e.first<notes.size())) {
+                            aaTopK.offer(y, e.first, e.second);
+                        }
+                    }
+                    aaTopK.setRowCalculated(y);
+                }
+            }
+        } else {
+            uint32_t rows;
+            ok = readBinary(in, rows);
+            // calculated rows are stored in ascending order
+            vector<uint32_t> calculated{};
+            vector<AaMatrix::Cell> cross{};
+            for(uint32_t r=0; ok && r<rows; r++) {
+                uint32_t y;
+                if((ok = readBinary(in, y) && y<notes.size() && (calculated.empty() || calculated.back()<y))) {
+                    cross.resize(notes.size()-calculated.size());
+                    ok = static_cast<bool>(in.read(reinterpret_cast<char*>(cross.data()), cross.size()*sizeof(AaMatrix::Cell)));
+                    for(size_t x=0, previous=0, c=0; ok && x<notes.size(); x++) {
+                        if(previous<calculated.size() && calculated[previous]==x) {
+                            previous++;
+                            continue;
+                        }
+                        aaMatrix.setCell(x, y, cross[c++]);
+                    }
+                    calculated.push_back(y);
+                }
+            }
+        }
+    }
+
+    if(!ok) {
+        MF_DEBUG("AA.BoW: snapshot " << path << " is broken" << endl);
+        lexicon.clear();
+        bow.clear();
+        if(aaSparse) {
+            aaTopK.reset(notes.size(), AA_LEADERBOARD_SIZE);
+        } else {
+            aaMatrix.reset(notes.size());
+        }
+        return false;
+    }
+    MF_DEBUG("AA.BoW: snapshot of " << notes.size() << " Ns loaded from " << path << endl);
+    return true;
+}
+
+// it's presumed that caller ensures the correct Mind state & synchronization
+bool AiAaBoW::sleep() {
+    // dream chunk or leaderboard calculation might be finishing
+    lock_guard<mutex> criticalSection{modelMutex};
+
+    // keep AA calculated on demand
+    saveSnapshot();
+
+    lexicon.clear();
+    notes.clear();
+    outlines.clear();
+    bow.clear();
+    wordVectors.clear();
+    noteEmbeddings.clear();
+    semanticNeighbours.clear();
+    titleLexicon.clear();
+    titleVectors.clear();
+    wordPostings.clear();
+    tagPostings.clear();
+    fingerprints.clear();
+    noteOutlines.clear();
+    freeSlots.clear();
+    leaderboardCache.clear();
+    dreamNotes.clear();
+    dreamed = 0;
+    dreamProgress = 100;
+    {
+        lock_guard<mutex> criticalSection{pendingOutlinesMutex};
+        pendingOutlines.clear();
+    }
+
+    return true;
+}
+
+// it's presumed that caller ensures the correct Mind state & synchronization
 bool AiAaBoW::amnesia() {
     sleep();
+
+    lock_guard<mutex> criticalSection{modelMutex};
     aaMatrix.clear();
+    aaTopK.clear();
 
     return true;
 }
@@ -20,13 +20,24 @@
 #define M8R_AI_ASSOCIATIONS_ASSESSMENT_BOW_H
 
 #include <future>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include <unordered_map>
 
 #include "../mind.h"
 #include "ai_aa.h"
+#include "aa_matrix.h"
+#include "aa_top_k.h"
+#include "aa_model.h"
 #include "./nlp/markdown_tokenizer.h"
 #include "./nlp/note_char_provider.h"
 #include "./nlp/bag_of_words.h"
+#include "./nlp/word_vector.h"
+#include "./nlp/word_embeddings.h"
 #include "./nlp/common_words_blacklist.h"
+#include "../../gear/work_stealing_pool.h"
+#include "../../gear/priority_executor.h"
 
 namespace m8r {
 
@@ -40,20 +51,64 @@ class Mind;
 // work. With correctly weighted words it will work (much better).
 class AiAaBoW : public AiAssociationsAssessment
 {
+public:
+    /**
+     * @brief AA storage: dense matrix w/ all rankings or sparse top-K store (leaderboards only).
+     */
+    enum class AaStorage {
+        AUTO,
+        DENSE_MATRIX,
+        TOP_K
+    };
+
 private:
-    static constexpr int THREAD_POOL_SIZE = 2; // IMPROVE thread pool size to be either configured OR #CPU detected and 1/2 or 1/3 used
     static constexpr float AA_NOT_SET = -1.;
     static constexpr int AA_WORD_RELEVANCY_THRESHOLD = 10; // use 10 words w/ highest weight from vectors (and ignore others - irrelevant can bring noice with volume)
     static constexpr float AA_TITLE_WORD_BONUS = 0.2;
+    // cosine similarity of embeddings of unrelated Ns is typically positive - lower similarity is considered to be 0
+    static constexpr float AA_EMBEDDING_SIMILARITY_FLOOR = 0.5;
+    // AA row is calculated in parallel by column blocks if there is more Ns
+    static constexpr size_t AA_PARALLEL_ROW_THRESHOLD = 2000;
+    // number of AA blocks per thread (more blocks ~ better balancing via stealing)
+    static constexpr size_t AA_BLOCKS_PER_THREAD = 8;
+    // leaderboard is calculated by full scan if there is less candidates sharing words/tags w/ N
+    // (or having similar meaning if word embeddings are used)
+    static constexpr size_t AA_CANDIDATES_MIN = AA_LEADERBOARD_SIZE;
+    // Ns w/ the most similar meaning added to AA candidates - less than minimum not to hide full scan fallback
+    static constexpr size_t AA_SEMANTIC_NEIGHBOURS = AA_CANDIDATES_MIN/2;
+    // Ns are dreamed in chunks - dream can be interrupted between chunks and dreamed Ns are associated
+    static constexpr size_t AA_DREAM_CHUNK_SIZE = 1000;
+    // AUTO storage uses dense AA matrix up to this number of Ns (~400MB), sparse top-K store otherwise
+    static constexpr size_t AA_DENSE_MATRIX_MAX_NOTES = 20000;
+    // AI tasks are executed by fixed pool: dream in background and (serialized) leaderboards
+    static constexpr size_t AA_EXECUTOR_THREADS = 2;
+    static constexpr int AA_TASK_PRIORITY_DREAM = 0;
+    static constexpr int AA_TASK_PRIORITY_LEADERBOARD = 1;
+    // AI model snapshot (persisted to cache) - bump version whenever format or AA calculation changes
+    static constexpr std::uint32_t SNAPSHOT_MAGIC = 0x4D384142;
+    static constexpr std::uint32_t SNAPSHOT_VERSION = 6;
+    // AA model is trained only if there is enough associations accepted by user (last ones are used)
+    static constexpr size_t AA_TRAINING_MIN_ACCEPTED = 10;
+    static constexpr size_t AA_TRAINING_MAX_SAMPLES = 10000;
+    // training set is rotated (the last samples are kept) once it grows above this size
+    static constexpr size_t AA_TRAINING_SET_MAX_BYTES = 4*1024*1024;
 
 private:
     Mind& mind;
     Memory& memory;
 
-    Lexicon lexicon; // IMPROVE merge Standford GloVe word vectors (https://nlp.stanford.edu/projects/glove/)
+    Lexicon lexicon;
+    // optional (stemmed) word embeddings like GloVe - memory-mapped
+    WordEmbeddings embeddings;
     CommonWordsBlacklist wordBlacklist;
     BagOfWords bow;
     MarkdownTokenizer tokenizer;
+    // titles are tokenized w/o stemming and blacklist to a dedicated Lexicon (not to affect word weights)
+    Lexicon titleLexicon;
+    MarkdownTokenizer titleTokenizer;
+    // queries (typed words, O) are tokenized to a scratch Lexicon (not to affect model)
+    Lexicon queryLexicon;
+    MarkdownTokenizer queryTokenizer;
 
     /*
      * Data sets
@@ -63,6 +118,49 @@ private:
     std::vector<Outline*> outlines; // IMPROVE make O* pair where .second is O embedding w/ classifications/attributes
     // Ns - vector index is used as ID through other data structures
     std::vector<Note*> notes; // IMPROVE make N* pair where .second is N embedding w/ classifications/attributes
+    // Ns' word vectors - vector index is N ID
+    std::vector<WordVector> wordVectors;
+    // Ns' embeddings - weighted average of relevant words' embeddings (unit length), N ID x embeddings dimension
+    std::vector<float> noteEmbeddings;
+    // Ns' semantic neighbours (N IDs of Ns w/ the most similar embeddings) - vector index is N ID, calculated by dream
+    std::vector<std::vector<std::uint32_t>> semanticNeighbours;
+    // Ns' title token vectors (sorted title Lexicon IDs) - vector index is N ID
+    std::vector<std::vector<std::uint32_t>> titleVectors;
+    // Ns' Os (Ns deleted from O are found w/o dereferencing them) - vector index is N ID
+    std::vector<const Outline*> noteOutlines;
+    // IDs of deleted Ns (nullptr in Ns vector) to be reused by new Ns
+    std::vector<std::uint32_t> freeSlots;
+
+    /*
+     * Incremental update: Os remembered/forgotten since dream (flag is true for forgotten O)
+     * are applied once Mind is idle i.e. no calculation is in progress.
+     */
+
+    std::vector<std::pair<Outline*,bool>> pendingOutlines;
+    std::mutex pendingOutlinesMutex;
+
+    /*
+     * Dream: Ns are dreamed (made available in Ns vector) in chunks. Interrupted
+     * dream is resumed by the next dream.
+     */
+
+    // Ns to be dreamed (nullptr if N's O changed during dream) - vector index is N ID
+    std::vector<Note*> dreamNotes;
+    size_t dreamed;
+    std::atomic<int> dreamProgress;
+    std::atomic<bool> dreamInterrupted;
+    // called (in dream thread w/o model lock) after every dreamed chunk w/ the number of dreamed Ns
+    std::function<void(size_t)> dreamChunkListener;
+    // dream running in the background and leaderboard calculations access model exclusively
+    std::mutex modelMutex;
+
+    /*
+     * Inverted index: N's most relevant words (AA_WORD_RELEVANCY_THRESHOLD w/ the highest
+     * weight) and tags > Ns (vector index) - used to prune AA leaderboard candidates.
+     */
+
+    std::vector<std::vector<std::uint32_t>> wordPostings; // indexed by word ID
+    std::unordered_map<const Tag*,std::vector<std::uint32_t>> tagPostings;
 
     /*
      * Associations
@@ -71,15 +169,36 @@ private:
     // associate Ns as you READ: N -> O/N
     // IMPROVE thing*,float - both O and N to be association
     std::map<const Note*,std::vector<std::pair<Note*,float>>> leaderboardCache;
-    std::set<const Note*> leaderboardWip;
 
     // associate as you WRITE: word(s) -> O/N
     // IMPROVE std::map<const Note*,std::vector<std::pair<string*,float>>> leaderboardCache;
 
-    // Associations assessment matrix w/ rankings for any N1/N2 tuple (diagonal symmetry).
-    // Changed from float** to vector<vector>> to enable row/col extension on new N/O
-    // (keep & avoid realloc)
-    std::vector<std::vector<float>> aaMatrix; // IMPROVE: notesAA and outlinesAA ~ Notes assocications assessment
+    // Associations assessment matrix w/ rankings for any N1/N2 tuple (diagonal symmetry)
+    // stored as packed upper triangular matrix of quantized rankings.
+    AaMatrix aaMatrix; // IMPROVE: notesAA and outlinesAA ~ Notes assocications assessment
+    // Sparse alternative to AA matrix w/ AA_LEADERBOARD_SIZE best associations of every N.
+    AaTopK aaTopK;
+    AaStorage aaStorage;
+    bool aaSparse;
+
+    // AA model trained (when dreaming) on associations accepted by user - hand-weighted metric if not trained
+    AssociationAssessmentModel aaModel;
+
+    /*
+     * Snapshot: lexicon, BoW and calculated AA are persisted to the cache and reused
+     * by the next dream if fingerprints of all Ns match.
+     */
+
+    // Ns' fingerprints (hash of everything what affects AA) at the time of dream - vector index is N ID
+    std::vector<std::uint64_t> fingerprints;
+    bool snapshotLoaded;
+    // model or AA changed since snapshot was saved/loaded (AA rows are calculated by executor threads)
+    std::atomic<bool> snapshotDirty;
+    // fingerprint of AA model used to calculate AA stored in snapshot
+    std::uint64_t snapshotAaModelFingerprint;
+    // size and modification time of training set used to train AA model - model is retrained only if they change
+    std::uint64_t trainingSetSize;
+    std::int64_t trainingSetModified;
 
 public:
     explicit AiAaBoW(Memory& memory, Mind& mind);
@@ -100,57 +219,242 @@ public:
      */
     virtual std::shared_future<bool> getAssociatedNotes(const Note* note, std::vector<std::pair<Note*,float>>& associations);
 
-    // TODO to be implemented
-    virtual std::shared_future<bool> getAssociatedNotes(Outline* outline, std::vector<std::pair<Note*,float>>& associations) {
-        UNUSED_ARG(outline);
-        UNUSED_ARG(associations);
+    /**
+     * @brief Get Ns associated w/ O (O's Ns are not associated).
+     *
+     * O is represented by aggregated vector of its Ns and its name/description,
+     * associations are calculated synchronously i.e. future is always valid.
+     */
+    virtual std::shared_future<bool> getAssociatedNotes(Outline* outline, std::vector<std::pair<Note*,float>>& associations);
 
-        std::promise<bool> p{};
-        p.set_value(false);
-        return std::shared_future<bool>(p.get_future());
-    }
+    /**
+     * @brief Get Ns associated w/ (typed) words - self is not associated.
+     *
+     * Associations are calculated synchronously i.e. future is always valid.
+     */
+    virtual std::shared_future<bool> getAssociatedNotes(const std::string& words, std::vector<std::pair<Note*,float>>& associations, const Note* self);
 
-    // TODO to be implemented
-    virtual std::shared_future<bool> getAssociatedNotes(const std::string& words, std::vector<std::pair<Note*,float>>& associations, const Note* self) {
-        UNUSED_ARG(words);
-        UNUSED_ARG(associations);
-        UNUSED_ARG(self);
+    /**
+     * @brief Update BoW and AA of O's Ns which were created, modified or deleted.
+     *
+     * Changed N is tokenized again, Lexicon word frequencies, its word vector and
+     * postings are updated and only AA cells and leaderboards which involve the N
+     * are invalidated - associations are correct w/o a full dream. Slots of deleted
+     * Ns are retired and reused by new Ns.
+     *
+     * Slots of forgotten O and deleted Ns are retired synchronously (model is locked
+     * until running dream chunk or AA calculation finishes) - queued and running
+     * calculations must not dereference Ns which are about to be deallocated.
+     */
+    virtual void remember(Outline* outline);
+    virtual void forget(Outline* outline);
+    virtual void forget(const std::vector<Note*>& forgotten);
 
-        std::promise<bool> p{};
-        p.set_value(false);
-        return std::shared_future<bool>(p.get_future());
-    }
+    /**
+     * @brief Record that user accepted association from N's leaderboard.
+     *
+     * Accepted association is positive AA model training sample, associations ranked
+     * above it (skipped by user) are negative samples. Samples are appended to training
+     * set in the cache and AA model is trained by the next dream.
+     */
+    virtual void acceptAssociation(const Note* note, const Note* accepted, const std::vector<std::pair<Note*,float>>& leaderboard);
 
+    /**
+     * @brief Train AA model using training set - AA model is forgotten if there is not enough samples.
+     *
+     * Model is NOT retrained if training set didn't change since it was trained (or restored from snapshot).
+     */
+    void trainAaModel();
+    const AssociationAssessmentModel& getAaModel() const { return aaModel; }
+    std::string getTrainingSetPath() const;
+    const WordEmbeddings& getEmbeddings() const { return embeddings; }
+
+    virtual void setTaskListener(std::function<void()> listener) { executor.setFinishListener(listener); }
+    virtual int getDreamProgress() const { return dreamProgress; }
+    virtual void interruptDream() { dreamInterrupted = true; }
+    /**
+     * @brief Set listener called after every dreamed chunk (in dream thread).
+     *
+     * Dream doesn't hold the model while listener runs i.e. O changes and dream
+     * interruption are handled by the next chunk (nullptr to unset).
+     */
+    void setDreamChunkListener(std::function<void(size_t)> listener) { dreamChunkListener = listener; }
+    const std::vector<std::vector<std::uint32_t>>& getWordPostings() const { return wordPostings; }
+
+    /**
+     * @brief Forget model (AA calculated so far is kept in snapshot).
+     *
+     * Resume state of interrupted dream is discarded i.e. the next dream starts
+     * from scratch (or from snapshot).
+     */
     virtual bool sleep();
 
     virtual bool amnesia();
 
+    /**
+     * @brief Precalculate entire AA.
+     *
+     * Upper triangular AA is split to row blocks w/ similar number of cells which
+     * are calculated by work stealing pool of threads (0 ~ configured number of threads).
+     * Blocks write disjoint AA cells, therefore no locking is needed.
+     *
+     * Sparse AA is split to row blocks and every row (K best associations of N)
+     * is calculated independently i.e. each N1/N2 tuple is assessed twice, but rows
+     * are calculated w/o any locking and dense matrix is never materialized.
+     *
+     * LONG running method - it's presumed that caller ensures the correct Mind
+     * state & synchronization.
+     */
+    void precalculateAa(size_t threads=0);
+
+    /**
+     * @brief Set AA storage to be used since the next dream.
+     */
+    void setAaStorage(AaStorage aaStorage) { this->aaStorage = aaStorage; }
+    bool isAaSparse() const { return aaSparse; }
+    const AaTopK& getAaTopK() const { return aaTopK; }
+
+    /**
+     * @brief Persist snapshot of AI model (lexicon, BoW, calculated AA) to the cache.
+     *
+     * Snapshot is written when dream finishes and when AI falls asleep (to keep
+     * AA calculated on demand).
+     */
+    bool saveSnapshot();
+    bool isSnapshotLoaded() const { return snapshotLoaded; }
+    std::string getSnapshotPath() const;
+
+    size_t getAaSize() const { return aaMatrix.getSize(); }
+    float getAa(size_t x, size_t y) const { return aaMatrix.get(x,y); }
+
 private:
 
     /*
-     * Worker threads:
-     *  1. packaged task is assigned to thread
-     *  2. thread performs the task and calls detach() on self when finishes
-     *     to indicate that it's ready to be deleted
-     *  3. if main thread detects that !thread.joinable(), then it can be deleted;
-     *     cleanup is done on any new thread launch AND/OR by this class destructor.
+     * Workers of AA blocks (long rows, semantic neighbours, precalculation) - a single
+     * pool (sized when AI is created) is shared by dream and leaderboard calculations
+     * so that the number of threads is bounded.
      */
+    WorkStealingPool aaPool;
 
-    // IMPROVE introduce a LIMIT on number of running threads in configuration
-    std::vector<std::thread*> runningWorkers;
-    std::mutex runningWorkersMutex;
+    /*
+     * Executor of async dream and leaderboard calculations: leaderboard requests
+     * are deduplicated by N, request for the currently viewed N is executed first
+     * and queued requests for other Ns (user navigated away) are cancelled.
+     */
+
+    PriorityExecutor executor;
 
 private:
 
     /**
      * @brief Learn Memory to start thinking.
+     *
+     * Ns are dreamed in chunks - learning can be interrupted and resumed.
+     */
+    bool learnMemorySync();
+
+    /**
+     * @brief Clear model and prepare Ns to be dreamed (or load them from snapshot).
+     */
+    void startDream();
+
+    /**
+     * @brief Skip Ns of Os changed during dream - they are learned incrementally.
      */
-    bool learnMemorySync(std::thread* t = nullptr);
+    void dropChangedNotes();
+
+    /**
+     * @brief Load lexicon, BoW and calculated AA from snapshot if it matches Ns' fingerprints.
+     */
+    bool loadSnapshot();
+
+    /**
+     * @brief Calculate hash of N's O, name, description, type and tags.
+     */
+    static std::uint64_t calculateFingerprint(const Note* n);
+
+    /**
+     * @brief Is N learned i.e. does it have (valid) AA index?
+     */
+    bool isLearned(const Note* n) const {
+        return n->getAiAaMatrixIndex() >= 0
+            && static_cast<size_t>(n->getAiAaMatrixIndex()) < notes.size()
+            && notes[n->getAiAaMatrixIndex()] == n;
+    }
+
+    /**
+     * @brief Queue O update and apply queued updates if Mind is idle.
+     */
+    void enqueueOutline(Outline* outline, bool forgotten);
+    void updatePendingOutlines();
+    void applyPendingOutlines();
+
+    /**
+     * @brief Get slot (ID) for new N - either a slot of deleted N or a new one.
+     */
+    size_t allocateSlot(Note* n, const Outline* outline);
+
+    /**
+     * @brief Remove N's words from Lexicon, BoW, word/title vectors and postings.
+     *
+     * N is not dereferenced i.e. it might be already deleted.
+     */
+    void unlearnNote(size_t y);
+
+    /**
+     * @brief Retire slot of deleted N and invalidate its AA.
+     */
+    void retireNote(size_t y);
+    /**
+     * @brief Retire slot of learned N or drop N which was not dreamed yet.
+     */
+    void forgetSlot(size_t y);
+
+    /**
+     * @brief Build word/title vectors and postings of (re)learned N.
+     */
+    void buildNoteVectors(size_t y);
+    void buildNoteEmbedding(size_t y);
+    void buildTitleVector(size_t y);
+    void addPostings(size_t y);
+
+    /**
+     * @brief Invalidate AA cells and leaderboards affected by (re)learned N.
+     */
+    void invalidateAa(size_t y);
 
     /**
      * @brief Calculate leaderboard and indicate that it has been stored to cache.
      */
-    bool calculateLeaderboardSync(const Note* n, std::thread* t = nullptr);
+    bool calculateLeaderboardSync(const Note* n);
+
+    /**
+     * @brief Tokenize query text to words (Ns') Lexicon - unknown words are skipped.
+     */
+    void tokenizeQuery(const std::string& text, WordFrequencyList& wfl);
+
+    /**
+     * @brief Tokenize query title to sorted title Lexicon IDs - unknown tokens are skipped.
+     */
+    void tokenizeQueryTitle(const std::string& title, std::vector<std::uint32_t>& titleVector);
+
+    /**
+     * @brief Get AA_LEADERBOARD_SIZE Ns associated w/ query (Ns of O and self are skipped).
+     *
+     * Candidates are pruned using postings like for N leaderboard.
+     */
+    void calculateQueryLeaderboard(
+            const WordVector& query,
+            const std::vector<std::uint32_t>& titleVector,
+            const std::vector<const Tag*>* tags,
+            const Outline* outline,
+            const Note* self,
+            std::vector<std::pair<Note*,float>>& leaderboard);
+
+    /**
+     * @brief Calculate association assessment of query and N (by N ID).
+     */
+    float calculateQueryAa(const WordVector& query, const std::vector<std::uint32_t>& titleVector, const std::vector<const Tag*>* tags, size_t x);
 
     /**
      * @brief Initialize blacklist using common words.
@@ -161,23 +465,81 @@ private:
     void initializeWordBlacklist();
 
     /**
-     * @brief Precalculate entire AA.
+     * @brief Calculate AA row/column cross i.e. associations of N with *all* other Ns.
      *
-     * LONG running method.
+     * LONG running method on bigger repositories (parallelized if AA is big).
      */
-    void precalculateAa();
+    void calculateAaRow(size_t y);
 
     /**
-     * @brief Calculate AA row/column cross i.e. associations of N with *all* other Ns.
+     * @brief Calculate AA row/column cross for the given columns.
+     */
+    void calculateAaRow(size_t y, size_t fromX, size_t toX);
+
+    /**
+     * @brief Calculate K best associations of N (sparse AA) - parallelized if AA is big.
+     */
+    void calculateAaTopKRow(size_t y);
+
+    /**
+     * @brief Build inverted index of Ns' most relevant words and tags.
+     */
+    void buildPostings();
+
+    /**
+     * @brief Get (sorted) Ns which share a relevant word/tag or O w/ N.
+     *
+     * Other Ns can be associated only weakly (by type or less relevant words),
+     * therefore they are not worth assessment.
      *
-     * LONG running method on bigger repositories.
+     * @return false if there are too few candidates and full scan should be used.
      */
-    void calculateAaRow(size_t y);
+    bool getAaCandidates(size_t y, std::vector<std::uint32_t>& candidates);
+
+    /**
+     * @brief Calculate associations of N w/ given Ns and offer them to min-heap.
+     */
+    void calculateAaTopKRow(size_t y, size_t fromX, size_t toX, AaTopK::Entry* heap, std::uint16_t& count);
+
+    /**
+     * @brief Calculate association assessment of two Ns (by N IDs).
+     */
+    float calculateAa(size_t x, size_t y);
+
+    /**
+     * @brief Calculate association assessment of N y and given Ns - features are assessed in batches.
+     */
+    void calculateAa(size_t y, const std::uint32_t* xs, size_t count, float* aa);
+
+    /**
+     * @brief Calculate association assessment feature of two Ns (by N IDs).
+     */
+    void calculateAaFeature(size_t x, size_t y, AssociationAssessmentNotesFeature& aaFeature);
+
+    /**
+     * @brief Get N key (O key and N mangled name) used to persist training samples.
+     */
+    static std::string getNoteKey(const Note* n);
+
+    /**
+     * @brief Keep only the last samples of training set which grew too big.
+     */
+    void rotateTrainingSet();
+
+    /**
+     * @brief Create cache directory if it doesn't exist.
+     */
+    static bool ensureCacheDirectory();
 
     /**
-     * @brief Calculate similarity of two word vectors.
+     * @brief Get path of repository specific file in cache directory (empty if there is no cache).
      */
-    float calculateSimilarityByWords(WordFrequencyList& v1, WordFrequencyList& v2, int threshold=1000);
+    static std::string getCacheFilePath(const char* prefix, const char* extension);
+
+    /**
+     * @brief Get number of threads to be used for AA calculation.
+     */
+    size_t getAaThreads() const;
 
     /**
      * @brief Calculate similarity of two tag lists.
@@ -185,36 +547,44 @@ private:
     float calculateSimilarityByTags(const std::vector<const Tag*>* t1, const std::vector<const Tag*>* t2);
 
     /**
-     * @brief Calculate similarity of two N/O names.
+     * @brief Calculate similarity of two N/O names as ratio of shared title tokens.
      */
-    float calculateSimilarityByTitles(const std::string& t1, const std::string& t2);
+    static float calculateSimilarityByTitles(const std::vector<std::uint32_t>& t1, const std::vector<std::uint32_t>& t2);
 
     /**
-     * @brief Check AA matrix symmetry.
+     * @brief Calculate similarity of Ns by meaning (cosine of N embeddings mapped to <0,1>).
+     */
+    float calculateSimilarityByEmbeddings(size_t x, size_t y) const;
+    bool hasNoteEmbedding(size_t y) const {
+        return embeddings.isOpen() && noteEmbeddings.size() >= (y+1)*embeddings.getDimension();
+    }
+    /**
+     * @brief Calculate semantic neighbours of all Ns in parallel (full scan of N embeddings).
      */
-    void assertAaSymmetry();
+    void calculateSemanticNeighbours();
+    void calculateSemanticNeighbours(size_t y);
 
     /**
-     * @brief Get AA leaderboard from cache.
+     * @brief Map word embeddings configured by user (text embeddings are converted to cache first).
      */
-    bool getCachedLeaderboard(const Note* n, std::vector<std::pair<Note*,float>>& leaderboard);
+    void openEmbeddings();
 
     /**
-     * @brief Remove finished workers and add new one.
+     * @brief Get AA leaderboard from cache.
      */
-    void addWorkerAndCleanZombies(std::thread* t);
+    bool getCachedLeaderboard(const Note* n, std::vector<std::pair<Note*,float>>& leaderboard);
 
 public:
 #ifdef DO_MF_DEBUG
     void printAa() {
         std::cout << "AA Matrix:" << std::endl;
-        for(size_t i=0; i<aaMatrix.size(); i++) {
+        for(size_t i=0; i<aaMatrix.getSize(); i++) {
             std::cout << "AA[" << i << "] = ";
-            for(size_t j=0; j<aaMatrix.size(); j++) {
-                if(aaMatrix[i][j] == -1) {
+            for(size_t j=0; j<aaMatrix.getSize(); j++) {
+                if(!aaMatrix.isSet(i,j)) {
                     std::cout << "_ ";
                 } else {
-                    std::cout << aaMatrix[i][j] << " ";
+                    std::cout << aaMatrix.get(i,j) << " ";
                 }
             }
             std::cout << std::endl;
@@ -18,14 +18,19 @@
 */
 #include "ai_aa_weighted_fts.h"
 
+#include <algorithm>
+
 namespace m8r {
 
 using namespace std;
 
+constexpr size_t AiAaWeightedFts::TERM_CACHE_MAX_SIZE;
+
 AiAaWeightedFts::AiAaWeightedFts(Memory& memory, Mind& mind)
     : mind(mind),
       memory(memory),
-      commonWords{}
+      commonWords{},
+      indexed{false}
 {
     lastMindDeleteWatermark = mind.getDeleteWatermark();
 }
@@ -47,6 +52,9 @@ void AiAaWeightedFts::refreshNotes(bool checkWatermark)
     lastMindDeleteWatermark = mind.getDeleteWatermark();
     notes.clear();
     memory.getAllNotes(notes);
+    if(checkWatermark && indexed) {
+        prunePostings();
+    }
 
 #ifdef DO_MF_DEBUG
     auto end = chrono::high_resolution_clock::now();
@@ -59,7 +67,12 @@ shared_future<bool> AiAaWeightedFts::dream()
 {
     MF_DEBUG("AA.FTS: LEARNING memory..." << endl);
 
-    refreshNotes(false);
+    {
+        lock_guard<mutex> criticalSection{postingsMutex};
+        refreshNotes(false);
+        clearPostings();
+        updatePostings();
+    }
     mind.persistMindState(Configuration::MindState::THINKING);
 
     std::promise<bool> p{};
@@ -116,6 +129,8 @@ vector<pair<Note*,float>>* AiAaWeightedFts::assessNotesWithFallback(const string
     vector<pair<Note*,float>>* result = new vector<pair<Note*,float>>();
     if(regexp.empty()) return result;
 
+    updatePostings();
+
     // case is *always* ignored to get more matches (more matches vs. precision trade-off)
     const bool ignoreCase = true;
     vector<string> words{};
@@ -128,24 +143,19 @@ vector<pair<Note*,float>>* AiAaWeightedFts::assessNotesWithFallback(const string
         r += regexp;
     }
     r = MarkdownTokenizer::stripFrontBackNonAlpha(r);
-    if(r.size()) words.push_back(r);
 
     // exact match
-    if(scope) {
-        assessNotesInOutline(scope, result, words, ignoreCase);
-    } else {
-        const vector<m8r::Outline*> outlines = memory.getOutlines();
-        for(Outline* outline:outlines) {
-            assessNotesInOutline(outline, result, words, ignoreCase);
-        }
+    unordered_map<Outline*,OutlineMatches> matches{};
+    if(r.size()) {
+        assessTerm(r, scope, matches);
     }
+    assessMatches(matches, result);
     // remove self in case that result can become empty
     if(self && result->size() == 1 && result->begin()->first == self) {
         result->clear();
     }
 
     // FALLBACK: if exact match failed, split regexp to words (if it's multi-word) and try FTS assessment word by word
-    // IMPROVE this may take longer than single search > implement ASYNC run w/ distributor based refresh
     if(result->empty()) {
         MF_DEBUG("AA.FTS.fallback for '" << regexp << "'" << endl);
         words.clear();
@@ -155,16 +165,15 @@ vector<pair<Note*,float>>* AiAaWeightedFts::assessNotesWithFallback(const string
         MF_DEBUG("AA.FTS.fallback words: " << words.size() << endl);
         if(words.size()) {
             // IMPROVE: iterate 3 *most valuable* words (now the first 3 words are considered, value is ignored)
-            words.resize(FTS_SEARCH_THRESHOLD_MULTIWORD);
+            if(words.size() > FTS_SEARCH_THRESHOLD_MULTIWORD) {
+                words.resize(FTS_SEARCH_THRESHOLD_MULTIWORD);
+            }
             // search using words
-            if(scope) {
-                assessNotesInOutline(scope, result, words, ignoreCase);
-            } else {
-                const vector<m8r::Outline*> outlines = memory.getOutlines();
-                for(Outline* outline:outlines) {
-                    assessNotesInOutline(outline, result, words, ignoreCase);
-                }
+            matches.clear();
+            for(const string& w:words) {
+                assessTerm(w, scope, matches);
             }
+            assessMatches(matches, result);
         }
     }
 
@@ -176,48 +185,145 @@ vector<pair<Note*,float>>* AiAaWeightedFts::assessNotesWithFallback(const string
     return result;
 }
 
-void AiAaWeightedFts::assessNotesInOutline(Outline* outline, vector<pair<Note*,float>>* result, vector<string>& regexps, const bool ignoreCase)
+void AiAaWeightedFts::assessTerm(const string& term, Outline* scope, unordered_map<Outline*,OutlineMatches>& matches)
 {
-    // IMPROVE make this faster - do NOT convert to lower case, but compare it in that method > will do less
-    if(ignoreCase) {
-        // case INSENSITIVE
+    bool isWord = true;
+    for(char c:term) {
+        if(!isWordChar(c)) {
+            isWord = false;
+            break;
+        }
+    }
 
-        // O matches
-        float oScore = 0;
-        string s{};
-        // O.title matches
-        stringToLower(outline->getName(), s);
-        for(auto& regexp:regexps) {
-            if(s.find(regexp)!=string::npos) {
-                oScore += 100.;
+    if(isWord) {
+        // term can be found only within words (which contain it)
+        const TermWords& termWords = getTermWords(term);
+        // title matches term once even if more title words contain it
+        unordered_set<const void*> titleMatched{};
+        for(const Postings::value_type* w:termWords.titles) {
+            for(const Posting& p:w->second) {
+                if(scope && p.outline != scope) continue;
+                if(titleMatched.insert(p.note?static_cast<const void*>(p.note):p.outline).second) {
+                    OutlineMatches& om = matches[p.outline];
+                    (p.note ? om.notes[p.note] : om.outline).title += 100.;
+                }
+            }
+        }
+        for(const Postings::value_type* w:termWords.descriptions) {
+            const size_t occurrences = countOccurrences(w->first, term);
+            for(const Posting& p:w->second) {
+                if(scope && p.outline != scope) continue;
+                OutlineMatches& om = matches[p.outline];
+                Matches& m = p.note ? om.notes[p.note] : om.outline;
+                m.description += occurrences*p.count;
+            }
+        }
+    } else {
+        // phrase: Os whose texts contain all words (term's first/last word may be just a part of a word)
+        vector<string> termWords{};
+        splitToWords(term, termWords);
+        if(termWords.empty()) {
+            // term w/o word characters can be found by scan only
+            if(scope) {
+                assessTermInOutline(term, scope, matches);
+            } else {
+                for(Outline* o:memory.getOutlines()) {
+                    assessTermInOutline(term, o, matches);
+                }
+            }
+            return;
+        }
+
+        unordered_set<Outline*> candidates{};
+        for(size_t i=0; i<termWords.size(); i++) {
+            unordered_set<Outline*> found{};
+            const TermWords& tw = getTermWords(termWords[i]);
+            for(const Postings::value_type* w:tw.titles) {
+                for(const Posting& p:w->second) {
+                    if(!i || candidates.count(p.outline)) found.insert(p.outline);
+                }
+            }
+            for(const Postings::value_type* w:tw.descriptions) {
+                for(const Posting& p:w->second) {
+                    if(!i || candidates.count(p.outline)) found.insert(p.outline);
+                }
+            }
+            candidates.swap(found);
+            if(candidates.empty()) {
+                return;
+            }
+        }
+        for(Outline* o:candidates) {
+            if(!scope || o == scope) {
+                assessTermInOutline(term, o, matches);
             }
         }
-        // O.description matches
-        float matches = 0.;
-        for(string* d:outline->getDescription()) {
+    }
+}
+
+void AiAaWeightedFts::assessTermInOutline(const string& term, Outline* outline, unordered_map<Outline*,OutlineMatches>& matches)
+{
+    // IMPROVE make this faster - do NOT convert to lower case, but compare it in that method > will do less
+    OutlineMatches* om = nullptr;
+    string s{};
+
+    // O.title matches
+    stringToLower(outline->getName(), s);
+    if(s.find(term)!=string::npos) {
+        om = &matches[outline];
+        om->outline.title += 100.;
+    }
+    // O.description matches
+    for(string* d:outline->getDescription()) {
+        if(d) {
+            s.clear();
+            stringToLower(*d, s);
+            if(size_t c = countOccurrences(s, term)) {
+                if(!om) om = &matches[outline];
+                om->outline.description += c;
+            }
+        }
+    }
+
+    // O's N matches
+    for(Note* note:outline->getNotes()) {
+        // N.title matches
+        s.clear();
+        stringToLower(note->getName(), s);
+        if(s.find(term)!=string::npos) {
+            if(!om) om = &matches[outline];
+            om->notes[note].title += 100.;
+        }
+        // N.description matches
+        for(string* d:note->getDescription()) {
             if(d) {
                 s.clear();
                 stringToLower(*d, s);
-                for(auto& regexp:regexps) {
-                    // find all matches (regexp matched more than once)
-                    size_t m = s.find(regexp, 0);
-                    while(m != string::npos) {
-                        matches++;
-                        m = s.find(regexp,m+1);
-                    }
+                if(size_t c = countOccurrences(s, term)) {
+                    if(!om) om = &matches[outline];
+                    om->notes[note].description += c;
                 }
             }
         }
-        if(matches) {
-            oScore += 10.*matches;
+    }
+}
+
+void AiAaWeightedFts::assessMatches(const unordered_map<Outline*,OutlineMatches>& outlineMatches, vector<pair<Note*,float>>* result)
+{
+    for(auto& om:outlineMatches) {
+        Outline* outline = om.first;
+
+        // O matches
+        float oScore = om.second.outline.title;
+        if(om.second.outline.description) {
+            oScore += 10.*om.second.outline.description;
             result->push_back(std::make_pair(outline->getOutlineDescriptorAsNote(),oScore));
         }
 
         // O's score will contribute to N's score as a bonus > normalize it
-        //MF_DEBUG(" AA.FTS O>N '" << outline->getName() << "' ~ " << oScore << endl);
         oScore /= 10.;
 
-        // O's N matches
+        // O's N matches (all O's Ns get the bonus)
         float nScore = 0;
         for(Note* note:outline->getNotes()) {
             nScore = oScore;
@@ -225,37 +331,210 @@ void AiAaWeightedFts::assessNotesInOutline(Outline* outline, vector<pair<Note*,f
             if(mind.getScopeAspect().isOutOfScope(note)) {
                 continue;
             }
-            // N.title matches
-            s.clear();
-            stringToLower(note->getName(), s);
-            for(auto& regexp:regexps) {
-                if(s.find(regexp)!=string::npos) {
-                    nScore += 100.;
-                }
-            }
-            // N.description matches
-            float matches=0.;
-            for(string* d:note->getDescription()) {
-                if(d) {
-                    s.clear();
-                    stringToLower(*d, s);
-                    for(auto& regexp:regexps) {
-                        // find them all
-                        size_t m = s.find(regexp, 0);
-                        while(m != string::npos) {
-                            matches++;
-                            m = s.find(regexp,m+1);
-                        }
-                    }
-                }
+            float matches = 0.;
+            auto nm = om.second.notes.find(note);
+            if(nm != om.second.notes.end()) {
+                nScore += nm->second.title;
+                matches = nm->second.description;
             }
             if(nScore || matches) {
                 nScore += 10.*matches;
                 result->push_back(std::make_pair(note,nScore));
-                //MF_DEBUG(" AA.FTS > N '" << note->getName() << "' ~ " << nScore << endl);
             }
         }
-    } // IMPROVE case sensitive version is NOT needed - was removed - see FTS search
+    }
+}
+
+/*
+ * Postings
+ */
+
+void AiAaWeightedFts::remember(Outline* outline)
+{
+    enqueueOutline(outline, false);
+}
+
+void AiAaWeightedFts::forget(Outline* outline)
+{
+    enqueueOutline(outline, true);
+}
+
+void AiAaWeightedFts::enqueueOutline(Outline* outline, bool forgotten)
+{
+    // nothing indexed yet - the next query will index everything
+    if(indexed) {
+        lock_guard<mutex> criticalSection{pendingOutlinesMutex};
+        pendingOutlines.push_back(make_pair(outline, forgotten));
+    }
+}
+
+void AiAaWeightedFts::clearPostings()
+{
+    titlePostings.clear();
+    descriptionPostings.clear();
+    outlineWords.clear();
+    termCache.clear();
+    indexed = false;
+    lock_guard<mutex> criticalSection{pendingOutlinesMutex};
+    pendingOutlines.clear();
+}
+
+void AiAaWeightedFts::updatePostings()
+{
+    if(!indexed) {
+#ifdef DO_MF_DEBUG
+        auto begin = chrono::high_resolution_clock::now();
+#endif
+        clearPostings();
+        // Os changed while memory is indexed are recorded and reindexed by the next query
+        indexed = true;
+        for(Outline* o:memory.getOutlines()) {
+            indexOutline(o);
+        }
+#ifdef DO_MF_DEBUG
+        auto end = chrono::high_resolution_clock::now();
+        MF_DEBUG("AA.FTS postings of " << titlePostings.size()+descriptionPostings.size() << " words built in " << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0 << "ms" << endl);
+#endif
+    } else {
+        vector<pair<Outline*,bool>> pending{};
+        {
+            lock_guard<mutex> criticalSection{pendingOutlinesMutex};
+            pending.swap(pendingOutlines);
+        }
+        // the last change of O wins - forgotten O must NOT be dereferenced
+        unordered_set<const Outline*> seen{};
+        for(auto o=pending.rbegin(); o!=pending.rend(); ++o) {
+            if(seen.insert(o->first).second) {
+                removeOutline(o->first);
+                if(!o->second) {
+                    indexOutline(o->first);
+                }
+            }
+        }
+    }
+}
+
+void AiAaWeightedFts::indexText(const string& text, Note* note, Outline* outline, Postings& postings, bool isTitle, vector<string>& words)
+{
+    string s{};
+    stringToLower(text, s);
+    vector<string> textWords{};
+    splitToWords(s, textWords);
+    for(string& w:textWords) {
+        vector<Posting>& p = postings[w];
+        // description is indexed line by line - the last posting might be this text's one
+        if(p.size() && p.back().note == note && p.back().outline == outline) {
+            if(!isTitle) p.back().count++;
+        } else {
+            p.push_back(Posting{note, outline, 1});
+            words.push_back(w);
+        }
+    }
+}
+
+void AiAaWeightedFts::indexOutline(Outline* outline)
+{
+    vector<string>& words = outlineWords[outline];
+    indexText(outline->getName(), nullptr, outline, titlePostings, true, words);
+    for(string* d:outline->getDescription()) {
+        if(d) indexText(*d, nullptr, outline, descriptionPostings, false, words);
+    }
+    for(Note* n:outline->getNotes()) {
+        indexText(n->getName(), n, outline, titlePostings, true, words);
+        for(string* d:n->getDescription()) {
+            if(d) indexText(*d, n, outline, descriptionPostings, false, words);
+        }
+    }
+    termCache.clear();
+}
+
+void AiAaWeightedFts::removeOutline(const Outline* outline)
+{
+    auto o = outlineWords.find(outline);
+    if(o == outlineWords.end()) {
+        return;
+    }
+    for(const string& w:o->second) {
+        for(Postings* postings:{&titlePostings, &descriptionPostings}) {
+            auto p = postings->find(w);
+            if(p != postings->end()) {
+                p->second.erase(
+                    std::remove_if(p->second.begin(), p->second.end(), [outline](const Posting& e) { return e.outline == outline; }),
+                    p->second.end());
+                if(p->second.empty()) {
+                    postings->erase(p);
+                }
+            }
+        }
+    }
+    outlineWords.erase(o);
+    termCache.clear();
+}
+
+void AiAaWeightedFts::prunePostings()
+{
+    // Ns deleted from Os w/o notification must not be returned
+    unordered_set<const Note*> alive{notes.begin(), notes.end()};
+    for(Postings* postings:{&titlePostings, &descriptionPostings}) {
+        for(auto p=postings->begin(); p!=postings->end(); ) {
+            p->second.erase(
+                std::remove_if(p->second.begin(), p->second.end(), [&alive](const Posting& e) { return e.note && !alive.count(e.note); }),
+                p->second.end());
+            if(p->second.empty()) {
+                p = postings->erase(p);
+            } else {
+                ++p;
+            }
+        }
+    }
+    termCache.clear();
+}
+
+const AiAaWeightedFts::TermWords& AiAaWeightedFts::getTermWords(const string& term)
+{
+    auto t = termCache.find(term);
+    if(t != termCache.end()) {
+        return t->second;
+    }
+
+    if(termCache.size() >= TERM_CACHE_MAX_SIZE) {
+        termCache.clear();
+    }
+    TermWords& termWords = termCache[term];
+    // scan of vocabulary (distinct words) is much cheaper than scan of all texts
+    for(const Postings::value_type& w:titlePostings) {
+        if(w.first.find(term) != string::npos) termWords.titles.push_back(&w);
+    }
+    for(const Postings::value_type& w:descriptionPostings) {
+        if(w.first.find(term) != string::npos) termWords.descriptions.push_back(&w);
+    }
+    return termWords;
+}
+
+void AiAaWeightedFts::splitToWords(const string& s, vector<string>& words)
+{
+    size_t b = 0;
+    while(b < s.size()) {
+        while(b < s.size() && !isWordChar(s[b])) b++;
+        size_t e = b;
+        while(e < s.size() && isWordChar(s[e])) e++;
+        if(e > b) {
+            words.push_back(s.substr(b, e-b));
+        }
+        b = e;
+    }
+}
+
+size_t AiAaWeightedFts::countOccurrences(const string& s, const string& term)
+{
+    size_t count = 0;
+    // find all matches (term matched more than once)
+    size_t m = s.find(term, 0);
+    while(m != string::npos) {
+        count++;
+        m = s.find(term,m+1);
+    }
+    return count;
 }
 
 std::shared_future<bool> AiAaWeightedFts::getAssociatedNotes(
@@ -277,6 +556,9 @@ std::shared_future<bool> AiAaWeightedFts::getAssociatedNotes(
     auto begin = chrono::high_resolution_clock::now();
 #endif
 
+    // postings are accessed exclusively for the whole query
+    lock_guard<mutex> criticalSection{postingsMutex};
+
     // Ns mut be refreshed from Mind to consider O/N deletes and scope changes
     refreshNotes(true);
 
@@ -19,9 +19,15 @@
 #ifndef M8R_AI_ASSOCIATIONS_ASSESSMENT_WEIGHTED_FTS_H
 #define M8R_AI_ASSOCIATIONS_ASSESSMENT_WEIGHTED_FTS_H
 
+#include <atomic>
+#include <cctype>
+#include <cstdint>
 #include <future>
+#include <mutex>
 #include <vector>
 #include <map>
+#include <unordered_map>
+#include <unordered_set>
 
 #include "ai_aa.h"
 #include "../mind.h"
@@ -39,6 +45,14 @@ class Mind;
  * Description:
  * - This method has own FTS implementation to compute weights and leverage O/N relationships
  *   while searching the best result.
+ * - Os/Ns are not scanned by queries: postings of words (lowercase maximal sequences of word
+ *   characters) found in O/N titles and descriptions are kept. Query term w/o delimiters is
+ *   resolved to all words which contain it (substring matching like scan), term w/ delimiters
+ *   (phrase) is searched just in Os whose texts contain all its words. Postings are updated
+ *   incrementally as Os are remembered/forgotten (and pruned on Mind delete watermark change).
+ * - Os are remembered/forgotten by GUI thread while queries may run in other threads (think
+ *   as you write) - changes are just recorded and applied by the next query, postings are
+ *   accessed exclusively by queries.
  * - IMPROVE this class is designed to run SYNCHRONOUSLY - for ASYNC modus operandi Mind/AI/this class
  *   cooperation and synchronization protocols must be architected.
  */
@@ -52,11 +66,51 @@ private:
     Memory& memory;
     CommonWordsBlacklist commonWords;
 
+    static constexpr size_t TERM_CACHE_MAX_SIZE = 1000;
+
+    struct Posting {
+        // nullptr ~ O itself (title/description of O)
+        Note* note;
+        Outline* outline;
+        // occurrences of word in description (1 for title)
+        std::uint32_t count;
+    };
+    typedef std::unordered_map<std::string,std::vector<Posting>> Postings;
+
+    // words which contain query term - valid until postings change
+    struct TermWords {
+        std::vector<const Postings::value_type*> titles;
+        std::vector<const Postings::value_type*> descriptions;
+    };
+
+    // query term matches of O and its Ns
+    struct Matches {
+        float title;
+        float description;
+    };
+    struct OutlineMatches {
+        Matches outline;
+        std::unordered_map<Note*,Matches> notes;
+    };
+
     std::vector<Note*> notes;
 
     // IMPROVE in addition to watermark also scope change should be tracked ~ mind.scopeWatermark
     int lastMindDeleteWatermark;
 
+    // Ns, postings and term cache are accessed exclusively
+    mutable std::mutex postingsMutex;
+    Postings titlePostings;
+    Postings descriptionPostings;
+    // O > words contributed to postings by O and its Ns (O is removed w/o dereferencing its Ns)
+    std::unordered_map<const Outline*,std::vector<std::string>> outlineWords;
+    std::atomic<bool> indexed;
+    std::unordered_map<std::string,TermWords> termCache;
+
+    // Os remembered/forgotten (flag is true for forgotten O) since the last query - applied by the next query
+    std::vector<std::pair<Outline*,bool>> pendingOutlines;
+    std::mutex pendingOutlinesMutex;
+
 public:
     explicit AiAaWeightedFts(Memory& memory, Mind& mind);
     AiAaWeightedFts(const AiAaWeightedFts&) = delete;
@@ -81,11 +135,21 @@ public:
 
     virtual std::shared_future<bool> getAssociatedNotes(const std::string& words, std::vector<std::pair<Note*,float>>& associations, const Note* self);
 
+    virtual void remember(Outline* outline);
+    virtual void forget(Outline* outline);
+
     virtual bool sleep() {
+        std::lock_guard<std::mutex> criticalSection{postingsMutex};
         notes.clear();
+        clearPostings();
         return true;
     }
 
+    size_t getPostingsWordsCount() const {
+        std::lock_guard<std::mutex> criticalSection{postingsMutex};
+        return titlePostings.size() + descriptionPostings.size();
+    }
+
     virtual bool amnesia() {
         return sleep();
     }
@@ -97,10 +161,37 @@ private:
     std::shared_future<bool> getAssociatedNotes(const std::string& words, std::vector<std::pair<Note*,float>>& associations, Outline* self);
 
     // getAssociatedNotes(){assessNs,leaderboard}
-    //   -> assessNsWithFallback(){2lowercase,iterateOs,fallback}
-    //     -> assessNs@O()
+    //   -> assessNsWithFallback(){2lowercase,postings,fallback}
+    //     -> assessTerm@postings() -> assessMatches()
     std::vector<std::pair<Note*,float>>* assessNotesWithFallback(const std::string& regexp, Outline* scope, const Note* self);
-    void assessNotesInOutline(Outline* outline, std::vector<std::pair<Note*,float>>* result, std::vector<std::string>& regexp, const bool ignoreCase);
+    void assessTerm(const std::string& term, Outline* scope, std::unordered_map<Outline*,OutlineMatches>& matches);
+    void assessTermInOutline(const std::string& term, Outline* outline, std::unordered_map<Outline*,OutlineMatches>& matches);
+    void assessMatches(const std::unordered_map<Outline*,OutlineMatches>& outlineMatches, std::vector<std::pair<Note*,float>>* result);
+
+    /*
+     * Postings (caller must hold postings mutex)
+     */
+
+    void enqueueOutline(Outline* outline, bool forgotten);
+    void updatePostings();
+    void clearPostings();
+    void indexOutline(Outline* outline);
+    void indexText(const std::string& text, Note* note, Outline* outline, Postings& postings, bool isTitle, std::vector<std::string>& words);
+    void removeOutline(const Outline* outline);
+    void prunePostings();
+    const TermWords& getTermWords(const std::string& term);
+
+    static bool isWordChar(char c) {
+        return static_cast<unsigned char>(c) >= 128 || std::isalnum(static_cast<unsigned char>(c));
+    }
+    /**
+     * @brief Split lowercase text to words i.e. maximal sequences of word characters.
+     */
+    static void splitToWords(const std::string& s, std::vector<std::string>& words);
+    /**
+     * @brief Count (overlapping) occurrences of term in string.
+     */
+    static size_t countOccurrences(const std::string& s, const std::string& term);
 };
 
 }
@@ -0,0 +1,112 @@
+/*
+ ai_near_duplicates.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "ai_near_duplicates.h"
+
+namespace m8r {
+
+using namespace std;
+
+constexpr float AiNearDuplicates::DEFAULT_THRESHOLD;
+constexpr size_t AiNearDuplicates::BLOCKS_PER_THREAD;
+
+AiNearDuplicates::AiNearDuplicates()
+    : wordBlacklist{},
+      minHash{}
+{
+}
+
+AiNearDuplicates::~AiNearDuplicates()
+{
+}
+
+void AiNearDuplicates::findNearDuplicates(const vector<string>& descriptions, vector<vector<size_t>>& clusters, float threshold)
+{
+    MF_DEBUG("AI: looking for near-duplicates of " << descriptions.size() << " Ns..." << endl);
+    clusters.clear();
+
+    // signatures are written to disjoint ranges by blocks
+    vector<uint32_t> signatures(descriptions.size()*MinHash::SIGNATURE_SIZE);
+    vector<uint8_t> signedNotes(descriptions.size(), 0);
+
+    size_t threads = Configuration::getInstance().getAiThreads();
+    WorkStealingPool pool{threads?threads:WorkStealingPool::getCpuCoresCount()};
+    const size_t blockSize = descriptions.size()/(pool.getSize()*BLOCKS_PER_THREAD)+1;
+    vector<WorkStealingPool::Task> tasks{};
+    for(size_t from=0; from<descriptions.size(); from+=blockSize) {
+        size_t to = std::min(from+blockSize, descriptions.size());
+        tasks.push_back([this,&descriptions,from,to,&signatures,&signedNotes]() {
+            sign(descriptions, from, to, signatures, signedNotes);
+        });
+    }
+    pool.run(tasks);
+
+    // compact signatures of signed Ns
+    vector<size_t> signedNotesIndex{};
+    size_t compacted = 0;
+    for(size_t i=0; i<descriptions.size(); i++) {
+        if(signedNotes[i]) {
+            if(compacted != i) {
+                std::copy(
+                    signatures.begin()+i*MinHash::SIGNATURE_SIZE,
+                    signatures.begin()+(i+1)*MinHash::SIGNATURE_SIZE,
+                    signatures.begin()+compacted*MinHash::SIGNATURE_SIZE);
+            }
+            signedNotesIndex.push_back(i);
+            compacted++;
+        }
+    }
+    signatures.resize(compacted*MinHash::SIGNATURE_SIZE);
+
+    MinHash::cluster(signatures, threshold, clusters);
+    for(vector<size_t>& cluster:clusters) {
+        for(size_t& i:cluster) {
+            i = signedNotesIndex[i];
+        }
+    }
+    MF_DEBUG("AI: found " << clusters.size() << " clusters of near-duplicates" << endl);
+}
+
+void AiNearDuplicates::sign(
+        const vector<string>& descriptions,
+        size_t from,
+        size_t to,
+        vector<uint32_t>& signatures,
+        vector<uint8_t>& signedNotes)
+{
+    // word IDs are private to the block, but word hashes are the same in all lexicons
+    Lexicon lexicon{};
+    MarkdownTokenizer tokenizer{lexicon, wordBlacklist};
+    tokenizer.setStemmerLanguage(Stemmer::toLanguage(Configuration::getInstance().getAiStemmerLanguage()));
+
+    vector<uint32_t> ids{};
+    vector<uint32_t> words{};
+    for(size_t i=from; i<to; i++) {
+        ids.clear();
+        const string& description = descriptions[i];
+        tokenizer.tokenize(description.data(), description.data()+description.size(), ids);
+
+        words.clear();
+        for(uint32_t id:ids) {
+            words.push_back(lexicon.getHash(id));
+        }
+        signedNotes[i] = minHash.sign(words, signatures.data()+i*MinHash::SIGNATURE_SIZE);
+    }
+}
+
+} // m8r namespace
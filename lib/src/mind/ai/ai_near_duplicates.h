@@ -0,0 +1,92 @@
+/*
+ ai_near_duplicates.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_AI_NEAR_DUPLICATES_H
+#define M8R_AI_NEAR_DUPLICATES_H
+
+#include <algorithm>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../../debug.h"
+#include "../../config/configuration.h"
+#include "../../model/note.h"
+#include "./nlp/min_hash.h"
+#include "./nlp/markdown_tokenizer.h"
+#include "./nlp/common_words_blacklist.h"
+#include "../../gear/work_stealing_pool.h"
+
+namespace m8r {
+
+/**
+ * @brief Near-duplicate Ns detection (e.g. Ns imported more times).
+ *
+ * N description is tokenized (stemmed, common words removed) and MinHash
+ * signature of its word shingles is calculated - tokenization and signing
+ * run in parallel on AI threads. Signatures are clustered by LSH, therefore
+ * unlike pairwise AA the detection is (near) linear in the number of Ns.
+ *
+ * Ns w/ description shorter than a shingle are skipped.
+ */
+class AiNearDuplicates
+{
+public:
+    // Jaccard similarity of description shingles
+    static constexpr float DEFAULT_THRESHOLD = 0.8;
+
+private:
+    static constexpr size_t BLOCKS_PER_THREAD = 4;
+
+    CommonWordsBlacklist wordBlacklist;
+    MinHash minHash;
+
+public:
+    explicit AiNearDuplicates();
+    AiNearDuplicates(const AiNearDuplicates&) = delete;
+    AiNearDuplicates(const AiNearDuplicates&&) = delete;
+    AiNearDuplicates &operator=(const AiNearDuplicates&) = delete;
+    AiNearDuplicates &operator=(const AiNearDuplicates&&) = delete;
+    ~AiNearDuplicates();
+
+    /**
+     * @brief Find clusters of near-duplicate Ns given by (copies of) their descriptions.
+     *
+     * Clusters of description indices are ordered by size (the biggest first),
+     * indices in cluster are ascending. Descriptions are copies, therefore Ns
+     * don't have to be locked while they are signed and clustered.
+     */
+    void findNearDuplicates(
+            const std::vector<std::string>& descriptions,
+            std::vector<std::vector<size_t>>& clusters,
+            float threshold=DEFAULT_THRESHOLD);
+
+private:
+    /**
+     * @brief Sign descriptions [from, to) - tokenizer is not shared among threads.
+     */
+    void sign(
+            const std::vector<std::string>& descriptions,
+            size_t from,
+            size_t to,
+            std::vector<std::uint32_t>& signatures,
+            std::vector<std::uint8_t>& signedNotes);
+};
+
+}
+#endif // M8R_AI_NEAR_DUPLICATES_H
@@ -78,6 +78,19 @@ public:
         return bow[t];
     }
 
+    /**
+     * @brief Remove (and delete) document's word frequency list.
+     *
+     * Document is not dereferenced i.e. it might be already deleted.
+     */
+    void remove(Thing* t) {
+        auto i = bow.find(t);
+        if(i != bow.end()) {
+            delete i->second;
+            bow.erase(i);
+        }
+    }
+
     void reorderDocVectorsByWeight();
 
 #ifdef DO_MF_DEBUG
@@ -20,14 +20,70 @@
 
 namespace m8r {
 
+using namespace std;
+
+constexpr uint32_t Lexicon::NO_WORD;
+constexpr uint32_t Lexicon::EMPTY_SLOT;
+
 Lexicon::Lexicon()
 {
     // inaccurate, but until the 1st word is added ;)
     maxFrequency = 1;
+    slots.assign(INITIAL_CAPACITY, EMPTY_SLOT);
 }
 
 Lexicon::~Lexicon()
 {
 }
 
+void Lexicon::clear()
+{
+    words.clear();
+    hashes.clear();
+    frequencies.clear();
+    weights.clear();
+    slots.assign(INITIAL_CAPACITY, EMPTY_SLOT);
+    maxFrequency = 1;
+}
+
+uint32_t Lexicon::add(const string& word, int occurrences)
+{
+    const uint32_t hash = hashWord(word);
+    size_t mask = slots.size()-1;
+    size_t i;
+    for(i=hash&mask; slots[i]!=EMPTY_SLOT; i=(i+1)&mask) {
+        uint32_t id = slots[i]-1;
+        if(hashes[id]==hash && words[id]==word) {
+            frequencies[id] += occurrences;
+            if(frequencies[id]>maxFrequency) maxFrequency=frequencies[id];
+            return id;
+        }
+    }
+
+    uint32_t id = static_cast<uint32_t>(words.size());
+    words.push_back(word);
+    hashes.push_back(hash);
+    frequencies.push_back(occurrences);
+    if(occurrences>maxFrequency) maxFrequency=occurrences;
+    weights.push_back(0.);
+    slots[i] = id+1;
+
+    // keep load factor <= 1/2
+    if(words.size()*2 > slots.size()) {
+        rehash(slots.size()*2);
+    }
+    return id;
+}
+
+void Lexicon::rehash(size_t capacity)
+{
+    slots.assign(capacity, EMPTY_SLOT);
+    const size_t mask = capacity-1;
+    for(uint32_t id=0; id<hashes.size(); id++) {
+        size_t i;
+        for(i=hashes[id]&mask; slots[i]!=EMPTY_SLOT; i=(i+1)&mask);
+        slots[i] = id+1;
+    }
+}
+
 } // m8r namespace
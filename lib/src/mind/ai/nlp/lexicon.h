@@ -19,7 +19,8 @@
 #ifndef M8R_LEXICON_H
 #define M8R_LEXICON_H
 
-#include <map>
+#include <cstdint>
+#include <deque>
 #include <vector>
 #include <string>
 
@@ -38,39 +39,32 @@ namespace m8r {
  * Lexicon is the *only* data structure in MF's AI that keeps words by *value*.
  * Other data structures use either pointers or references to be memory efficient.
  *
+ * Words are interned: each word gets a dense ID (order of word addition) and
+ * its frequency and weight are stored in arrays indexed by the ID. Words are
+ * found using open addressing hash table (linear probing) of IDs, therefore
+ * word addition/lookup costs O(1) instead of O(log(n)) string comparisons.
+ * Word strings are stored in an arena which never moves them i.e. pointers
+ * to words (used by WordFrequencyList) are stable.
  */
 // IMPROVE Stanford GloVe lexicon w/ word attributes & semantic domains (configure > check existence > use OR skip)
 class Lexicon
 {
 public:
-
-    struct WordEmbedding {
-        // IMPROVE consider use of ptr to map's key
-        std::string word;
-        int frequency;
-        float weight;
-
-        explicit WordEmbedding() {
-            frequency = 0;
-            weight = 0.;
-        }
-        explicit WordEmbedding(const std::string& ww, int f, float w) {
-            word = ww;
-            frequency = f;
-            weight = w;
-        }
-    };
-
+    static constexpr std::uint32_t NO_WORD = UINT32_MAX;
 
 private:
-    // map of word-to-frequency pairs for fast lookup and duplicity detection
-    // IMPROVE C++ SL uses map's comparator for string to do comparisons - thefore insert
-    //         complexity is O(log(n)) string comparisons. Consider TRIE data structure
-    //         instead.
-    std::map<std::string,WordEmbedding> m;
+    static constexpr std::uint32_t EMPTY_SLOT = 0;
+    static constexpr size_t INITIAL_CAPACITY = 1024;
+
+    // ID > word
+    std::deque<std::string> words;
+    // ID > word hash/frequency/weight
+    std::vector<std::uint32_t> hashes;
+    std::vector<int> frequencies;
+    std::vector<float> weights;
 
-    // sorted/ordered words by weight/frequency/... referencing/pointing to map
-    //std::vector<WordEmbedding*> words;
+    // hash table of ID+1 (0 ~ empty slot), capacity is power of 2
+    std::vector<std::uint32_t> slots;
 
     // keeping max word frequency for efficient weighs calculation
     int maxFrequency;
@@ -83,38 +77,52 @@ public:
     Lexicon &operator=(const Lexicon&&) = delete;
     ~Lexicon();
 
-    size_t size() const { return m.size(); }
-    void clear() { m.clear(); }
-    const std::map<std::string,WordEmbedding>& get() const { return m; }
+    size_t size() const { return words.size(); }
+    void clear();
 
-    WordEmbedding* get(const std::string& word) {
-        std::map<std::string,WordEmbedding>::iterator i = m.find(word);
-        if(i != m.end()) {
-            return &i->second;
-        } else {
-            return nullptr;
+    /**
+     * @brief Get word ID or NO_WORD.
+     */
+    std::uint32_t getId(const std::string& word) const {
+        const std::uint32_t hash = hashWord(word);
+        const size_t mask = slots.size()-1;
+        for(size_t i=hash&mask; slots[i]!=EMPTY_SLOT; i=(i+1)&mask) {
+            std::uint32_t id = slots[i]-1;
+            if(hashes[id]==hash && words[id]==word) {
+                return id;
+            }
         }
+        return NO_WORD;
     }
-    WordEmbedding* get(const std::string* word) {
-        return get(*word);
+    std::uint32_t getId(const std::string* word) const {
+        return getId(*word);
     }
 
-    WordEmbedding* add(const std::string& word) {
-        WordEmbedding* result;
-        if((result=get(word)) != nullptr) {
-            ++result->frequency;
-            if(result->frequency>maxFrequency) maxFrequency=result->frequency;
-            return result;
-        } else {
-            WordEmbedding we{word,1,0};
-            m[word] = we;
-            return &(m[word]);
-        }
+    /**
+     * @brief Add word (occurence(s)) and get its ID.
+     */
+    std::uint32_t add(const std::string& word, int occurrences=1);
+    std::uint32_t add(const std::string* word, int occurrences=1) {
+        return add(*word, occurrences);
     }
-    WordEmbedding* add(const std::string* word) {
-        return add(*word);
+
+    /**
+     * @brief Remove word occurence(s) e.g. when a document is forgotten.
+     *
+     * Word keeps its ID (IDs are dense and referenced by other data structures),
+     * just its frequency is decreased.
+     */
+    void remove(std::uint32_t id, int occurrences=1) {
+        frequencies[id] = occurrences<frequencies[id] ? frequencies[id]-occurrences : 0;
     }
 
+    const std::string& getWord(std::uint32_t id) const { return words[id]; }
+    // word hash doesn't depend on ID i.e. it's the same in all lexicons
+    std::uint32_t getHash(std::uint32_t id) const { return hashes[id]; }
+    int getFrequency(std::uint32_t id) const { return frequencies[id]; }
+    float getWeight(std::uint32_t id) const { return weights[id]; }
+    void setWeight(std::uint32_t id, float weight) { weights[id] = weight; }
+
     /**
      * @brief Recalculate word weights.
      *
@@ -130,23 +138,43 @@ public:
      *
      */
     void recalculateWeights() {
-        for(auto& e:m) {
-            e.second.weight =  1. - ((((float)e.second.frequency)/100.) / (((float)maxFrequency)/100.));
+        // frequencies might have been decreased
+        maxFrequency = 1;
+        for(int frequency:frequencies) {
+            if(frequency>maxFrequency) maxFrequency=frequency;
+        }
+        for(size_t id=0; id<weights.size(); id++) {
+            weights[id] =  1. - ((((float)frequencies[id])/100.) / (((float)maxFrequency)/100.));
 
             // IMPROVE fixed constant is eight too big or small
             // ensure max(w)'s weigh to be > 0
-            if(!e.second.weight) e.second.weight = 0.01;
+            if(!weights[id]) weights[id] = 0.01;
         }
     }
 
 #ifdef DO_MF_DEBUG
     void print() const {
-        MF_DEBUG("Lexicon[" << m.size() << "]:" << std::endl);
-        for(auto& e:m) {
-            MF_DEBUG("  " << e.second.word << "  " << e.second.frequency << "  " << e.second.weight << std::endl);
+        MF_DEBUG("Lexicon[" << words.size() << "]:" << std::endl);
+        for(size_t id=0; id<words.size(); id++) {
+            MF_DEBUG("  " << words[id] << "  " << frequencies[id] << "  " << weights[id] << std::endl);
         }
     }
 #endif
+
+    /**
+     * @brief FNV-1a hash.
+     */
+    static std::uint32_t hashWord(const std::string& word) {
+        std::uint32_t hash = 2166136261u;
+        for(unsigned char c:word) {
+            hash ^= c;
+            hash *= 16777619u;
+        }
+        return hash;
+    }
+
+private:
+    void rehash(size_t capacity);
 };
 
 }
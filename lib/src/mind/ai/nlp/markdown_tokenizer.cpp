@@ -23,7 +23,7 @@ namespace m8r {
 using namespace std;
 
 MarkdownTokenizer::MarkdownTokenizer(Lexicon& lexicon, CommonWordsBlacklist& blacklist)
-    : lexicon(lexicon), blacklist(blacklist), stemmer{}
+    : lexicon(lexicon), blacklist(blacklist), stemmer{}, word{}, buffer{}
 {
 }
 
@@ -31,122 +31,95 @@ MarkdownTokenizer::~MarkdownTokenizer()
 {
 }
 
-void MarkdownTokenizer::tokenize(CharProvider& md, WordFrequencyList& wfl, bool useBlacklist, bool lowercase, bool stem)
+const MarkdownTokenizer::CharClasses& MarkdownTokenizer::getCharClasses()
+{
+    // initialized on the first use (thread safe since C++11)
+    static const CharClasses classes{};
+    return classes;
+}
+
+MarkdownTokenizer::CharClasses::CharClasses()
 {
-    // tokenize relationships
-    bool parseRels=false;
-    vector<pair<string,string>> links{};
-    bool inRelLabel=false;
-    bool inRelLink=false;
+    for(int c=0; c<256; c++) {
+        if(c>=128) {
+            // skip HIGH Unicode chars
+            type[c] = CHAR_DELIMITER;
+        } else {
+            type[c] = CHAR_WORD;
+        }
+        lowercase[c] = static_cast<char>(c>='A' && c<='Z' ? c+('a'-'A') : c);
+    }
 
-    string w{}, link{};
+    const char* delimiters = "\n\r \t!?.,:;#=`()[]*_\"'~@$%^&+{}|\\<>/";
+    for(const char* d=delimiters; *d; d++) {
+        type[static_cast<unsigned char>(*d)] = CHAR_DELIMITER;
+    }
+    type[static_cast<unsigned char>('-')] = CHAR_HYPHEN;
+}
+
+void MarkdownTokenizer::tokenize(CharProvider& md, WordFrequencyList& wfl, bool useBlacklist, bool lowercase, bool stem)
+{
+    // narrow the stream to a contiguous span (buffer capacity is reused)
+    buffer.clear();
     while(md.hasNext()) {
-        const char c = md.next();
+        buffer += md.next();
+    }
+    tokenize(buffer.data(), buffer.data()+buffer.size(), wfl, useBlacklist, lowercase, stem);
 
-        // parse relationships/image links
-        if(parseRels) {
-            if(inRelLabel||inRelLink) {
-                link += (md.get());
-            } else {
-                if(link.size()) link.clear();
-            }
+    lexicon.recalculateWeights();
+}
 
-            switch(c) {
-            case '\n':
-            case '\r':
-                inRelLabel=inRelLink=false;
-                break;
-            case '[':
-                inRelLabel=true;
-                break;
-            case ']':
-                if(inRelLabel && md.hasNext() && md.getLookahead()=='(') {
-                    inRelLabel=false;
-                    inRelLink=true;
-                } else {
-                    inRelLabel=false;
-                }
-                break;
-            case ')':
-                if(inRelLink) {
-                    // relationship successfully parsed
-                    size_t pos = link.find("](");
-                    links.push_back(std::make_pair(link.substr(0, pos),link.substr(pos+2,link.size()-pos-3)));
-                    MF_DEBUG("  Parsed link: " << links[links.size()-1].first << " / " << links[links.size()-1].second << endl);
-                    inRelLink = false;
-                    link.clear();
-                }
-                break;
-            default:
-                ;
-            }
+void MarkdownTokenizer::tokenize(const Note* note, WordFrequencyList& wfl, bool useBlacklist, bool lowercase, bool stem)
+{
+    const string& name = note->getName();
+    tokenize(name.data(), name.data()+name.size(), wfl, useBlacklist, lowercase, stem);
+    // description lines are tokenized in place - no N narrowing to a string
+    for(const string* line:note->getDescription()) {
+        if(line) {
+            tokenize(line->data(), line->data()+line->size(), wfl, useBlacklist, lowercase, stem);
         }
+    }
+}
 
-        // tokenize text
-        switch(c) {
-        case '-':
+void MarkdownTokenizer::tokenize(const char* begin, const char* end, WordFrequencyList& wfl, bool useBlacklist, bool lowercase, bool stem)
+{
+    tokenize(begin, end, &wfl, nullptr, useBlacklist, lowercase, stem);
+}
+
+void MarkdownTokenizer::tokenize(const char* begin, const char* end, vector<uint32_t>& ids, bool useBlacklist, bool lowercase, bool stem)
+{
+    tokenize(begin, end, nullptr, &ids, useBlacklist, lowercase, stem);
+}
+
+void MarkdownTokenizer::tokenize(const char* begin, const char* end, WordFrequencyList* wfl, vector<uint32_t>* ids, bool useBlacklist, bool lowercase, bool stem)
+{
+    const CharClasses& classes = getCharClasses();
+    const char* chars = lowercase?classes.lowercase:nullptr;
+
+    word.clear();
+    for(const char* p=begin; p<end; p++) {
+        const unsigned char c = static_cast<unsigned char>(*p);
+        switch(classes.type[c]) {
+        case CHAR_WORD:
+            word += chars?chars[c]:*p;
+            break;
+        case CHAR_HYPHEN:
             // check lookahead to accept words like: self-awareness
-            if(md.hasNext() && md.getLookahead()!='-') {
-                w += md.get();
+            if(p+1<end && p[1]!='-') {
+                word += *p;
                 break;
             }
-        case '\n':
-        case '\r':
-        case ' ':
-        case '\t':
-        case '!':
-        case '?':
-        case '.':
-        case ',':
-        case ':':
-        case ';':
-        case '#':
-        case '=':
-        case '`':
-        case '(':
-        case ')':
-        case '[':
-        case ']':
-        case '*':
-        case '_':
-        case '"':
-        case '\'':
-        case '~':
-        case '@':
-        case '$':
-        case '%':
-        case '^':
-        case '&':
-        case '+':
-        case '{':
-        case '}':
-        case '|':
-        case '\\':
-        case '<':
-        case '>':
-        case '/':
-            handleWord(wfl, w, stem, useBlacklist);
-            break;
+            // fall through
         default:
-            if(md.get() < 0) {
-                // skip HIGH Unicode chars
-                handleWord(wfl, w, stem, useBlacklist);
-            } else {
-                if(lowercase) {
-                    w += tolower(md.get());
-                } else {
-                    w += md.get();
-                }
-            }
-
+            handleWord(wfl, ids, word, stem, useBlacklist);
             break;
         }
     }
-
-    lexicon.recalculateWeights();
+    // span end is a delimiter
+    handleWord(wfl, ids, word, stem, useBlacklist);
 }
 
-void MarkdownTokenizer::handleWord(WordFrequencyList& wfl, string &w, bool stem, bool useBlacklist)
+void MarkdownTokenizer::handleWord(WordFrequencyList* wfl, vector<uint32_t>* ids, string &w, bool stem, bool useBlacklist)
 {
     if(w.size()>1) {
         // stem
@@ -157,8 +130,12 @@ void MarkdownTokenizer::handleWord(WordFrequencyList& wfl, string &w, bool stem,
         // remove common words
         if(!useBlacklist || !blacklist.findWord(w)) {
             // increment token frequency
-            Lexicon::WordEmbedding* we = lexicon.add(w);
-            ++wfl[&(we->word)];
+            std::uint32_t id = lexicon.add(w);
+            if(wfl) {
+                ++(*wfl)[&lexicon.getWord(id)];
+            } else {
+                ids->push_back(id);
+            }
         }
     }
     w.clear();
@@ -166,52 +143,7 @@ void MarkdownTokenizer::handleWord(WordFrequencyList& wfl, string &w, bool stem,
 
 bool MarkdownTokenizer::isNonAlpha(char c)
 {
-    switch(c) {
-    case '-':
-    case '\n':
-    case '\r':
-    case ' ':
-    case '\t':
-    case '!':
-    case '?':
-    case '.':
-    case ',':
-    case ':':
-    case ';':
-    case '#':
-    case '=':
-    case '`':
-    case '(':
-    case ')':
-    case '[':
-    case ']':
-    case '*':
-    case '_':
-    case '"':
-    case '\'':
-    case '~':
-    case '@':
-    case '$':
-    case '%':
-    case '^':
-    case '&':
-    case '+':
-    case '{':
-    case '}':
-    case '|':
-    case '\\':
-    case '<':
-    case '>':
-    case '/':
-        return true;
-    default:
-        if(c<0) {
-            // high unicode
-            return true;
-        } else {
-            return false;
-        }
-    }
+    return getCharClasses().type[static_cast<unsigned char>(c)] != CHAR_WORD;
 }
 
 string MarkdownTokenizer::stripFrontBackNonAlpha(string s)
@@ -250,62 +182,25 @@ string MarkdownTokenizer::stripFrontBackNonAlpha(string s)
 
 string MarkdownTokenizer::stripNonAlpha(CharProvider& md)
 {
+    const CharClasses& classes = getCharClasses();
     string w{};
 
     while(md.hasNext()) {
-        const char c = md.next();
+        const unsigned char c = static_cast<unsigned char>(md.next());
 
-        // tokenize text
-        switch(c) {
-        case '-':
+        switch(classes.type[c]) {
+        case CHAR_WORD:
+            w += md.get();
+            break;
+        case CHAR_HYPHEN:
             // check lookahead to accept words like: self-awareness
             if(md.hasNext() && md.getLookahead()!='-') {
                 w += md.get();
                 break;
             }
-        case '\n':
-        case '\r':
-        case ' ':
-        case '\t':
-        case '!':
-        case '?':
-        case '.':
-        case ',':
-        case ':':
-        case ';':
-        case '#':
-        case '=':
-        case '`':
-        case '(':
-        case ')':
-        case '[':
-        case ']':
-        case '*':
-        case '_':
-        case '"':
-        case '\'':
-        case '~':
-        case '@':
-        case '$':
-        case '%':
-        case '^':
-        case '&':
-        case '+':
-        case '{':
-        case '}':
-        case '|':
-        case '\\':
-        case '<':
-        case '>':
-        case '/':
-            return w;
+            // fall through
         default:
-            if(md.get() < 0) {
-                return w;
-            } else {
-                w += md.get();
-            }
-            break;
+            return w;
         }
     }
 
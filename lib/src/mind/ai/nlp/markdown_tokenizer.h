@@ -24,6 +24,7 @@
 #include "../../../debug.h"
 #include "../../../gear/lang_utils.h"
 #include "../../../mind/ai/nlp/common_words_blacklist.h"
+#include "../../../model/note.h"
 #include "char_provider.h"
 #include "lexicon.h"
 #include "word_frequency_list.h"
@@ -36,7 +37,7 @@ namespace m8r {
  *
  * On tokenization:
  *
- *   - hardcoded delimiters
+ *   - hardcoded delimiters (256 entries character class table)
  *   - filters out words w/ length <1
  *   - stems words (optional)
  *   - computes token frequency via Lexicon
@@ -46,6 +47,20 @@ namespace m8r {
  */
 class MarkdownTokenizer
 {
+    enum CharClass : unsigned char {
+        CHAR_WORD,
+        CHAR_DELIMITER,
+        // - is delimiter unless it's followed by a word character e.g. self-awareness
+        CHAR_HYPHEN
+    };
+
+    struct CharClasses {
+        unsigned char type[256];
+        char lowercase[256];
+
+        explicit CharClasses();
+    };
+
     Lexicon& lexicon;
 
     /**
@@ -55,6 +70,10 @@ class MarkdownTokenizer
 
     Stemmer stemmer;
 
+    // reusable buffers (capacity is kept among tokenizations)
+    std::string word;
+    std::string buffer;
+
 public:
     explicit MarkdownTokenizer(Lexicon& lexicon, CommonWordsBlacklist& blacklist);
     MarkdownTokenizer(const MarkdownTokenizer&) = delete;
@@ -64,10 +83,39 @@ public:
     ~MarkdownTokenizer();
 
     /**
-     * @brief Tokenize a stream of characters.
+     * @brief Set language used to stem words (memoized stems are kept while language is the same).
+     */
+    void setStemmerLanguage(Stemmer::Language language) { stemmer.setLanguage(language); }
+    Stemmer::Language getStemmerLanguage() const { return stemmer.getLanguage(); }
+
+    /**
+     * @brief Tokenize a stream of characters and recalculate Lexicon weights.
      */
     void tokenize(CharProvider& md, WordFrequencyList& wfl, bool useBlacklist=true, bool lowercase=true, bool stem=true);
 
+    /**
+     * @brief Tokenize N name and description lines in place.
+     *
+     * Lexicon weights are NOT recalculated - call Lexicon::recalculateWeights()
+     * once all Ns are tokenized.
+     */
+    void tokenize(const Note* note, WordFrequencyList& wfl, bool useBlacklist=true, bool lowercase=true, bool stem=true);
+
+    /**
+     * @brief Tokenize contiguous span of characters [begin, end).
+     *
+     * Lexicon weights are NOT recalculated.
+     */
+    void tokenize(const char* begin, const char* end, WordFrequencyList& wfl, bool useBlacklist=true, bool lowercase=true, bool stem=true);
+
+    /**
+     * @brief Tokenize contiguous span of characters [begin, end) to Lexicon word IDs in order of occurence.
+     *
+     * IDs are appended to the vector (order is kept e.g. for shingling). Lexicon
+     * weights are NOT recalculated.
+     */
+    void tokenize(const char* begin, const char* end, std::vector<std::uint32_t>& ids, bool useBlacklist=true, bool lowercase=true, bool stem=true);
+
     /**
      * @brief Remove non-alpha numeric characters from the 1st word and return it.
      */
@@ -84,7 +132,11 @@ public:
     static bool isNonAlpha(char c);
 
 private:
-    inline void handleWord(WordFrequencyList& wfl, std::string &w, bool stem, bool useBlacklist);
+    static const CharClasses& getCharClasses();
+
+    // either word frequency list or word IDs sequence is filled
+    void tokenize(const char* begin, const char* end, WordFrequencyList* wfl, std::vector<std::uint32_t>* ids, bool useBlacklist, bool lowercase, bool stem);
+    inline void handleWord(WordFrequencyList* wfl, std::vector<std::uint32_t>* ids, std::string &w, bool stem, bool useBlacklist);
 };
 
 }
@@ -0,0 +1,158 @@
+/*
+ min_hash.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "min_hash.h"
+
+#include <algorithm>
+#include <numeric>
+#include <unordered_map>
+
+namespace m8r {
+
+using namespace std;
+
+constexpr size_t MinHash::SHINGLE_SIZE;
+constexpr size_t MinHash::BANDS;
+constexpr size_t MinHash::ROWS;
+constexpr size_t MinHash::SIGNATURE_SIZE;
+
+MinHash::MinHash(uint64_t seed)
+{
+    // hash functions are derived from the seed > signatures are comparable across runs
+    for(size_t i=0; i<SIGNATURE_SIZE; i++) {
+        multipliers[i] = mix(seed+2*i) | 1;
+        increments[i] = mix(seed+2*i+1);
+    }
+}
+
+MinHash::~MinHash()
+{
+}
+
+uint64_t MinHash::mix(uint64_t x)
+{
+    // splitmix64 finalizer
+    x += 0x9e3779b97f4a7c15ull;
+    x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+    x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+    return x ^ (x >> 31);
+}
+
+bool MinHash::sign(const vector<uint32_t>& words, uint32_t* signature) const
+{
+    if(words.size() < SHINGLE_SIZE) {
+        return false;
+    }
+
+    // shingles are deduplicated as signature is calculated from the set of shingles
+    vector<uint64_t> shingles{};
+    shingles.reserve(words.size()-SHINGLE_SIZE+1);
+    for(size_t i=0; i+SHINGLE_SIZE<=words.size(); i++) {
+        uint64_t shingle = 0;
+        for(size_t j=i; j<i+SHINGLE_SIZE; j++) {
+            shingle = mix(shingle ^ words[j]);
+        }
+        shingles.push_back(shingle);
+    }
+    std::sort(shingles.begin(), shingles.end());
+    shingles.erase(std::unique(shingles.begin(), shingles.end()), shingles.end());
+
+    std::fill(signature, signature+SIGNATURE_SIZE, UINT32_MAX);
+    for(uint64_t shingle:shingles) {
+        for(size_t i=0; i<SIGNATURE_SIZE; i++) {
+            uint32_t h = static_cast<uint32_t>((multipliers[i]*shingle+increments[i]) >> 32);
+            if(h < signature[i]) {
+                signature[i] = h;
+            }
+        }
+    }
+    return true;
+}
+
+float MinHash::similarity(const uint32_t* a, const uint32_t* b)
+{
+    size_t same = 0;
+    for(size_t i=0; i<SIGNATURE_SIZE; i++) {
+        if(a[i] == b[i]) {
+            same++;
+        }
+    }
+    return static_cast<float>(same)/SIGNATURE_SIZE;
+}
+
+void MinHash::cluster(const vector<uint32_t>& signatures, float threshold, vector<vector<size_t>>& clusters)
+{
+    clusters.clear();
+    const size_t count = signatures.size()/SIGNATURE_SIZE;
+
+    // union-find of documents
+    vector<size_t> parents(count);
+    std::iota(parents.begin(), parents.end(), 0);
+    auto find = [&parents](size_t d) {
+        while(parents[d] != d) {
+            parents[d] = parents[parents[d]];
+            d = parents[d];
+        }
+        return d;
+    };
+
+    // band hash > the first document w/ the band
+    unordered_map<uint64_t,size_t> buckets{};
+    buckets.reserve(count);
+    for(size_t b=0; b<BANDS; b++) {
+        buckets.clear();
+        for(size_t d=0; d<count; d++) {
+            const uint32_t* band = signatures.data()+d*SIGNATURE_SIZE+b*ROWS;
+            uint64_t key = b;
+            for(size_t r=0; r<ROWS; r++) {
+                key = mix(key ^ band[r]);
+            }
+
+            auto bucket = buckets.emplace(key, d);
+            if(!bucket.second) {
+                // candidate is verified against the 1st document in the bucket only (no quadratic
+                // bucket scan) - similar documents missed this way meet in other bands
+                size_t candidate = bucket.first->second;
+                size_t x = find(candidate), y = find(d);
+                if(x != y
+                     && similarity(signatures.data()+candidate*SIGNATURE_SIZE, signatures.data()+d*SIGNATURE_SIZE) >= threshold)
+                {
+                    parents[std::max(x,y)] = std::min(x,y);
+                }
+            }
+        }
+    }
+
+    unordered_map<size_t,size_t> roots{};
+    for(size_t d=0; d<count; d++) {
+        size_t root = find(d);
+        if(root != d) {
+            auto r = roots.emplace(root, clusters.size());
+            if(r.second) {
+                // root is the document w/ the lowest index in the cluster
+                clusters.push_back(vector<size_t>{root});
+            }
+            clusters[r.first->second].push_back(d);
+        }
+    }
+    std::stable_sort(clusters.begin(), clusters.end(), [](const vector<size_t>& a, const vector<size_t>& b) {
+        return a.size() > b.size();
+    });
+}
+
+} // m8r namespace
@@ -0,0 +1,91 @@
+/*
+ min_hash.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_MIN_HASH_H
+#define M8R_MIN_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace m8r {
+
+/**
+ * @brief MinHash signatures of word sequences and LSH banding of signatures.
+ *
+ * Document is represented by the set of its shingles (SHINGLE_SIZE consecutive
+ * words). MinHash signature is a vector of SIGNATURE_SIZE minimums of shingle
+ * hashes permuted by independent hash functions - the probability that two
+ * signatures agree in a component is the Jaccard similarity of shingle sets.
+ *
+ * Locality sensitive hashing (LSH) splits signatures to BANDS bands of ROWS rows
+ * and documents w/ an identical band become duplicate candidates. Documents w/
+ * Jaccard similarity s are candidates w/ probability 1-(1-s^ROWS)^BANDS i.e.
+ * 0.98 for s=0.8 and 0.06 for s=0.5. Each candidate pair is verified using
+ * signature similarity, therefore there is no all pairs comparison and
+ * clustering is (near) linear in the number of documents.
+ */
+class MinHash
+{
+public:
+    static constexpr size_t SHINGLE_SIZE = 3;
+    static constexpr size_t BANDS = 16;
+    static constexpr size_t ROWS = 8;
+    static constexpr size_t SIGNATURE_SIZE = BANDS*ROWS;
+
+private:
+    // multiply-shift hash functions: (a*x+b) >> 32 w/ odd a
+    std::uint64_t multipliers[SIGNATURE_SIZE];
+    std::uint64_t increments[SIGNATURE_SIZE];
+
+public:
+    explicit MinHash(std::uint64_t seed=0x6d696e64666f7267ull);
+    MinHash(const MinHash&) = delete;
+    MinHash(const MinHash&&) = delete;
+    MinHash &operator=(const MinHash&) = delete;
+    MinHash &operator=(const MinHash&&) = delete;
+    ~MinHash();
+
+    /**
+     * @brief Calculate signature of a sequence of word hashes.
+     *
+     * Signature must have SIGNATURE_SIZE components. False is returned (and
+     * signature is not calculated) if sequence is shorter than a shingle.
+     */
+    bool sign(const std::vector<std::uint32_t>& words, std::uint32_t* signature) const;
+
+    /**
+     * @brief Estimate Jaccard similarity of two documents from their signatures.
+     */
+    static float similarity(const std::uint32_t* a, const std::uint32_t* b);
+
+    /**
+     * @brief Cluster documents w/ similarity >= threshold.
+     *
+     * Signatures of documents are stored contiguously. Clusters w/ at least two
+     * documents are returned ordered by size (the biggest first), documents in
+     * cluster are ordered by index.
+     */
+    static void cluster(const std::vector<std::uint32_t>& signatures, float threshold, std::vector<std::vector<size_t>>& clusters);
+
+private:
+    static std::uint64_t mix(std::uint64_t x);
+};
+
+}
+#endif // M8R_MIN_HASH_H
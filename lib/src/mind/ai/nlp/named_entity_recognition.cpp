@@ -22,13 +22,26 @@ namespace m8r {
 
 using namespace std;
 
+constexpr size_t NamedEntityRecognition::NER_EXECUTOR_THREADS;
+constexpr int NamedEntityRecognition::NER_TASK_PRIORITY_BATCH;
+constexpr int NamedEntityRecognition::NER_TASK_PRIORITY_OUTLINE;
+
 NamedEntityRecognition::NamedEntityRecognition()
-    : initilized{false}, nerModel{}
+    : initilized{false},
+      nerModels{},
+      idleNerModels{},
+      cache{},
+      index{},
+      taskKeys{},
+      backgroundSubmitted{false},
+      executor{NER_EXECUTOR_THREADS}
 {
 }
 
 NamedEntityRecognition::~NamedEntityRecognition()
 {
+    // running predictions must finish before models are destroyed
+    executor.shutdown();
 }
 
 void NamedEntityRecognition::setNerModel(const std::string& nerModel) {
@@ -36,6 +49,11 @@ void NamedEntityRecognition::setNerModel(const std::string& nerModel) {
 
     initilized = false;
     nerModelPath = nerModel;
+
+    // entities recognized by the previous model are invalid
+    std::lock_guard<mutex> cacheCriticalSection{cacheMutex};
+    cache.clear();
+    index.clear();
 }
 
 // this method is NOT synchronized - callers are synchronized so that race condition is avoided
@@ -51,17 +69,39 @@ bool NamedEntityRecognition::loadAndInitNerModel()
         MF_DEBUG("NER loading model: " << nerModelPath << endl);
         auto begin = chrono::high_resolution_clock::now();
 #endif
+        // tasks of the previous model must not use models which are being replaced
+        executor.drain();
+        if(nerModels.size()) {
+            // entities cached by tasks of the previous model
+            std::lock_guard<mutex> cacheCriticalSection{cacheMutex};
+            cache.clear();
+            index.clear();
+        }
+        std::unique_lock<mutex> criticalSection{modelsMutex};
+        // task submitted after drain may still hold a model
+        modelReleased.wait(criticalSection, [this]{ return idleNerModels.size() == nerModels.size(); });
+        nerModels.clear();
+        idleNerModels.clear();
         string classname;
-        dlib::deserialize(nerModelPath) >> classname >> nerModel;
+        nerModels.push_back(unique_ptr<mitie::named_entity_extractor>(new mitie::named_entity_extractor{}));
+        dlib::deserialize(nerModelPath) >> classname >> *nerModels[0];
+        // model is deserialized ONCE and copied for other workers
+        while(nerModels.size() < executor.getSize()) {
+            nerModels.push_back(unique_ptr<mitie::named_entity_extractor>(new mitie::named_entity_extractor{*nerModels[0]}));
+        }
+        for(auto& m:nerModels) {
+            idleNerModels.push_back(m.get());
+        }
+        backgroundSubmitted = false;
         initilized = true;
 #ifdef DO_MF_DEBUG
         auto end = chrono::high_resolution_clock::now();
-        MF_DEBUG("NER model loaded in " << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0 << "ms" << endl);
+        MF_DEBUG("NER model loaded (" << nerModels.size() << " instances) in " << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0 << "ms" << endl);
 #endif
 
 #ifdef DO_MF_DEBUG
         // print out what kind of tags this tagger can predict.
-        const std::vector<string> tagstr = nerModel.get_tag_name_strings();
+        const std::vector<string> tagstr = nerModels[0]->get_tag_name_strings();
         MF_DEBUG("NER tagger supports "<< tagstr.size() <<" tags:" << endl);
         for(unsigned int i = 0; i < tagstr.size(); ++i) {
             MF_DEBUG("   " << tagstr[i] << endl);
@@ -72,18 +112,30 @@ bool NamedEntityRecognition::loadAndInitNerModel()
     return true;
 }
 
-vector<string> NamedEntityRecognition::tokenizeFile(const string& filename)
+bool NamedEntityRecognition::ensureInitialized()
+{
+    std::lock_guard<mutex> criticalSection{initMutex};
+
+    try {
+        return loadAndInitNerModel();
+    }
+    catch(std::exception& e) {
+        cerr << "NRE error: " << e.what() << endl;
+    }
+    return false;
+}
+
+bool NamedEntityRecognition::tokenizeFile(const string& filename, vector<string>& tokens)
 {
     ifstream fin(filename.c_str());
     if(!fin) {
-        cout << "Unable to load input text file" << endl;
-        exit(EXIT_FAILURE);
+        cerr << "NRE error: unable to load input text file " << filename << endl;
+        return false;
     }
 
     // The conll_tokenizer splits the contents of an istream into a bunch of words and is
     // MITIE's default tokenization method.
     mitie::conll_tokenizer tok(fin);
-    std::vector<string> tokens;
     string token;
 
     // Read the tokens out of the file one at a time and store into tokens.    
@@ -91,86 +143,251 @@ vector<string> NamedEntityRecognition::tokenizeFile(const string& filename)
         tokens.push_back(token);
     }
 
-    return tokens;
+    return true;
 }
 
-bool NamedEntityRecognition::recognizePersons(vector<NerNamedEntity>& result)
+mitie::named_entity_extractor* NamedEntityRecognition::acquireNerModel()
 {
-    UNUSED_ARG(result);
+    unique_lock<mutex> criticalSection{modelsMutex};
+    modelReleased.wait(criticalSection, [this]{ return !idleNerModels.empty(); });
+    mitie::named_entity_extractor* model = idleNerModels.back();
+    idleNerModels.pop_back();
+    return model;
+}
 
+void NamedEntityRecognition::releaseNerModel(mitie::named_entity_extractor* model)
+{
+    {
+        lock_guard<mutex> criticalSection{modelsMutex};
+        idleNerModels.push_back(model);
+    }
+    // both workers and model (re)initialization wait for released model
+    modelReleased.notify_all();
+}
 
+bool NamedEntityRecognition::isCached(const string& key, time_t modified, u_int32_t revision)
+{
+    lock_guard<mutex> criticalSection{cacheMutex};
+    auto i = cache.find(key);
+    return i != cache.end() && i->second.modified == modified && i->second.revision == revision;
+}
 
-    std::lock_guard<mutex> criticalSection{initMutex};
+void NamedEntityRecognition::forget(const Outline* outline)
+{
+    lock_guard<mutex> criticalSection{cacheMutex};
+    forgetKey(outline->getKey());
+}
 
-    if(loadAndInitNerModel()) {
-        // ...
+void NamedEntityRecognition::forgetKey(const string& key)
+{
+    auto i = cache.find(key);
+    if(i != cache.end()) {
+        for(const NerNamedEntity& e:i->second.entities) {
+            auto j = index.find(make_pair(e.name, static_cast<int>(e.type)));
+            if(j != index.end()) {
+                j->second.erase(key);
+                if(j->second.empty()) {
+                    index.erase(j);
+                }
+            }
+        }
+        cache.erase(i);
     }
+}
 
-    return false;
+void NamedEntityRecognition::updateCache(const string& key, time_t modified, u_int32_t revision, vector<NerNamedEntity>& entities)
+{
+    lock_guard<mutex> criticalSection{cacheMutex};
+    forgetKey(key);
+    for(const NerNamedEntity& e:entities) {
+        unordered_map<string,float>& scores = index[make_pair(e.name, static_cast<int>(e.type))];
+        auto o = scores.find(key);
+        if(o == scores.end() || o->second < e.score) {
+            scores[key] = e.score;
+        }
+    }
+    OutlineEntities& cached = cache[key];
+    cached.modified = modified;
+    cached.revision = revision;
+    cached.entities.swap(entities);
 }
 
-bool NamedEntityRecognition::recognizePersons(const Outline* outline, int entityTypeFilter, vector<NerNamedEntity>& result)
+bool NamedEntityRecognition::recognize(const string& key, time_t modified, u_int32_t revision)
 {
-    std::lock_guard<mutex> criticalSection{initMutex};
+    // O might have been recognized since the task was submitted
+    if(isCached(key, modified, revision)) {
+        return true;
+    }
+
+    // tokenize data to prepare it for the tagger
+    MF_DEBUG("NER: tokenizing O " << key << endl);
+    std::vector<string> tokens;
+    if(!tokenizeFile(key, tokens)) {
+        return false;
+    }
+
+    std::vector<pair<unsigned long, unsigned long> > chunks;
+    std::vector<unsigned long> chunk_tags;
+    std::vector<double> chunk_scores;
+    std::vector<string> tagstr;
 
-    if(loadAndInitNerModel())     {
-        try {
-            // tokenize data to prepare it for the tagger
-            MF_DEBUG("NER: tokenizing O " << outline->getKey() << endl);
-            std::vector<string> tokens = tokenizeFile(outline->getKey());
-
-            std::vector<pair<unsigned long, unsigned long> > chunks;
-            std::vector<unsigned long> chunk_tags;
-            std::vector<double> chunk_scores;
-
-            // Now detect all the entities in the text file we loaded and print them to the screen.
-            // The output of this function is a set of "chunks" of tokens, each a named entity.
-            // Additionally, if it is useful for your application a confidence score for each "chunk"
-            // is available by using the predict() method.  The larger the score the more
-            // confident MITIE is in the tag.
+    // Now detect all the entities in the text file we loaded.
+    // The output of this function is a set of "chunks" of tokens, each a named entity.
+    // Additionally, if it is useful for your application a confidence score for each "chunk"
+    // is available by using the predict() method.  The larger the score the more
+    // confident MITIE is in the tag.
 #ifdef DO_MF_DEBUG
-            MF_DEBUG("NER predicting..." << endl);
-            auto begin = chrono::high_resolution_clock::now();
+    MF_DEBUG("NER predicting..." << endl);
+    auto begin = chrono::high_resolution_clock::now();
 #endif
-            nerModel.predict(tokens, chunks, chunk_tags, chunk_scores);
+    mitie::named_entity_extractor* model = acquireNerModel();
+    try {
+        model->predict(tokens, chunks, chunk_tags, chunk_scores);
+        tagstr = model->get_tag_name_strings();
+    } catch(...) {
+        releaseNerModel(model);
+        throw;
+    }
+    releaseNerModel(model);
 #ifdef DO_MF_DEBUG
-            auto end = chrono::high_resolution_clock::now();
-            MF_DEBUG("NER prediction done in " << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0 << "ms" << endl);
+    auto end = chrono::high_resolution_clock::now();
+    MF_DEBUG("NER prediction done in " << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0 << "ms" << endl);
 #endif
 
-            // If a confidence score is not necessary for your application you can detect entities
-            // using the operator() method as shown in the following line.
-            //ner(tokens, chunks, chunk_tags);
-
-            MF_DEBUG("\nNumber of named entities detected: " << chunks.size() << endl);
-            const std::vector<string> tagstr = nerModel.get_tag_name_strings();
-            string entityName{};
-            for (unsigned int i = 0; i < chunks.size(); ++i) {
-                if((1<<chunk_tags[i]) & entityTypeFilter) {
-                    MF_DEBUG("   Tag " << chunk_tags[i] << ": ");
-                    MF_DEBUG("Score: " << fixed << setprecision(3) << chunk_scores[i] << ": ");
-                    MF_DEBUG("" << tagstr[chunk_tags[i]] << ": ");
-                    // chunks[i] defines a half open range in tokens that contains the entity.
-                    entityName.clear();
-                    for(unsigned long j = chunks[i].first; j < chunks[i].second; ++j) {
-                        entityName += tokens[j];
-                        entityName += " ";
-                        MF_DEBUG(tokens[j] << " ");
-                    }
-                    entityName.pop_back(); // remove trailing " "
-                    MF_DEBUG(endl);
-
-                    NerNamedEntity entity{entityName,static_cast<NerNamedEntityType>(1<<chunk_tags[i]),static_cast<float>(chunk_scores[i])};
-                    result.push_back(entity);
+    MF_DEBUG("\nNumber of named entities detected: " << chunks.size() << endl);
+    // entities of all types are cached - type filter is applied on query
+    vector<NerNamedEntity> entities{};
+    string entityName{};
+    for (unsigned int i = 0; i < chunks.size(); ++i) {
+        MF_DEBUG("   Tag " << chunk_tags[i] << ": ");
+        MF_DEBUG("Score: " << fixed << setprecision(3) << chunk_scores[i] << ": ");
+        MF_DEBUG("" << tagstr[chunk_tags[i]] << ": ");
+        // chunks[i] defines a half open range in tokens that contains the entity.
+        entityName.clear();
+        for(unsigned long j = chunks[i].first; j < chunks[i].second; ++j) {
+            entityName += tokens[j];
+            entityName += " ";
+            MF_DEBUG(tokens[j] << " ");
+        }
+        entityName.pop_back(); // remove trailing " "
+        MF_DEBUG(endl);
+
+        entities.push_back(NerNamedEntity{entityName,static_cast<NerNamedEntityType>(1<<chunk_tags[i]),static_cast<float>(chunk_scores[i])});
+    }
+
+    updateCache(key, modified, revision, entities);
+    return true;
+}
+
+shared_future<bool> NamedEntityRecognition::submit(const Outline* outline, int priority)
+{
+    // O is identified by its snapshot - task must not access O which may be changed or deleted
+    string key{outline->getKey()};
+    time_t modified = outline->getModified();
+    u_int32_t revision = outline->getRevision();
+
+    if(isCached(key, modified, revision)) {
+        promise<bool> p{};
+        p.set_value(true);
+        return p.get_future().share();
+    }
+
+    const void* taskKey;
+    {
+        lock_guard<mutex> criticalSection{cacheMutex};
+        taskKey = getTaskKey(key);
+    }
+    return executor.submit(
+        taskKey,
+        priority,
+        [this,key,modified,revision]() { return recognize(key, modified, revision); });
+}
+
+const void* NamedEntityRecognition::getTaskKey(const string& key)
+{
+    // set elements don't move - their address is stable
+    return &*taskKeys.insert(key).first;
+}
+
+void NamedEntityRecognition::recognizeInBackground(const vector<Outline*>& outlines)
+{
+    if(ensureInitialized() && !backgroundSubmitted.exchange(true)) {
+        for(const Outline* o:outlines) {
+            submit(o, NER_TASK_PRIORITY_BATCH);
+        }
+    }
+}
+
+bool NamedEntityRecognition::recognizePersons(const vector<Outline*>& outlines, int entityTypeFilter, vector<NerNamedEntity>& result)
+{
+    if(!ensureInitialized()) {
+        return false;
+    }
+
+    // batch: Os are recognized by all workers
+    vector<shared_future<bool>> futures{};
+    for(const Outline* o:outlines) {
+        futures.push_back(submit(o, NER_TASK_PRIORITY_BATCH));
+    }
+    bool success = true;
+    for(shared_future<bool>& f:futures) {
+        success &= f.get();
+    }
+
+    // query entity index
+    unordered_set<string> keys{};
+    for(const Outline* o:outlines) {
+        keys.insert(o->getKey());
+    }
+    lock_guard<mutex> criticalSection{cacheMutex};
+    for(auto& e:index) {
+        if((e.first.second & entityTypeFilter) == 0) {
+            continue;
+        }
+        float score = 0;
+        bool found = false;
+        for(auto& o:e.second) {
+            if(keys.count(o.first)) {
+                if(!found || score < o.second) {
+                    score = o.second;
                 }
+                found = true;
             }
+        }
+        if(found) {
+            result.push_back(NerNamedEntity{e.first.first,static_cast<NerNamedEntityType>(e.first.second),score});
+        }
+    }
 
-            return true;
+    return success;
+}
+
+bool NamedEntityRecognition::recognizePersons(const Outline* outline, int entityTypeFilter, vector<NerNamedEntity>& result)
+{
+    if(!ensureInitialized()) {
+        return false;
+    }
+
+    try {
+        // user waits for O - it's recognized before Os in batch
+        if(!submit(outline, NER_TASK_PRIORITY_OUTLINE).get()) {
+            return false;
         }
-        catch(std::exception& e) {
-            cerr << "NRE error: " << e.what() << endl;
+
+        lock_guard<mutex> criticalSection{cacheMutex};
+        auto i = cache.find(outline->getKey());
+        if(i != cache.end()) {
+            for(const NerNamedEntity& e:i->second.entities) {
+                if(e.type & entityTypeFilter) {
+                    result.push_back(e);
+                }
+            }
+            return true;
         }
     }
+    catch(std::exception& e) {
+        cerr << "NRE error: " << e.what() << endl;
+    }
 
     return false;
 }
@@ -21,12 +21,19 @@
 
 #include <vector>
 #include <string>
+#include <map>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <iostream>
 #include <iomanip>
 #include <fstream>
 #include <cstdlib>
+#include <atomic>
+#include <condition_variable>
 #include <mutex>
+#include <unordered_set>
 
 #include "../../deps/mitie/mitielib/include/mitie/named_entity_extractor.h"
 #include "../../deps/mitie/mitielib/include/mitie/conll_tokenizer.h"
@@ -34,18 +41,63 @@
 
 #include "ner_named_entity.h"
 
+#include "../../../gear/priority_executor.h"
 #include "../../../model/outline.h"
 
 namespace m8r {
 
+/**
+ * @brief Named-entity recognition (NER) using MITIE.
+ *
+ * Entities recognized in O (all types, in order of occurrence) are cached by O key
+ * until O's modification time or revision changes, therefore repeated requests
+ * don't read, tokenize and predict O again.
+ *
+ * Predictions run on a fixed pool of workers - each worker has its own instance
+ * of the model. Os of the whole memory are recognized in batch (in the background)
+ * and cached entities form repository-wide entity index which answers "find
+ * persons/organizations/..." queries instantly.
+ */
 class NamedEntityRecognition
 {
+public:
+    // NER model is huge (hundreds of MBs) - every worker has its own copy
+    static constexpr size_t NER_EXECUTOR_THREADS = 2;
+    static constexpr int NER_TASK_PRIORITY_BATCH = 0;
+    static constexpr int NER_TASK_PRIORITY_OUTLINE = 1;
+
 private:
+    /**
+     * @brief Entities recognized in O at given modification time and revision.
+     */
+    struct OutlineEntities {
+        time_t modified;
+        u_int32_t revision;
+        std::vector<NerNamedEntity> entities;
+    };
+
     std::mutex initMutex;
     bool initilized;
 
     std::string  nerModelPath;
-    mitie::named_entity_extractor nerModel;
+    // model instance per worker
+    std::vector<std::unique_ptr<mitie::named_entity_extractor>> nerModels;
+    std::vector<mitie::named_entity_extractor*> idleNerModels;
+    std::mutex modelsMutex;
+    std::condition_variable modelReleased;
+
+    // O key -> entities
+    std::unordered_map<std::string,OutlineEntities> cache;
+    // (entity name, type) -> O key -> the best score
+    std::map<std::pair<std::string,int>,std::unordered_map<std::string,float>> index;
+    // O keys interned to stable task keys (queued/running NER of O is not submitted twice)
+    std::unordered_set<std::string> taskKeys;
+    std::mutex cacheMutex;
+    // memory is recognized in background once per model load
+    std::atomic<bool> backgroundSubmitted;
+
+    // destroyed first - tasks use models and cache
+    PriorityExecutor executor;
 
 public:
     explicit NamedEntityRecognition();
@@ -60,29 +112,72 @@ public:
     /**
      * @brief Set NER model location.
      *
-     * This set path to the method, but it does NOT load and initialize it.
+     * This set path to the method, but it does NOT load and initialize it. Cached
+     * entities are cleared - it must not be called while entities are recognized.
      */
     void setNerModel(const std::string& nerModel);
 
     /**
-     * @brief NRE persons in memory.
+     * @brief NER in Os (memory) - distinct entities ordered by name w/ the best score.
+     *
+     * Os which are not cached are recognized in batch on worker pool.
      */
-    bool recognizePersons(std::vector<NerNamedEntity>& result);
+    bool recognizePersons(const std::vector<Outline*>& outlines, int entityTypeFilter, std::vector<NerNamedEntity>& result);
 
     /**
-     * @brief NRE persons in O.
+     * @brief NER in O - entities in order of occurrence.
      */
     bool recognizePersons(const Outline* outline, int entityTypeFilter, std::vector<NerNamedEntity>& result);
 
+    /**
+     * @brief Recognize entities in Os which are not cached in the background to make queries instant.
+     *
+     * Batch is submitted once per model load - Os changed later are recognized on demand.
+     */
+    void recognizeInBackground(const std::vector<Outline*>& outlines);
+
+    /**
+     * @brief Remove entities of forgotten O from cache and index.
+     */
+    void forget(const Outline* outline);
+
+    /**
+     * @brief Get number of Os waiting to be recognized.
+     */
+    size_t getQueuedCount() { return executor.getQueuedCount(); }
+
 private:
-    std::vector<std::string> tokenizeFile(const std::string& filename);
+    bool tokenizeFile(const std::string& filename, std::vector<std::string>& tokens);
+
+    /**
+     * @brief Submit NER of O unless O is cached - returned future is ready if it's cached.
+     */
+    std::shared_future<bool> submit(const Outline* outline, int priority);
+
+    /**
+     * @brief Recognize entities in O file and cache them (executed by worker).
+     */
+    bool recognize(const std::string& key, time_t modified, u_int32_t revision);
+
+    bool isCached(const std::string& key, time_t modified, u_int32_t revision);
+    void updateCache(const std::string& key, time_t modified, u_int32_t revision, std::vector<NerNamedEntity>& entities);
+    // caller must hold cacheMutex
+    void forgetKey(const std::string& key);
+
+    mitie::named_entity_extractor* acquireNerModel();
+    void releaseNerModel(mitie::named_entity_extractor* model);
+
+    // caller must hold cacheMutex
+    const void* getTaskKey(const std::string& key);
 
     /**
      * @brief Load and initialize NER model file.
      *
      * NER file is typically huge (MBs) therefore it is loaded and initialized on demand.
+     * Tasks of the previous model are cancelled/finished before models are replaced.
      */
     bool loadAndInitNerModel();
+    bool ensureInitialized();
 };
 
 }
@@ -18,30 +18,144 @@
 */
 #include "stemmer.h"
 
+#include <stdexcept>
+
 namespace m8r {
 
 using namespace std;
 
+constexpr size_t Stemmer::STEM_CACHE_MAX_WORDS;
+
 Stemmer::Stemmer()
+    : language(ENGLISH), cache{}, wide{}
 {
-    language = ENGLISH;
 }
 
 Stemmer::~Stemmer()
 {
 }
 
-string Stemmer::stem(string word)
+Stemmer::Language Stemmer::toLanguage(const string& name)
+{
+    static const unordered_map<string,Language> languages{
+        {"english", ENGLISH},
+        {"german", GERMAN},
+        {"french", FRENCH},
+        {"spanish", SPANISH},
+        {"italian", ITALIAN},
+        {"portuguese", PORTUGUESE},
+        {"dutch", DUTCH},
+        {"danish", DANISH},
+        {"norwegian", NORWEGIAN},
+        {"swedish", SWEDISH},
+        {"finnish", FINNISH}
+    };
+
+    string key{name};
+    for(char& c:key) c = tolower(c);
+    auto l = languages.find(key);
+    if(l != languages.end()) {
+        return l->second;
+    }
+    return ENGLISH;
+}
+
+void Stemmer::setLanguage(Language lang)
+{
+    if(lang != language) {
+        language = lang;
+        cache.clear();
+    }
+}
+
+const string& Stemmer::stem(const string& word)
+{
+    auto c = cache.find(word);
+    if(c != cache.end()) {
+        return c->second;
+    }
+
+    if(cache.size() >= STEM_CACHE_MAX_WORDS) {
+        cache.clear();
+    }
+    string& s = cache[word];
+    stemUncached(word, s);
+    return s;
+}
+
+void Stemmer::stemUncached(const string& word, string& result)
 {
     // IMPROVE: despite stemmer works in wstring mode, MindForger runs just in string mode - wstring to come later when entire application is switched
-    std::wstringstream swide;
-    swide << word.c_str();
-    wstring wide = swide.str();
+    bool ascii = true;
+    for(char c:word) {
+        if(c & 0x80) {
+            ascii = false;
+            break;
+        }
+    }
+
+    if(ascii) {
+        // fast path: no need to decode UTF-8
+        wide.assign(word.begin(), word.end());
+    } else {
+        try {
+            wide = converter.from_bytes(word);
+        } catch(const std::range_error&) {
+            // invalid UTF-8 is not stemmed
+            result.assign(word);
+            return;
+        }
+    }
 
-    // IMPROVE switch by language (configuration)
-    StemEnglish(wide);
+    switch(language) {
+    case GERMAN:
+        StemGerman(wide);
+        break;
+    case FRENCH:
+        StemFrench(wide);
+        break;
+    case SPANISH:
+        StemSpanish(wide);
+        break;
+    case ITALIAN:
+        StemItalian(wide);
+        break;
+    case PORTUGUESE:
+        StemPortuguese(wide);
+        break;
+    case DUTCH:
+        StemDutch(wide);
+        break;
+    case DANISH:
+        StemDanish(wide);
+        break;
+    case NORWEGIAN:
+        StemNorwgian(wide);
+        break;
+    case SWEDISH:
+        StemSwedish(wide);
+        break;
+    case FINNISH:
+        StemFinnish(wide);
+        break;
+    case ENGLISH:
+    default:
+        StemEnglish(wide);
+        break;
+    }
 
-    return converter.to_bytes(wide);
+    // stemmers may produce non-ASCII chars (e.g. umlauts) even for ASCII words
+    for(wchar_t c:wide) {
+        if(c & ~0x7F) {
+            ascii = false;
+            break;
+        }
+    }
+    if(ascii) {
+        result.assign(wide.begin(), wide.end());
+    } else {
+        result = converter.to_bytes(wide);
+    }
 }
 
 } // m8r namespace
@@ -20,6 +20,7 @@
 #define M8R_STEMMER_H
 
 #include <string>
+#include <unordered_map>
 #include <iostream>
 #include <sstream>
 #include <locale>
@@ -40,17 +41,48 @@
 
 namespace m8r {
 
+/**
+ * @brief Stemmer w/ memoized stems.
+ *
+ * The same words are stemmed over and over again (each occurrence in each N
+ * on every dream), therefore stems are cached. ASCII words (the vast majority
+ * of Markdown tokens) are widened/narrowed char by char w/o UTF-8 codec.
+ */
 class Stemmer
 {
 public:
     enum Language {
-        ENGLISH
+        ENGLISH,
+        GERMAN,
+        FRENCH,
+        SPANISH,
+        ITALIAN,
+        PORTUGUESE,
+        DUTCH,
+        DANISH,
+        NORWEGIAN,
+        SWEDISH,
+        FINNISH
     };
 
+    // cache is dropped once it grows bigger (vocabulary is typically much smaller)
+    static constexpr size_t STEM_CACHE_MAX_WORDS = 1<<20;
+
+    /**
+     * @brief Convert language name (english, german, ...) to language - English is default.
+     */
+    static Language toLanguage(const std::string& name);
+
 private:
     Language language;
 
+    // word > stem (valid for current language)
+    std::unordered_map<std::string,std::string> cache;
+    // reusable buffer
+    std::wstring wide;
+
     stemming::english_stem<> StemEnglish;
+    stemming::french_stem<> StemFrench;
     stemming::german_stem<> StemGerman;
     stemming::finnish_stem<> StemFinnish;
     stemming::swedish_stem<> StemSwedish;
@@ -71,9 +103,21 @@ public:
     Stemmer &operator=(const Stemmer&&) = delete;
     ~Stemmer();
 
-    void setLanguage(Language lang) { this->language = lang; }
+    void setLanguage(Language lang);
+    Language getLanguage() const { return language; }
 
-    std::string stem(std::string word);
+    /**
+     * @brief Stem the word.
+     *
+     * Returned reference is valid until the next stem() or setLanguage() call.
+     */
+    const std::string& stem(const std::string& word);
+
+    size_t getCacheSize() const { return cache.size(); }
+    void clearCache() { cache.clear(); }
+
+private:
+    void stemUncached(const std::string& word, std::string& result);
 };
 
 }
@@ -0,0 +1,374 @@
+/*
+ word_embeddings.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "word_embeddings.h"
+
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+
+#ifdef _WIN32
+#include <iterator>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace m8r {
+
+using namespace std;
+
+constexpr uint64_t WordEmbeddings::MAGIC;
+constexpr uint32_t WordEmbeddings::VERSION;
+constexpr size_t WordEmbeddings::HEADER_SIZE;
+
+/*
+ * Header layout: magic, version, dimension, count, capacity, language.
+ */
+struct WordEmbeddingsHeader {
+    uint64_t magic;
+    uint32_t version;
+    uint32_t dimension;
+    uint32_t count;
+    uint32_t capacity;
+    uint32_t language;
+};
+
+WordEmbeddings::WordEmbeddings()
+    : path{},
+      data{nullptr},
+      dataSize{0},
+      buffer{},
+      dimension{0},
+      count{0},
+      capacity{0},
+      language{0},
+      vectors{nullptr},
+      slots{nullptr},
+      wordEnds{nullptr},
+      words{nullptr}
+{
+}
+
+WordEmbeddings::~WordEmbeddings()
+{
+    close();
+}
+
+bool WordEmbeddings::open(const string& path)
+{
+    close();
+
+#ifdef _WIN32
+    // IMPROVE map file using CreateFileMapping()/MapViewOfFile()
+    ifstream in(path, ios::binary);
+    if(!in) {
+        return false;
+    }
+    buffer.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+    if(buffer.size() < HEADER_SIZE) {
+        buffer.clear();
+        return false;
+    }
+    data = buffer.data();
+    dataSize = buffer.size();
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if(fd < 0) {
+        return false;
+    }
+    struct stat attrs;
+    if(fstat(fd, &attrs) || static_cast<size_t>(attrs.st_size) < HEADER_SIZE) {
+        ::close(fd);
+        return false;
+    }
+    void* mapped = mmap(nullptr, attrs.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    // mapping keeps file open
+    ::close(fd);
+    if(mapped == MAP_FAILED) {
+        return false;
+    }
+    data = static_cast<const char*>(mapped);
+    dataSize = attrs.st_size;
+#endif
+
+    WordEmbeddingsHeader header;
+    memcpy(&header, data, sizeof(header));
+    if(header.magic != MAGIC || header.version != VERSION || !header.dimension
+         || !header.capacity || (header.capacity & (header.capacity-1)) || header.count >= header.capacity)
+    {
+        close();
+        return false;
+    }
+
+    // validate sizes (mapped file might be truncated)
+    const uint64_t vectorsSize = static_cast<uint64_t>(header.count)*header.dimension*sizeof(float);
+    const uint64_t slotsOffset = HEADER_SIZE + vectorsSize;
+    const uint64_t wordEndsOffset = slotsOffset + static_cast<uint64_t>(header.capacity)*sizeof(uint32_t);
+    const uint64_t wordsOffset = wordEndsOffset + static_cast<uint64_t>(header.count)*sizeof(uint32_t);
+    if(wordsOffset > dataSize) {
+        close();
+        return false;
+    }
+    wordEnds = reinterpret_cast<const uint32_t*>(data + wordEndsOffset);
+    if(header.count && wordsOffset + wordEnds[header.count-1] > dataSize) {
+        close();
+        return false;
+    }
+
+    this->path = path;
+    dimension = header.dimension;
+    count = header.count;
+    capacity = header.capacity;
+    language = header.language;
+    vectors = reinterpret_cast<const float*>(data + HEADER_SIZE);
+    slots = reinterpret_cast<const uint32_t*>(data + slotsOffset);
+    words = data + wordsOffset;
+
+    MF_DEBUG("Word embeddings: " << count << " words x " << dimension << " mapped from " << path << endl);
+    return true;
+}
+
+void WordEmbeddings::close()
+{
+#ifndef _WIN32
+    if(data) {
+        munmap(const_cast<char*>(data), dataSize);
+    }
+#endif
+    buffer.clear();
+    buffer.shrink_to_fit();
+    data = nullptr;
+    dataSize = 0;
+    path.clear();
+    dimension = count = capacity = language = 0;
+    vectors = nullptr;
+    slots = nullptr;
+    wordEnds = nullptr;
+    words = nullptr;
+}
+
+const float* WordEmbeddings::get(const string& word) const
+{
+    if(!data) {
+        return nullptr;
+    }
+
+    const uint32_t mask = capacity-1;
+    for(uint32_t i=Lexicon::hashWord(word)&mask; slots[i]; i=(i+1)&mask) {
+        const uint32_t id = slots[i]-1;
+        const uint32_t begin = id?wordEnds[id-1]:0;
+        if(wordEnds[id]-begin == word.size() && !memcmp(words+begin, word.data(), word.size())) {
+            return vectors + static_cast<size_t>(id)*dimension;
+        }
+    }
+    return nullptr;
+}
+
+uint64_t WordEmbeddings::getFingerprint() const
+{
+    if(!data) {
+        return 0;
+    }
+
+    // FNV-1a of header, file size and words (the end of file) - vectors are not read
+    uint64_t hash = 14695981039346656037ULL;
+    auto hashBytes = [&hash](const char* bytes, size_t size) {
+        for(size_t i=0; i<size; i++) {
+            hash ^= static_cast<unsigned char>(bytes[i]);
+            hash *= 1099511628211ULL;
+        }
+    };
+    hashBytes(data, sizeof(WordEmbeddingsHeader));
+    const uint64_t size = dataSize;
+    hashBytes(reinterpret_cast<const char*>(&size), sizeof(size));
+    const size_t tail = dataSize < HEADER_SIZE*2 ? dataSize : HEADER_SIZE;
+    hashBytes(data+dataSize-tail, tail);
+    return hash;
+}
+
+bool WordEmbeddings::isBinary(const string& path)
+{
+    ifstream in(path, ios::binary);
+    uint64_t magic = 0;
+    return in.read(reinterpret_cast<char*>(&magic), sizeof(magic)) && magic == MAGIC;
+}
+
+bool WordEmbeddings::convert(const string& textPath, const string& binaryPath, Stemmer::Language language)
+{
+    ifstream in(textPath);
+    if(!in) {
+        return false;
+    }
+
+    Stemmer stemmer{};
+    stemmer.setLanguage(language);
+    // stems are interned by lexicon: stem ID ~ vector index
+    Lexicon lexicon{};
+    vector<float> sums{};
+    uint32_t dimension = 0;
+
+    string line{}, word{};
+    vector<float> v{};
+    while(getline(in, line)) {
+        // words shorter than 2 characters are skipped by tokenizer
+        size_t i = line.find(' ');
+        if(i == string::npos || i < 2) {
+            continue;
+        }
+        word.assign(line, 0, i);
+
+        v.clear();
+        const char* p = line.c_str()+i;
+        char* e;
+        for(float f=strtof(p, &e); p != e; f=strtof(p, &e)) {
+            v.push_back(f);
+            p = e;
+        }
+        if(!dimension) {
+            // skip word2vec header: words count and dimension
+            if(v.size() < 2) {
+                continue;
+            }
+            dimension = v.size();
+        } else if(v.size() != dimension) {
+            continue;
+        }
+
+        // words are lowercased by tokenizer, punctuation is never a word
+        bool isWord = true;
+        for(char& c:word) {
+            if(static_cast<unsigned char>(c) < 128) {
+                if(ispunct(static_cast<unsigned char>(c)) && c != '-') {
+                    isWord = false;
+                    break;
+                }
+                c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+            }
+        }
+        if(!isWord) {
+            continue;
+        }
+
+        // every word of the stem contributes the same
+        normalize(v.data(), dimension);
+        const uint32_t id = lexicon.add(stemmer.stem(word));
+        if((id+1)*static_cast<size_t>(dimension) > sums.size()) {
+            sums.resize((id+1)*static_cast<size_t>(dimension), 0.);
+        }
+        float* s = sums.data()+id*static_cast<size_t>(dimension);
+        for(uint32_t d=0; d<dimension; d++) {
+            s[d] += v[d];
+        }
+    }
+    const uint32_t count = lexicon.size();
+    if(!count) {
+        return false;
+    }
+    for(uint32_t id=0; id<count; id++) {
+        normalize(sums.data()+id*static_cast<size_t>(dimension), dimension);
+    }
+
+    // hash table w/ load factor <= 0.5
+    uint32_t capacity = 16;
+    while(capacity < 2*count) {
+        capacity <<= 1;
+    }
+    vector<uint32_t> slots(capacity, 0);
+    vector<uint32_t> wordEnds(count);
+    uint32_t end = 0;
+    for(uint32_t id=0; id<count; id++) {
+        const string& w = lexicon.getWord(id);
+        uint32_t s = Lexicon::hashWord(w)&(capacity-1);
+        while(slots[s]) {
+            s = (s+1)&(capacity-1);
+        }
+        slots[s] = id+1;
+        end += w.size();
+        wordEnds[id] = end;
+    }
+
+    // write to temporary file and rename it to never leave a broken file
+    string tmpPath{binaryPath};
+    tmpPath += ".tmp";
+    ofstream out(tmpPath, ios::binary);
+    if(!out) {
+        return false;
+    }
+    char header[HEADER_SIZE] = {};
+    WordEmbeddingsHeader h{MAGIC, VERSION, dimension, count, capacity, static_cast<uint32_t>(language)};
+    memcpy(header, &h, sizeof(h));
+    out.write(header, HEADER_SIZE);
+    out.write(reinterpret_cast<const char*>(sums.data()), static_cast<size_t>(count)*dimension*sizeof(float));
+    out.write(reinterpret_cast<const char*>(slots.data()), slots.size()*sizeof(uint32_t));
+    out.write(reinterpret_cast<const char*>(wordEnds.data()), wordEnds.size()*sizeof(uint32_t));
+    for(uint32_t id=0; id<count; id++) {
+        const string& w = lexicon.getWord(id);
+        out.write(w.data(), w.size());
+    }
+    out.close();
+    if(!out || std::rename(tmpPath.c_str(), binaryPath.c_str())) {
+        std::remove(tmpPath.c_str());
+        return false;
+    }
+
+    MF_DEBUG("Word embeddings: " << count << " stems x " << dimension << " converted to " << binaryPath << endl);
+    return true;
+}
+
+float WordEmbeddings::dot(const float* a, const float* b, size_t dimension)
+{
+    size_t i = 0;
+    float result = 0.;
+#ifdef __AVX2__
+    __m256 sum = _mm256_setzero_ps();
+    for(; i+8 <= dimension; i+=8) {
+        sum = _mm256_add_ps(sum, _mm256_mul_ps(_mm256_loadu_ps(a+i), _mm256_loadu_ps(b+i)));
+    }
+    // horizontal sum of 8 lanes
+    __m128 half = _mm_add_ps(_mm256_castps256_ps128(sum), _mm256_extractf128_ps(sum, 1));
+    half = _mm_add_ps(half, _mm_movehl_ps(half, half));
+    half = _mm_add_ss(half, _mm_shuffle_ps(half, half, 0x55));
+    result = _mm_cvtss_f32(half);
+#endif
+    for(; i<dimension; i++) {
+        result += a[i]*b[i];
+    }
+    return result;
+}
+
+void WordEmbeddings::normalize(float* v, size_t dimension)
+{
+    float norm = std::sqrt(dot(v, v, dimension));
+    if(norm > 0.) {
+        for(size_t i=0; i<dimension; i++) {
+            v[i] /= norm;
+        }
+    }
+}
+
+} // m8r namespace
@@ -0,0 +1,134 @@
+/*
+ word_embeddings.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_WORD_EMBEDDINGS_H
+#define M8R_WORD_EMBEDDINGS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "../../../debug.h"
+#include "lexicon.h"
+#include "stemmer/stemmer.h"
+
+namespace m8r {
+
+/**
+ * @brief Read-only store of word embeddings (word vectors) memory-mapped from a binary file.
+ *
+ * Word vectors like Stanford GloVe (https://nlp.stanford.edu/projects/glove/)
+ * are distributed as text files w/ hundreds of MB. Text file is converted ONCE
+ * to a binary file which is memory-mapped (not loaded) - opening the store costs
+ * just a few syscalls and pages w/ vectors are loaded by OS on demand.
+ *
+ * Words are stemmed by the same stemmer as Lexicon words when converted (vectors
+ * of words w/ the same stem are averaged) and vectors are normalized to unit
+ * length, therefore cosine similarity of two vectors is their dot product.
+ *
+ * Binary file format (native byte order):
+ *   header      ... magic, version, dimension, words count, hash table capacity,
+ *                   stemmer language (padded to HEADER_SIZE)
+ *   vectors     ... words count x dimension floats (aligned to HEADER_SIZE)
+ *   hash table  ... capacity x (word ID + 1) - 0 ~ empty slot, Lexicon::hashWord()
+ *                   w/ linear probing
+ *   word ends   ... words count x offset of word end in words
+ *   words       ... concatenated words
+ */
+class WordEmbeddings
+{
+public:
+    static constexpr std::uint64_t MAGIC = 0x31424d455752384dULL; // "M8RWEMB1"
+    static constexpr std::uint32_t VERSION = 1;
+    static constexpr size_t HEADER_SIZE = 64;
+
+private:
+    std::string path;
+
+    // mapped file
+    const char* data;
+    size_t dataSize;
+    // file content if it cannot be mapped
+    std::vector<char> buffer;
+
+    std::uint32_t dimension;
+    std::uint32_t count;
+    std::uint32_t capacity;
+    std::uint32_t language;
+
+    const float* vectors;
+    const std::uint32_t* slots;
+    const std::uint32_t* wordEnds;
+    const char* words;
+
+public:
+    explicit WordEmbeddings();
+    WordEmbeddings(const WordEmbeddings&) = delete;
+    WordEmbeddings(const WordEmbeddings&&) = delete;
+    WordEmbeddings &operator=(const WordEmbeddings&) = delete;
+    WordEmbeddings &operator=(const WordEmbeddings&&) = delete;
+    ~WordEmbeddings();
+
+    /**
+     * @brief Map binary file created by convert().
+     *
+     * @return false if file doesn't exist or it's not a valid embeddings file.
+     */
+    bool open(const std::string& path);
+    void close();
+
+    bool isOpen() const { return data != nullptr; }
+    const std::string& getPath() const { return path; }
+    size_t size() const { return count; }
+    std::uint32_t getDimension() const { return dimension; }
+    Stemmer::Language getStemmerLanguage() const { return static_cast<Stemmer::Language>(language); }
+
+    /**
+     * @brief Get unit length vector of (stemmed) word or nullptr if word is unknown.
+     */
+    const float* get(const std::string& word) const;
+
+    /**
+     * @brief Get hash of embeddings (0 if not open) i.e. whether similarities calculated w/ embeddings are valid.
+     */
+    std::uint64_t getFingerprint() const;
+
+    /**
+     * @brief Convert text embeddings - word followed by vector components on each
+     * line (GloVe, word2vec text format) - to binary file.
+     */
+    static bool convert(const std::string& textPath, const std::string& binaryPath, Stemmer::Language language);
+
+    /**
+     * @brief Check whether file is binary embeddings file (or text file to be converted).
+     */
+    static bool isBinary(const std::string& path);
+
+    /**
+     * @brief Dot product of vectors (cosine similarity of unit length vectors) - AVX2 if available.
+     */
+    static float dot(const float* a, const float* b, size_t dimension);
+
+    /**
+     * @brief Normalize vector to unit length (zero vector is kept).
+     */
+    static void normalize(float* v, size_t dimension);
+};
+
+}
+#endif // M8R_WORD_EMBEDDINGS_H
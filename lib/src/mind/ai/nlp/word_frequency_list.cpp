@@ -25,8 +25,7 @@ namespace m8r {
 using namespace std;
 
 WordFrequencyList::WordFrequencyList(Lexicon* lexicon)
-    : lexicon(lexicon),
-      wordWeightComparator{lexicon}
+    : lexicon(lexicon)
 {
     weight = UNDEF_WEIGHT;
 }
@@ -39,18 +38,33 @@ void WordFrequencyList::sort() {
     // reset array
     wordsByWeight.clear();
 
+    // look weights up just once (not on every comparison)
+    vector<pair<float,pair<const string* const,int>*>> weighted{};
+    weighted.reserve(word2Frequency.size());
     for(auto& w:word2Frequency) {
-        wordsByWeight.push_back(&w);
+        uint32_t id = lexicon->getId(w.first);
+        weighted.push_back(make_pair(id==Lexicon::NO_WORD?0.f:lexicon->getWeight(id), &w));
+    }
+    // words w/ the same weight ordered alphabetically so that order doesn't depend on addresses
+    std::sort(
+        weighted.begin(),
+        weighted.end(),
+        [](const pair<float,pair<const string* const,int>*>& p1, const pair<float,pair<const string* const,int>*>& p2) {
+            return p1.first > p2.first || (p1.first == p2.first && *p1.second->first < *p2.second->first);
+        });
+
+    wordsByWeight.reserve(weighted.size());
+    for(auto& w:weighted) {
+        wordsByWeight.push_back(w.second);
     }
-    std::sort(wordsByWeight.begin(),wordsByWeight.end(),wordWeightComparator);
 }
 
 float WordFrequencyList::recalculateWeight() {
     weight = 0;
     for(auto& w:word2Frequency) {
-        Lexicon::WordEmbedding* e = lexicon->get(w.first);
+        uint32_t id = lexicon->getId(w.first);
         // IMPROVE if(e) result += e->weight * ((float)w.second); ... means min of weights in UNION and INTERSECTION
-        if(e) weight += e->weight;
+        if(id != Lexicon::NO_WORD) weight += lexicon->getWeight(id);
     }
     return weight;
 }
@@ -40,20 +40,6 @@ namespace m8r {
  */
 class WordFrequencyList
 {
-    struct WordWeightComparator
-    {
-        Lexicon *l;
-        WordWeightComparator(Lexicon* l) : l(l) {}
-
-        // functor to compare words by weight
-        bool operator()(
-                const std::pair<const std::string* const,int>*const& p1,
-                const std::pair<const std::string* const,int>*const& p2
-        ) {
-            return l->get(p1->first)->weight > l->get(p2->first)->weight;
-        }
-    };
-
 public:
     static constexpr float UNDEF_WEIGHT = -1;
 
@@ -81,7 +67,6 @@ public:
 
 private:
     Lexicon* lexicon;
-    WordWeightComparator wordWeightComparator;
 
     float weight;
 
@@ -103,9 +88,13 @@ public:
     WordFrequencyList &operator=(const WordFrequencyList&&) = delete;
     ~WordFrequencyList();
 
-    int& operator[](std::string* key) { return word2Frequency[key]; }
+    int& operator[](const std::string* key) { return word2Frequency[key]; }
     size_t size() const { return word2Frequency.size(); }
     const std::map<const std::string*,int>& iterable() const { return word2Frequency; }
+    /**
+     * @brief Get words ordered by weight (valid after sort()).
+     */
+    const std::vector<std::pair<const std::string *const,int>*>& iterableByWeight() const { return wordsByWeight; }
 
     float getWeight() {
         if(weight==UNDEF_WEIGHT) {
@@ -142,7 +131,7 @@ public:
     }
 
     /**
-     * @brief Sort words by weight.
+     * @brief Sort words by weight (words w/ the same weight alphabetically).
      */
     void sort();
 
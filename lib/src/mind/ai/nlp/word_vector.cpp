@@ -0,0 +1,137 @@
+/*
+ word_vector.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "word_vector.h"
+
+#include <algorithm>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+namespace m8r {
+
+using namespace std;
+
+WordVector::WordVector()
+    : ids{},
+      relevantIds{},
+      relevantWeights{},
+      relevantWeight{0.}
+{
+}
+
+void WordVector::build(const WordFrequencyList& wfl, const Lexicon& lexicon, size_t relevantWords)
+{
+    ids.clear();
+    relevantIds.clear();
+    relevantWeights.clear();
+    relevantWeight = 0.;
+
+    vector<pair<uint32_t,float>> relevant{};
+    for(auto w:wfl.iterableByWeight()) {
+        uint32_t id = lexicon.getId(w->first);
+        if(id != Lexicon::NO_WORD) {
+            ids.push_back(id);
+            if(relevant.size() < relevantWords) {
+                relevant.push_back(make_pair(id, lexicon.getWeight(id)));
+                relevantWeight += lexicon.getWeight(id);
+            }
+        }
+    }
+
+    std::sort(ids.begin(), ids.end());
+    std::sort(relevant.begin(), relevant.end());
+    for(auto& r:relevant) {
+        relevantIds.push_back(r.first);
+        relevantWeights.push_back(r.second);
+    }
+}
+
+void WordVector::build(vector<uint32_t>& ids, const vector<pair<uint32_t,float>>& relevant)
+{
+    std::sort(ids.begin(), ids.end());
+    ids.erase(std::unique(ids.begin(), ids.end()), ids.end());
+    this->ids.swap(ids);
+
+    vector<pair<uint32_t,float>> sorted{relevant};
+    std::sort(sorted.begin(), sorted.end());
+    relevantIds.clear();
+    relevantWeights.clear();
+    relevantWeight = 0.;
+    for(auto& r:sorted) {
+        relevantIds.push_back(r.first);
+        relevantWeights.push_back(r.second);
+        relevantWeight += r.second;
+    }
+}
+
+bool WordVector::find(const vector<uint32_t>& ids, size_t& position, uint32_t id)
+{
+    const size_t size = ids.size();
+#ifdef __AVX2__
+    // skip 8 IDs at once while all of them are lower than searched ID
+    // (IDs are dense i.e. < 2^31, therefore signed comparison is safe)
+    const __m256i needle = _mm256_set1_epi32(static_cast<int>(id));
+    while(position+8 <= size) {
+        __m256i block = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ids.data()+position));
+        int lower = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpgt_epi32(needle, block)));
+        position += __builtin_popcount(lower);
+        if(lower != 0xFF) {
+            return position<size && ids[position]==id;
+        }
+    }
+#endif
+    position = std::lower_bound(ids.begin()+position, ids.end(), id) - ids.begin();
+    return position<size && ids[position]==id;
+}
+
+float WordVector::similarity(const WordVector& v1, const WordVector& v2)
+{
+    if(v1.ids.empty() || v2.ids.empty()) {
+        return 0.;
+    }
+
+    float iWeight = 0.;
+    float uWeight = v1.relevantWeight + v2.relevantWeight;
+
+    // R(v1) AND W(v2)
+    size_t p = 0;
+    for(size_t i=0; i<v1.relevantIds.size(); i++) {
+        if(find(v2.ids, p, v1.relevantIds[i])) {
+            iWeight += v1.relevantWeights[i];
+        }
+    }
+
+    // R(v2) AND W(v1) - words in R(v1) AND R(v2) are already in intersection, but twice in union
+    p = 0;
+    size_t r = 0;
+    for(size_t i=0; i<v2.relevantIds.size(); i++) {
+        if(find(v1.ids, p, v2.relevantIds[i])) {
+            if(find(v1.relevantIds, r, v2.relevantIds[i])) {
+                uWeight -= v2.relevantWeights[i];
+            } else {
+                iWeight += v2.relevantWeights[i];
+            }
+        }
+    }
+
+    return uWeight>0. ? iWeight/uWeight : 0.;
+}
+
+} // m8r namespace
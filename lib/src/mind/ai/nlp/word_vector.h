@@ -0,0 +1,99 @@
+/*
+ word_vector.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_WORD_VECTOR_H
+#define M8R_WORD_VECTOR_H
+
+#include <cstdint>
+#include <vector>
+
+#include "lexicon.h"
+#include "word_frequency_list.h"
+
+namespace m8r {
+
+/**
+ * @brief Sparse document vector of word IDs for fast similarity assessment.
+ *
+ * Document (O/N) is represented by sorted array of (Lexicon) IDs of all its words
+ * and by sorted arrays of IDs and weights of its most relevant words i.e. words
+ * with the highest weight. Similarity of two vectors is calculated by merging
+ * sorted arrays - no lookups in maps and no allocations are needed.
+ *
+ * If compiled with AVX2 support, then 8 word IDs are compared at once when
+ * relevant words are searched in all document words.
+ *
+ * Unlike WordFrequencyList, which is used to build Lexicon and BoW, vector is
+ * immutable (rebuild it on document change) and copyable so that vectors of
+ * all documents can be stored contiguously.
+ */
+class WordVector
+{
+private:
+    // all document words - sorted by ID
+    std::vector<std::uint32_t> ids;
+    // the most relevant document words - sorted by ID
+    std::vector<std::uint32_t> relevantIds;
+    std::vector<float> relevantWeights;
+    float relevantWeight;
+
+public:
+    explicit WordVector();
+
+    size_t size() const { return ids.size(); }
+    size_t getRelevantSize() const { return relevantIds.size(); }
+    const std::vector<std::uint32_t>& getIds() const { return ids; }
+    const std::vector<std::uint32_t>& getRelevantIds() const { return relevantIds; }
+    const std::vector<float>& getRelevantWeights() const { return relevantWeights; }
+
+    /**
+     * @brief Build vector from word frequency list sorted by weight.
+     */
+    void build(const WordFrequencyList& wfl, const Lexicon& lexicon, size_t relevantWords);
+
+    /**
+     * @brief Build vector from (unsorted, possibly duplicate) word IDs - moved to vector - and relevant words w/ weights.
+     *
+     * Used to build aggregated vector of more documents (e.g. O's Ns).
+     */
+    void build(std::vector<std::uint32_t>& ids, const std::vector<std::pair<std::uint32_t,float>>& relevant);
+
+    /**
+     * @brief Calculate weighted similarity of relevant words in <0,1>.
+     *
+     * Formula:
+     *   R(v)            ... relevant words of v
+     *   W(v)            ... all words of v
+     *   intersection    ... (R(v1) AND W(v2)) OR (R(v2) AND W(v1))
+     *   union           ... R(v1) OR R(v2)
+     *   similarity      ... weight(intersection) / weight(union)
+     */
+    static float similarity(const WordVector& v1, const WordVector& v2);
+
+private:
+    /**
+     * @brief Find word ID in sorted IDs starting at given position.
+     *
+     * Position is moved to the first ID which is not lower than searched ID, therefore
+     * ascending sequence of IDs can be searched in linear time (merge).
+     */
+    static bool find(const std::vector<std::uint32_t>& ids, size_t& position, std::uint32_t id);
+};
+
+}
+#endif // M8R_WORD_VECTOR_H
@@ -30,8 +30,19 @@ namespace m8r {
  */
 class Aspect
 {
+protected:
+    /**
+     * @brief Version is incremented on every aspect change.
+     *
+     * It allows to cache views filtered by the aspect.
+     */
+    unsigned long version;
+
 public:
+    explicit Aspect() : version{0} {}
+
     virtual bool isEnabled() const = 0;
+    unsigned long getVersion() const { return version; }
 };
 
 }
@@ -47,6 +47,15 @@ public:
     virtual bool isEnabled() const {
         return timeScope.isEnabled() || tagsScope.isEnabled();
     }
+    const TimeScopeAspect& getTimeScope() const { return timeScope; }
+    const TagsScopeAspect& getTagsScope() const { return tagsScope; }
+
+    /**
+     * @brief Composite version - changed whenever any of the aspects is changed.
+     */
+    unsigned long getVersion() const {
+        return timeScope.getVersion() + tagsScope.getVersion();
+    }
     bool isOutOfScope(const Outline* o) const {
         if(timeScope.isEnabled()) {
             if(timeScope.isOutOfScope(o)) {
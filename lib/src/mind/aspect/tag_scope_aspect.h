@@ -48,6 +48,7 @@ public:
 
     void setTags(const std::vector<const Tag*>& tags) {
         this->tags.assign(tags.begin(), tags.end());
+        version++;
     }
     void setTags(std::vector<std::string>& sTags) {
         tags.clear();
@@ -56,11 +57,12 @@ public:
                 tags.push_back(ontology.findOrCreateTag(s));
             }
         }
+        version++;
     }
     const std::vector<const Tag*>& getTags() const {
         return tags;
     }
-    void reset() { tags.clear(); }
+    void reset() { tags.clear(); version++; }
 
 private:
     bool inScope(const std::vector<const Tag*>* thingTags) const;
@@ -67,10 +67,12 @@ public:
         time(&now);
 
         timePoint = now-timeScope.relativeSecs;
+        version++;
     }
     TimeScope& getTimeScope() { return timeScope; }
+    time_t getTimePoint() const { return timePoint; }
     std::string getTimeScopeAsString();
-    void resetTimeScope() { timeScope.reset(); }
+    void resetTimeScope() { timeScope.reset(); version++; }
 
     void setTimePoint(time_t timePoint);
 };
@@ -0,0 +1,294 @@
+/*
+ link_graph.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "link_graph.h"
+
+#include "../config/configuration.h"
+#include "../gear/file_utils.h"
+#include "../gear/string_utils.h"
+
+namespace m8r {
+
+using namespace std;
+
+LinkGraph::LinkGraph()
+{
+    edgesCount = 0;
+}
+
+LinkGraph::~LinkGraph()
+{
+}
+
+void LinkGraph::clear()
+{
+    vertices.clear();
+    vertexIds.clear();
+    outlineVertices.clear();
+    forward.clear();
+    reverse.clear();
+    edgesCount = 0;
+}
+
+string LinkGraph::normalizePath(const string& path)
+{
+    if(path.empty()) {
+        return path;
+    }
+
+    vector<string> segments{};
+    size_t b = 0, e;
+    do {
+        e = path.find(FILE_PATH_SEPARATOR_CHAR, b);
+        string segment = path.substr(b, e==string::npos?string::npos:e-b);
+        if(segment.empty() || !segment.compare(".")) {
+            // skip duplicate separator and current directory
+        } else if(!segment.compare("..")) {
+            if(segments.size() && segments.back().compare("..")) {
+                segments.pop_back();
+            } else if(path[0] != FILE_PATH_SEPARATOR_CHAR) {
+                segments.push_back(segment);
+            }
+        } else {
+            segments.push_back(segment);
+        }
+        b = e+1;
+    } while(e != string::npos);
+
+    string result{};
+    if(path[0] == FILE_PATH_SEPARATOR_CHAR) {
+        result += FILE_PATH_SEPARATOR_CHAR;
+    }
+    for(size_t i=0; i<segments.size(); i++) {
+        if(i) result += FILE_PATH_SEPARATOR_CHAR;
+        result += segments[i];
+    }
+    return result;
+}
+
+string LinkGraph::linkToVertexId(const string& sourceOutlineKey, const string& link)
+{
+    string target{link};
+    stringLeftTrim(target);
+    stringRightTrim(target);
+    // strip optional link title: [label](target "title")
+    size_t i = target.find(' ');
+    if(i != string::npos) {
+        target.erase(i);
+    }
+    if(target.empty() || stringStartsWith(target, "mailto:")) {
+        return string{};
+    }
+    if(target.find("://") != string::npos) {
+        if(stringStartsWith(target, "file://")) {
+            target.erase(0, 7);
+        } else {
+            return string{};
+        }
+    }
+
+    string path{}, anchor{};
+    if((i = target.find('#')) != string::npos) {
+        path = target.substr(0, i);
+        anchor = target.substr(i+1);
+    } else {
+        path = target;
+    }
+
+    if(path.empty()) {
+        // relative N link within the same O: #mangled-section-name
+        if(anchor.empty()) {
+            return string{};
+        }
+        path = sourceOutlineKey;
+    } else {
+        // only Markdown files can be Os
+        if(!stringEndsWith(path, FILE_EXTENSION_MD_MD)
+             && !stringEndsWith(path, FILE_EXTENSION_MD_MARKDOWN)
+             && !stringEndsWith(path, FILE_EXTENSION_MD_MDOWN)
+             && !stringEndsWith(path, FILE_EXTENSION_MD_MKDN))
+        {
+            return string{};
+        }
+        if(path[0] != FILE_PATH_SEPARATOR_CHAR) {
+            string directory{}, file{};
+            pathToDirectoryAndFile(sourceOutlineKey, directory, file);
+            directory += FILE_PATH_SEPARATOR_CHAR;
+            path.insert(0, directory);
+        }
+    }
+
+    string id = normalizePath(path);
+    if(anchor.size()) {
+        id += "#";
+        id += anchor;
+    }
+    return id;
+}
+
+void LinkGraph::addEdge(const string& sourceId, const string& targetId)
+{
+    if(!sourceId.compare(targetId)) {
+        return;
+    }
+
+    vector<string>& targets = forward[sourceId];
+    if(std::find(targets.begin(), targets.end(), targetId) == targets.end()) {
+        targets.push_back(targetId);
+        reverse[targetId].push_back(sourceId);
+        edgesCount++;
+    }
+}
+
+void LinkGraph::indexLinks(
+        const string& sourceId,
+        const string& outlineKey,
+        const vector<string*>& description,
+        const vector<Link*>& metadataLinks)
+{
+    // links (relationships) declared in metadata
+    for(Link* l:metadataLinks) {
+        string targetId = linkToVertexId(outlineKey, l->getUrl());
+        if(targetId.size()) {
+            addEdge(sourceId, targetId);
+        }
+    }
+
+    // inline Markdown links: [label](target) - code blocks are skipped
+    bool inCodeBlock = false;
+    for(const string* line:description) {
+        if(!line) continue;
+
+        if(stringStartsWith(*line, "```") || stringStartsWith(*line, "~~~")) {
+            inCodeBlock = !inCodeBlock;
+            continue;
+        }
+        if(inCodeBlock) continue;
+
+        size_t b = 0, e;
+        while((b = line->find("](", b)) != string::npos) {
+            b += 2;
+            if((e = line->find(')', b)) == string::npos) {
+                break;
+            }
+            string targetId = linkToVertexId(outlineKey, line->substr(b, e-b));
+            if(targetId.size()) {
+                addEdge(sourceId, targetId);
+            }
+            b = e;
+        }
+    }
+}
+
+void LinkGraph::index(Outline* outline)
+{
+    remove(outline);
+
+    vector<string>& ids = outlineVertices[outline];
+
+    // O is represented by its descriptor N
+    string oId = normalizePath(outline->getKey());
+    Note* descriptor = outline->getOutlineDescriptorAsNote();
+    if(vertices.insert(make_pair(oId, descriptor)).second) {
+        vertexIds[descriptor] = oId;
+        ids.push_back(oId);
+    }
+    indexLinks(oId, outline->getKey(), outline->getDescription(), outline->getLinks());
+
+    for(Note* n:outline->getNotes()) {
+        string nId{oId};
+        nId += "#";
+        nId += n->getMangledName();
+        // the 1st N wins if there are more Ns w/ the same mangled name (like GitHub does)
+        if(vertices.insert(make_pair(nId, n)).second) {
+            vertexIds[n] = nId;
+            ids.push_back(nId);
+        }
+        indexLinks(nId, outline->getKey(), n->getDescription(), n->getLinks());
+    }
+}
+
+void LinkGraph::remove(const Outline* outline)
+{
+    auto o = outlineVertices.find(outline);
+    if(o == outlineVertices.end()) {
+        return;
+    }
+
+    for(const string& id:o->second) {
+        auto v = vertices.find(id);
+        if(v != vertices.end()) {
+            vertexIds.erase(v->second);
+            vertices.erase(v);
+        }
+
+        // drop outgoing links, incoming links are kept as other Os still reference the N
+        auto f = forward.find(id);
+        if(f != forward.end()) {
+            for(const string& targetId:f->second) {
+                auto r = reverse.find(targetId);
+                if(r != reverse.end()) {
+                    r->second.erase(std::remove(r->second.begin(), r->second.end(), id), r->second.end());
+                    if(r->second.empty()) {
+                        reverse.erase(r);
+                    }
+                }
+                edgesCount--;
+            }
+            forward.erase(f);
+        }
+    }
+
+    outlineVertices.erase(o);
+}
+
+void LinkGraph::resolve(const vector<string>& ids, vector<Note*>& result, const Outline* scope) const
+{
+    for(const string& id:ids) {
+        auto v = vertices.find(id);
+        if(v != vertices.end()) {
+            if(!scope || v->second->getOutline() == scope) {
+                result.push_back(v->second);
+            }
+        } // else broken link
+    }
+}
+
+void LinkGraph::getReferencedNotes(const Note* note, vector<Note*>& result, const Outline* scope) const
+{
+    auto id = vertexIds.find(note);
+    if(id != vertexIds.end()) {
+        auto f = forward.find(id->second);
+        if(f != forward.end()) {
+            resolve(f->second, result, scope);
+        }
+    }
+}
+
+void LinkGraph::getRefereeNotes(const Note* note, vector<Note*>& result, const Outline* scope) const
+{
+    auto id = vertexIds.find(note);
+    if(id != vertexIds.end()) {
+        auto r = reverse.find(id->second);
+        if(r != reverse.end()) {
+            resolve(r->second, result, scope);
+        }
+    }
+}
+
+} // m8r namespace
@@ -0,0 +1,116 @@
+/*
+ link_graph.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_LINK_GRAPH_H
+#define M8R_LINK_GRAPH_H
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+#include "../debug.h"
+#include "../model/outline.h"
+#include "../model/note.h"
+
+namespace m8r {
+
+/**
+ * @brief Graph of (cross) references i.e. Markdown links among Os and Ns.
+ *
+ * Vertices are identified by target Outline key and Note mangled name (O#N) -
+ * exactly like Markdown links address them - while O itself is represented by
+ * its descriptor Note and identified just by O key. Both forward (outgoing)
+ * and reverse (incoming) adjacency is kept, therefore any references query
+ * costs O(degree) and no Memory scan is needed.
+ *
+ * Graph is built when Memory is learned and it's maintained incrementally
+ * i.e. an O is re-indexed whenever it's remembered (saved).
+ *
+ * Edges are stored by vertex ID (not by pointer) so that links to Os/Ns which
+ * do not exist (yet) are kept and resolved once target O/N is learned.
+ */
+class LinkGraph
+{
+private:
+    // vertex ID > N (including O descriptor Ns)
+    std::unordered_map<std::string,Note*> vertices;
+    // N > vertex ID
+    std::unordered_map<const Note*,std::string> vertexIds;
+    // O > IDs of vertices declared by the O (O descriptor + its Ns)
+    std::unordered_map<const Outline*,std::vector<std::string>> outlineVertices;
+
+    // source vertex ID > target vertex IDs (outgoing)
+    std::unordered_map<std::string,std::vector<std::string>> forward;
+    // target vertex ID > source vertex IDs (incoming)
+    std::unordered_map<std::string,std::vector<std::string>> reverse;
+
+    size_t edgesCount;
+
+public:
+    explicit LinkGraph();
+    LinkGraph(const LinkGraph&) = delete;
+    LinkGraph(const LinkGraph&&) = delete;
+    LinkGraph &operator=(const LinkGraph&) = delete;
+    LinkGraph &operator=(const LinkGraph&&) = delete;
+    ~LinkGraph();
+
+    size_t getVerticesCount() const { return vertices.size(); }
+    size_t getEdgesCount() const { return edgesCount; }
+
+    /**
+     * @brief Index O's and its Ns' links (O is removed first if already indexed).
+     */
+    void index(Outline* outline);
+
+    /**
+     * @brief Remove O, its Ns and their outgoing links from the graph.
+     */
+    void remove(const Outline* outline);
+
+    void clear();
+
+    /**
+     * @brief Get Ns referenced by the N (outgoing links) - ordered by occurence.
+     */
+    void getReferencedNotes(const Note* note, std::vector<Note*>& result, const Outline* scope=nullptr) const;
+
+    /**
+     * @brief Get Ns which reference the N (incoming links).
+     */
+    void getRefereeNotes(const Note* note, std::vector<Note*>& result, const Outline* scope=nullptr) const;
+
+    /**
+     * @brief Resolve link target (as written in Markdown) to vertex ID.
+     *
+     * Empty string is returned for external links (web, images, ...).
+     */
+    static std::string linkToVertexId(const std::string& sourceOutlineKey, const std::string& link);
+
+    /**
+     * @brief Lexically normalize path i.e. resolve . and .. and remove duplicate separators.
+     */
+    static std::string normalizePath(const std::string& path);
+
+private:
+    void indexLinks(const std::string& sourceId, const std::string& outlineKey, const std::vector<std::string*>& description, const std::vector<Link*>& metadataLinks);
+    void addEdge(const std::string& sourceId, const std::string& targetId);
+    void resolve(const std::vector<std::string>& ids, std::vector<Note*>& result, const Outline* scope) const;
+};
+
+}
+#endif // M8R_LINK_GRAPH_H
@@ -18,6 +18,7 @@
  */
 #include "memory.h"
 
+#include "../gear/datetime_utils.h"
 #include "../gear/string_utils.h"
 
 using namespace std;
@@ -32,6 +33,8 @@ Memory::Memory(Configuration& configuration)
     persistence = new FilesystemPersistence{representation};
     cache = true;
     mindScope = nullptr;
+    observer = nullptr;
+    outlinesWatermark = 0;
 }
 
 vector<Stencil*>& Memory::getStencils(ResourceType type)
@@ -127,8 +130,16 @@ void Memory::learn()
         } // else wrong number of files (typically none)
     }
 
+    for(Outline* outline:outlines) {
+        reindex(outline);
+    }
+    outlinesWatermark++;
+
 #ifdef DO_MF_DEBUG
     auto end = chrono::high_resolution_clock::now();
+    string s{};
+    statistics.toString(s);
+    MF_DEBUG("LEARNED " << s << endl);
     MF_DEBUG("LEARNED in " << chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0 << "ms" << endl);
 #endif
 }
@@ -136,8 +147,13 @@ void Memory::learn()
 void Memory::amnesia()
 {
     aware = false;
+    outlinesWatermark++;
 
     repositoryIndexer.clear();
+    linkGraph.clear();
+    statistics.clear();
+    timeIndex.clear();
+    memoryDwell.clear();
 
     // IMPROVE reset ontology i.e. clear custom types & keep only default ontology
     // ontology.reset();
@@ -189,6 +205,9 @@ void Memory::remember(const std::string& outlineKey)
         o->makeModified();
         o->checkAndFixProperties();
         persistence->save(o);
+        reindex(o);
+        // tags or timestamps might have changed
+        outlinesWatermark++;
     } else {
         throw MindForgerException{"Save: unable to find outline w/ given key"};
     }
@@ -209,10 +228,47 @@ void Memory::remember(Outline* outline)
         outlines.push_back(outline);
         outlinesMap.insert(map<string,Outline*>::value_type(outline->getKey(), outline));
     }
+    reindex(outline);
+    outlinesWatermark++;
+}
+
+void Memory::reindex(Outline* outline)
+{
+    linkGraph.index(outline);
+    statistics.update(outline);
+    timeIndex.index(outline);
+    memoryDwell.index(outline);
+    if(observer) {
+        observer->onReindex(outline);
+    }
+}
+
+void Memory::read(Outline* outline)
+{
+    outline->incReads();
+    outline->setRead(datetimeNow());
+    timeIndex.index(outline);
+}
+
+void Memory::read(Note* note)
+{
+    note->incReads();
+    note->setRead(datetimeNow());
+    if(note->getOutline()) {
+        timeIndex.index(note->getOutline());
+    }
 }
 
 void Memory::forget(Outline* outline)
 {
+    outlinesWatermark++;
+    linkGraph.remove(outline);
+    statistics.remove(outline);
+    timeIndex.remove(outline);
+    memoryDwell.remove(outline);
+    if(observer) {
+        observer->onForget(outline);
+    }
     outlinesMap.erase(outline->getKey());
     limboOutlines.push_back(outline);
     outlines.erase(std::remove(outlines.begin(), outlines.end(), outline), outlines.end());
@@ -242,22 +298,12 @@ unsigned Memory::getOutlinesCount() const
 
 unsigned Memory::getOutlineMarkdownsSize() const
 {
-    // IMPROVE introduce dirty flag (add/remove outline and recount only then)
-    unsigned int result{};
-    for(Outline* outline:outlines) {
-        result+=outline->getBytesize();
-    }
-    return result;
+    return statistics.getBytesCount();
 }
 
 unsigned Memory::getNotesCount() const
 {
-    // IMPROVE PERFORMANCE cache this number & introduce dirty flag (add/remove outline and recount only then)
-    unsigned int result{};
-    for(Outline* outline:outlines) {
-        result+=outline->getNotes().size();
-    }
-    return result;
+    return statistics.getNotesCount();
 }
 
 const vector<Outline*>& Memory::getOutlines() const
@@ -297,13 +343,30 @@ Outline* Memory::getOutline(const string& key)
 
 void Memory::getAllNotes(vector<Note*>& notes) const
 {
-    for(Outline* o:outlines) {
-        for(Note* n:o->getNotes()) {
-            if(mindScope) {
-                if(mindScope->isInScope(n)) {
-                    notes.push_back(n);
+    // Ns are scoped by time only (tags are not used w/ Ns) > binary search + range scan
+    if(mindScope && mindScope->getTimeScope().isEnabled()) {
+        vector<Note*> candidates{};
+        timeIndex.getNotesReadSince(mindScope->getTimeScope().getTimePoint(), candidates);
+        if(candidates.size()) {
+            // keep Memory order - only Os having a N in scope are visited
+            unordered_set<const Note*> inScope{candidates.begin(), candidates.end()};
+            unordered_set<const Outline*> inScopeOutlines{};
+            for(Note* n:candidates) {
+                inScopeOutlines.insert(n->getOutline());
+            }
+            for(Outline* o:outlines) {
+                if(inScopeOutlines.count(o)) {
+                    for(Note* n:o->getNotes()) {
+                        if(inScope.count(n)) {
+                            notes.push_back(n);
+                        }
+                    }
                 }
-            } else {
+            }
+        }
+    } else {
+        for(Outline* o:outlines) {
+            for(Note* n:o->getNotes()) {
                 notes.push_back(n);
             }
         }
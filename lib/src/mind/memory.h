@@ -21,6 +21,7 @@
 
 #include <vector>
 #include <map>
+#include <unordered_set>
 
 #include "../debug.h"
 #include "../exceptions.h"
@@ -37,9 +38,35 @@
 #include "../persistence/persistence.h"
 #include "../persistence/filesystem_persistence.h"
 #include "aspect/mind_scope_aspect.h"
+#include "link_graph.h"
+#include "memory_statistics.h"
+#include "time_index.h"
+#include "memory_dwell.h"
 
 namespace m8r {
 
+/**
+ * @brief Memory observer is notified whenever an O is (re)indexed or forgotten.
+ *
+ * It enables components which are not owned by Memory (like AI) to maintain
+ * their indices incrementally.
+ */
+class MemoryObserver
+{
+public:
+    virtual ~MemoryObserver() {}
+
+    /**
+     * @brief O and/or its Ns were learned, created, modified or deleted.
+     */
+    virtual void onReindex(Outline* outline) = 0;
+
+    /**
+     * @brief O is forgotten (moved to limbo) - O is still valid when observer is called.
+     */
+    virtual void onForget(Outline* outline) = 0;
+};
+
 class Memory
 {
 private:
@@ -74,6 +101,35 @@ private:
     // IMPROVE unordered_map
     std::map<std::string,Outline*> outlinesMap;
 
+    /**
+     * @brief Outgoing and incoming links of Os and Ns.
+     */
+    LinkGraph linkGraph;
+
+    /**
+     * @brief Incrementally maintained statistics of Os and Ns.
+     */
+    MemoryStatistics statistics;
+
+    /**
+     * @brief Os and Ns ordered by read and modified timestamps.
+     */
+    TimeIndex timeIndex;
+
+    /**
+     * @brief Ns ordered by their relevance to the present.
+     */
+    MemoryDwell memoryDwell;
+
+    MemoryObserver* observer;
+
+    /**
+     * @brief Outlines watermark is incremented whenever an O is learned, remembered or forgotten.
+     *
+     * This is a dirty flag used by Mind to evict Os views (e.g. scope filtered Os).
+     */
+    unsigned long outlinesWatermark;
+
 public:
     explicit Memory(Configuration& configuration);
     Memory(const Memory&) = delete;
@@ -83,6 +139,8 @@ public:
     virtual ~Memory();
 
     void setMindScope(MindScopeAspect* mindScopeAspect) { mindScope = mindScopeAspect; }
+    void setObserver(MemoryObserver* observer) { this->observer = observer; }
+    unsigned long getOutlinesWatermark() const { return outlinesWatermark; }
 
     /**
      * @brief Learn repository content.
@@ -116,11 +174,29 @@ public:
      */
     void remember(Outline* outline);
 
+    /**
+     * @brief Update indices (links, statistics, time, dwell, observer) of O changed in memory.
+     *
+     * This method is called on O remember, but it must be also called when O/Ns
+     * are modified in memory only (e.g. N created or deleted w/o saving O).
+     */
+    void reindex(Outline* outline);
+
     /**
      * @brief Forget Outline.
      */
     void forget(Outline* outline);
 
+    /**
+     * @brief Make O/N read now.
+     *
+     * Read counter and timestamp are updated and O is re-indexed in the time index
+     * so that time scoped views include just read O/N. This method must be called
+     * whenever O/N is shown to the user.
+     */
+    void read(Outline* outline);
+    void read(Note* note);
+
     /**
      * @brief Get Ontology.
      * @return Ontology
@@ -162,7 +238,10 @@ public:
     Outline* getOutline(const std::string &key);
 
     /**
-     * @brief Get notes of all outlines.
+     * @brief Get notes of all outlines (in Mind scope if set).
+     *
+     * Ns are in Memory order (Os order, then Ns order in O) - if time scope is set,
+     * then the time index is used to find Ns in scope w/o the check of every N.
      */
     void getAllNotes(std::vector<Note*>& notes) const;
 
@@ -172,6 +251,14 @@ public:
 
     void sortByName(std::vector<Outline*>& sorted);
     RepositoryIndexer& getRepositoryIndexer() { return repositoryIndexer; }
+    LinkGraph& getLinkGraph() { return linkGraph; }
+    const LinkGraph& getLinkGraph() const { return linkGraph; }
+    MemoryStatistics& getStatistics() { return statistics; }
+    const MemoryStatistics& getStatistics() const { return statistics; }
+    TimeIndex& getTimeIndex() { return timeIndex; }
+    const TimeIndex& getTimeIndex() const { return timeIndex; }
+    MemoryDwell& getMemoryDwell() { return memoryDwell; }
+    const MemoryDwell& getMemoryDwell() const { return memoryDwell; }
 
 private:
     const OutlineType* toOutlineType(const MarkdownAstSectionMetadata&);
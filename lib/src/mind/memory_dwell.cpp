@@ -20,13 +20,188 @@
 
 namespace m8r {
 
-MemoryDwell::MemoryDwell() {
-	// TODO Auto-generated constructor stub
+using namespace std;
 
+constexpr double MemoryDwell::WEIGHT_READ;
+constexpr double MemoryDwell::WEIGHT_WRITE;
+constexpr double MemoryDwell::HALF_LIFE;
+
+MemoryDwell::MemoryDwell(double halfLife)
+    : lambda{std::log(2.0)/halfLife}
+{
+}
+
+MemoryDwell::~MemoryDwell()
+{
+}
+
+void MemoryDwell::clear()
+{
+    heap.clear();
+    positions.clear();
+    outlineNotes.clear();
+}
+
+double MemoryDwell::logSumExp(double a, double b)
+{
+    if(a < b) {
+        std::swap(a, b);
+    }
+    if(b == -numeric_limits<double>::infinity()) {
+        return a;
+    }
+    return a + std::log1p(std::exp(b-a));
+}
+
+void MemoryDwell::swap(size_t i, size_t j)
+{
+    std::swap(heap[i], heap[j]);
+    positions[heap[i].note] = i;
+    positions[heap[j].note] = j;
+}
+
+void MemoryDwell::siftUp(size_t i)
+{
+    while(i) {
+        size_t parent = (i-1)/2;
+        if(heap[parent].key >= heap[i].key) {
+            break;
+        }
+        swap(i, parent);
+        i = parent;
+    }
+}
+
+void MemoryDwell::siftDown(size_t i)
+{
+    for(;;) {
+        size_t largest = i, l = 2*i+1, r = 2*i+2;
+        if(l < heap.size() && heap[l].key > heap[largest].key) largest = l;
+        if(r < heap.size() && heap[r].key > heap[largest].key) largest = r;
+        if(largest == i) {
+            break;
+        }
+        swap(i, largest);
+        i = largest;
+    }
+}
+
+void MemoryDwell::seed(Note* note)
+{
+    // persisted reads count is used as frequency of reads at the last read
+    double key = toKey(WEIGHT_READ*(1.0+std::log1p(note->getReads())), note->getRead());
+    key = logSumExp(key, toKey(WEIGHT_WRITE, note->getModified()));
+
+    positions[note] = heap.size();
+    heap.push_back(Entry{note, key, note->getModified()});
+    siftUp(heap.size()-1);
+}
+
+void MemoryDwell::event(const Note* note, double weight, time_t when)
+{
+    auto p = positions.find(note);
+    if(p != positions.end()) {
+        size_t i = p->second;
+        heap[i].key = logSumExp(heap[i].key, toKey(weight, when));
+        // relevance can only grow
+        siftUp(i);
+    }
+}
+
+void MemoryDwell::erase(const Note* note)
+{
+    auto p = positions.find(note);
+    if(p == positions.end()) {
+        return;
+    }
+
+    size_t i = p->second;
+    positions.erase(p);
+    if(i != heap.size()-1) {
+        heap[i] = heap.back();
+        positions[heap[i].note] = i;
+        heap.pop_back();
+        siftDown(i);
+        siftUp(i);
+    } else {
+        heap.pop_back();
+    }
 }
 
-MemoryDwell::~MemoryDwell() {
-	// TODO Auto-generated destructor stub
+void MemoryDwell::index(Outline* outline)
+{
+    vector<Note*>& indexed = outlineNotes[outline];
+    if(indexed.size()) {
+        unordered_set<const Note*> notes(outline->getNotes().begin(), outline->getNotes().end());
+        for(Note* n:indexed) {
+            // Ns deleted from O (pointer is not dereferenced)
+            if(notes.find(n) == notes.end()) {
+                erase(n);
+            }
+        }
+    }
+
+    for(Note* n:outline->getNotes()) {
+        auto p = positions.find(n);
+        if(p == positions.end()) {
+            seed(n);
+        } else if(heap[p->second].modified != n->getModified()) {
+            heap[p->second].modified = n->getModified();
+            write(n, n->getModified());
+        }
+    }
+    indexed = outline->getNotes();
+}
+
+void MemoryDwell::remove(const Outline* outline)
+{
+    auto o = outlineNotes.find(outline);
+    if(o != outlineNotes.end()) {
+        for(Note* n:o->second) {
+            erase(n);
+        }
+        outlineNotes.erase(o);
+    }
+}
+
+double MemoryDwell::getRelevance(const Note* note, time_t when) const
+{
+    auto p = positions.find(note);
+    if(p != positions.end()) {
+        return std::exp(heap[p->second].key - lambda*static_cast<double>(when));
+    } else {
+        return 0;
+    }
+}
+
+void MemoryDwell::getPage(vector<Note*>& result, size_t pageSize, size_t page) const
+{
+    if(heap.empty()) {
+        return;
+    }
+
+    size_t from, to;
+    if(pageSize) {
+        from = pageSize*page;
+        to = std::min(from+pageSize, heap.size());
+    } else {
+        from = 0;
+        to = heap.size();
+    }
+
+    // best-first traversal of the heap: only O(to) nodes are visited
+    priority_queue<pair<double,size_t>> frontier{};
+    frontier.push(make_pair(heap[0].key, 0));
+    for(size_t rank=0; rank<to && !frontier.empty(); rank++) {
+        size_t i = frontier.top().second;
+        frontier.pop();
+        if(rank >= from) {
+            result.push_back(heap[i].note);
+        }
+        size_t l = 2*i+1, r = 2*i+2;
+        if(l < heap.size()) frontier.push(make_pair(heap[l].key, l));
+        if(r < heap.size()) frontier.push(make_pair(heap[r].key, r));
+    }
 }
 
 } // m8r namespace
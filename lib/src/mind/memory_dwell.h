@@ -19,12 +19,120 @@
 #ifndef M8R_MEMORY_DWELL_H_
 #define M8R_MEMORY_DWELL_H_
 
+#include <cmath>
+#include <ctime>
+#include <limits>
+#include <queue>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "../debug.h"
+#include "../model/outline.h"
+#include "../model/note.h"
+#include "../gear/datetime_utils.h"
+
 namespace m8r {
 
-class MemoryDwell {
+/**
+ * @brief Memory dwell - Ns ordered by their relevance to the present.
+ *
+ * N relevance is a sum of N reads and writes (modifications) weights where
+ * each event weight decays exponentially w/ its age (half-life). Deeper N is,
+ * less relevant it is.
+ *
+ * Decay is the same for all Ns, therefore relevance is not stored, but its
+ * time invariant logarithm ln(relevance(t)) + lambda*t is used as the key
+ * (no re-scoring of Ns is needed as time goes). Ns are kept in an indexed
+ * max-heap: read/write event is O(log n) and the most relevant page of Ns
+ * is retrieved in O(page*log(page)) time.
+ *
+ * Memory dwell is seeded from persisted N timestamps and reads when Memory
+ * is learned and it's maintained incrementally on N read and O remember.
+ */
+class MemoryDwell
+{
 public:
-	MemoryDwell();
-	virtual ~MemoryDwell();
+    static constexpr double WEIGHT_READ = 1.0;
+    static constexpr double WEIGHT_WRITE = 3.0;
+    // 2 weeks
+    static constexpr double HALF_LIFE = 14.0*24.0*60.0*60.0;
+
+private:
+    struct Entry {
+        Note* note;
+        double key;
+        time_t modified;
+    };
+
+    // decay constant: ln(2)/half-life
+    const double lambda;
+
+    // max-heap by key
+    std::vector<Entry> heap;
+    // N > heap position
+    std::unordered_map<const Note*,size_t> positions;
+    // O > its indexed Ns
+    std::unordered_map<const Outline*,std::vector<Note*>> outlineNotes;
+
+public:
+    explicit MemoryDwell(double halfLife=HALF_LIFE);
+    MemoryDwell(const MemoryDwell&) = delete;
+    MemoryDwell(const MemoryDwell&&) = delete;
+    MemoryDwell &operator=(const MemoryDwell&) = delete;
+    MemoryDwell &operator=(const MemoryDwell&&) = delete;
+    ~MemoryDwell();
+
+    size_t size() const { return heap.size(); }
+
+    /**
+     * @brief Index O's Ns.
+     *
+     * New Ns are seeded from their read/reads/modified properties, known Ns
+     * w/ changed modification timestamp get write event and Ns which are no
+     * longer in the O are removed.
+     */
+    void index(Outline* outline);
+
+    /**
+     * @brief Remove O's Ns.
+     */
+    void remove(const Outline* outline);
+
+    void clear();
+
+    /**
+     * @brief Record N read.
+     */
+    void read(const Note* note, time_t when=datetimeNow()) { event(note, WEIGHT_READ, when); }
+    /**
+     * @brief Record N write.
+     */
+    void write(const Note* note, time_t when=datetimeNow()) { event(note, WEIGHT_WRITE, when); }
+
+    /**
+     * @brief Get N relevance at given time (0 for unknown N).
+     */
+    double getRelevance(const Note* note, time_t when=datetimeNow()) const;
+
+    /**
+     * @brief Get page of the most relevant Ns - ordered by relevance.
+     *
+     * Use pageSize 0 to get all Ns.
+     */
+    void getPage(std::vector<Note*>& result, size_t pageSize, size_t page=0) const;
+
+private:
+    double toKey(double weight, time_t when) const { return lambda*static_cast<double>(when) + std::log(weight); }
+    static double logSumExp(double a, double b);
+
+    void seed(Note* note);
+    void event(const Note* note, double weight, time_t when);
+    void erase(const Note* note);
+
+    void siftUp(size_t i);
+    void siftDown(size_t i);
+    void swap(size_t i, size_t j);
 };
 
 } // m8r namespace
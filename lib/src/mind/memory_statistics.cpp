@@ -0,0 +1,124 @@
+/*
+ memory_statistics.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "memory_statistics.h"
+
+namespace m8r {
+
+using namespace std;
+
+MemoryStatistics::MemoryStatistics()
+    : contributions{},
+      tags{}
+{
+    notesCount = bytesCount = wordsCount = tagsCount = 0;
+}
+
+MemoryStatistics::~MemoryStatistics()
+{
+}
+
+unsigned MemoryStatistics::countWords(const string& s)
+{
+    unsigned result = 0;
+    bool inWord = false;
+    for(const char c:s) {
+        if(c==' ' || c=='\t' || c=='\n' || c=='\r') {
+            inWord = false;
+        } else if(!inWord) {
+            inWord = true;
+            result++;
+        }
+    }
+    return result;
+}
+
+unsigned MemoryStatistics::countWords(const vector<string*>& description)
+{
+    unsigned result = 0;
+    for(const string* line:description) {
+        if(line) {
+            result += countWords(*line);
+        }
+    }
+    return result;
+}
+
+void MemoryStatistics::update(const Outline* outline)
+{
+    remove(outline);
+
+    OutlineContribution& c = contributions[outline];
+    c.notes = outline->getNotes().size();
+    c.bytes = outline->getBytesize();
+    c.words = countWords(outline->getName()) + countWords(outline->getDescription());
+    c.tags.assign(outline->getTags()->begin(), outline->getTags()->end());
+    for(const Note* n:outline->getNotes()) {
+        c.words += countWords(n->getName()) + countWords(n->getDescription());
+        c.tags.insert(c.tags.end(), n->getTags()->begin(), n->getTags()->end());
+    }
+
+    notesCount += c.notes;
+    bytesCount += c.bytes;
+    wordsCount += c.words;
+    tagsCount += c.tags.size();
+    for(const Tag* t:c.tags) {
+        tags[t]++;
+    }
+}
+
+void MemoryStatistics::remove(const Outline* outline)
+{
+    auto c = contributions.find(outline);
+    if(c == contributions.end()) {
+        return;
+    }
+
+    notesCount -= c->second.notes;
+    bytesCount -= c->second.bytes;
+    wordsCount -= c->second.words;
+    tagsCount -= c->second.tags.size();
+    for(const Tag* t:c->second.tags) {
+        auto i = tags.find(t);
+        if(i != tags.end() && !--i->second) {
+            tags.erase(i);
+        }
+    }
+
+    contributions.erase(c);
+}
+
+void MemoryStatistics::clear()
+{
+    contributions.clear();
+    tags.clear();
+    notesCount = bytesCount = wordsCount = tagsCount = 0;
+}
+
+void MemoryStatistics::toString(string& s) const
+{
+    std::ostringstream os;
+    os << "outlines: " << getOutlinesCount()
+       << ", notes: " << notesCount
+       << ", bytes: " << bytesCount
+       << ", words: " << wordsCount
+       << ", tags: " << tagsCount << " (" << tags.size() << " distinct)";
+    s.assign(os.str());
+}
+
+} // m8r namespace
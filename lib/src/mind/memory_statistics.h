@@ -0,0 +1,115 @@
+/*
+ memory_statistics.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_MEMORY_STATISTICS_H
+#define M8R_MEMORY_STATISTICS_H
+
+#include <map>
+#include <string>
+#include <sstream>
+#include <vector>
+#include <unordered_map>
+
+#include "../debug.h"
+#include "../model/outline.h"
+
+namespace m8r {
+
+/**
+ * @brief Memory statistics - counts and sizes of Memory's Os, Ns, words and tags.
+ *
+ * Statistics are maintained incrementally: every O contribution is recorded
+ * when the O is learned/remembered and subtracted when the O is forgotten or
+ * updated. Therefore all getters are O(1) and no Memory scan is needed (even
+ * if statistics are shown after every user action).
+ */
+class MemoryStatistics
+{
+private:
+    struct OutlineContribution {
+        unsigned notes;
+        unsigned bytes;
+        unsigned words;
+        std::vector<const Tag*> tags;
+    };
+
+    // O > its contribution to statistics
+    std::unordered_map<const Outline*,OutlineContribution> contributions;
+    // tag > number of Os and Ns tagged w/ the tag
+    std::map<const Tag*,unsigned> tags;
+
+    unsigned notesCount;
+    unsigned bytesCount;
+    unsigned wordsCount;
+    unsigned tagsCount;
+
+public:
+    explicit MemoryStatistics();
+    MemoryStatistics(const MemoryStatistics&) = delete;
+    MemoryStatistics(const MemoryStatistics&&) = delete;
+    MemoryStatistics &operator=(const MemoryStatistics&) = delete;
+    MemoryStatistics &operator=(const MemoryStatistics&&) = delete;
+    ~MemoryStatistics();
+
+    /**
+     * @brief Add O contribution (O contribution is replaced if O is already known).
+     */
+    void update(const Outline* outline);
+
+    /**
+     * @brief Subtract O contribution.
+     */
+    void remove(const Outline* outline);
+
+    void clear();
+
+    unsigned getOutlinesCount() const { return contributions.size(); }
+    unsigned getNotesCount() const { return notesCount; }
+    /**
+     * @brief Get the size of O Markdowns in bytes.
+     */
+    unsigned getBytesCount() const { return bytesCount; }
+    /**
+     * @brief Get the number of words in names and descriptions of Os and Ns.
+     */
+    unsigned getWordsCount() const { return wordsCount; }
+    /**
+     * @brief Get the number of tag usages i.e. how many times Os and Ns were tagged.
+     */
+    unsigned getTagsCount() const { return tagsCount; }
+    /**
+     * @brief Get the number of distinct tags used by Os and Ns.
+     */
+    unsigned getDistinctTagsCount() const { return tags.size(); }
+
+    /**
+     * @brief Dump statistics e.g. for monitoring and debugging.
+     */
+    void toString(std::string& s) const;
+
+    /**
+     * @brief Count whitespace delimited words.
+     */
+    static unsigned countWords(const std::string& s);
+
+private:
+    static unsigned countWords(const std::vector<std::string*>& description);
+};
+
+}
+#endif // M8R_MEMORY_STATISTICS_H
@@ -28,11 +28,16 @@ Mind::Mind(Configuration &configuration)
       exclusiveMind{},
       timeScopeAspect{},
       tagsScopeAspect{memory.getOntology()},
-      scopeAspect{timeScopeAspect, tagsScopeAspect}
+      scopeAspect{timeScopeAspect, tagsScopeAspect},
+      scopedOutlines{}
 {
     ai = new Ai{memory,*this};
     deleteWatermark = 0;
     activeProcesses = 0;
+    scopedOutlinesScopeVersion
+        = scopedOutlinesMemoryWatermark
+        = scopedOutlinesTimeIndexVersion
+        = numeric_limits<unsigned long>::max();
 
     timeScopeAspect.setTimeScope(config.getTimeScope());
     tagsScopeAspect.setTags(config.getTagsScope());
@@ -79,17 +84,9 @@ shared_future<bool> Mind::think()
     lock_guard<mutex> criticalSection{exclusiveMind};
 
     if(config.getMindState()==Configuration::MindState::SLEEPING) {
-        if(config.getAsyncMindThreshold() > memory.getNotesCount()) {
-            // get ready for thinking - dream() changes state to THINKING on its finish
-            return mindDream();
-        } else {
-            // IMPROVE design ASYNC AI/AA to handle also huge repositories
-            MF_DEBUG("Think: CANNOT think because number of Notes in Mind is too big" << endl);
-            persistMindState(Configuration::MindState::SLEEPING);
-            promise<bool> p;
-            p.set_value(false);
-            return p.get_future();
-        }
+        // get ready for thinking - dream() changes state to THINKING on its finish,
+        // repositories w/ more Ns than async threshold are dreamed in the background
+        return mindDream();
     } else {
         MF_DEBUG("Think: CANNOT think because Mind is DREAMING or already THINKING (asleep first)" << endl);
         promise<bool> p;
@@ -153,7 +150,6 @@ bool Mind::mindSleep()
         // AI can asleep ONLY if there are no active mental processes
         if(ai->sleep()) {
             allNotesCache.clear();
-            memoryDwell.clear();
             triples.clear();
 
             MF_DEBUG("Mind IS sleeping..." << endl);
@@ -164,11 +160,20 @@ bool Mind::mindSleep()
         }
     } else {
         MF_DEBUG("Sleep: CANNOT asleep because Mind is DREAMING (wait for " << activeProcesses << " dreaming processes to finish)" << endl);
-        // DREAMING cannot be cancelled > wait for dream() to finish before calling sleep() again.
+        // DREAMING is interrupted after the current chunk > interrupted dream is resumed by think,
+        // while sleep() called again discards its progress.
+        if(config.getMindState()==Configuration::MindState::DREAMING) {
+            ai->interruptDream();
+        }
         return false;
     }
 }
 
+int Mind::getDreamProgress() const
+{
+    return ai->getDreamProgress();
+}
+
 bool Mind::amnesia()
 {
     MF_DEBUG("@Amnesia" << endl);
@@ -186,7 +191,10 @@ shared_future<bool> Mind::getAssociatedNotes(const Note* n, vector<pair<Note*,fl
     MF_DEBUG("@NoteAssociations" << endl);
     lock_guard<mutex> criticalSection{exclusiveMind};
 
-    if(config.getMindState()==Configuration::MindState::THINKING) {
+    // associations of already dreamed Ns are provided while DREAMING
+    if(config.getMindState()==Configuration::MindState::THINKING
+         || config.getMindState()==Configuration::MindState::DREAMING)
+    {
         return ai->getAssociatedNotes(n, associations);
     } else {
         associations.clear();
@@ -226,6 +234,47 @@ shared_future<bool> Mind::getAssociatedNotes(const string& words, vector<pair<No
     }
 }
 
+void Mind::setTaskListener(function<void()> listener)
+{
+    // no exclusive access needed - listener is guarded by AI
+    ai->setTaskListener(listener);
+}
+
+void Mind::acceptAssociation(const Note* n, const Note* accepted, const vector<pair<Note*,float>>& leaderboard)
+{
+    MF_DEBUG("@AcceptAssociation" << endl);
+    lock_guard<mutex> criticalSection{exclusiveMind};
+
+    ai->acceptAssociation(n, accepted, leaderboard);
+}
+
+void Mind::findNearDuplicateNotes(vector<vector<Note*>>& clusters)
+{
+    MF_DEBUG("@NearDuplicateNotes" << endl);
+
+    // Ns are snapshotted under lock - signing and clustering (long) run w/o it
+    vector<Note*> notes{};
+    vector<string> descriptions{};
+    {
+        lock_guard<mutex> criticalSection{exclusiveMind};
+        memory.getAllNotes(notes);
+        descriptions.reserve(notes.size());
+        for(Note* n:notes) {
+            descriptions.push_back(n->getDescriptionAsString());
+        }
+    }
+
+    vector<vector<size_t>> indices{};
+    ai->findNearDuplicateNotes(descriptions, indices);
+    clusters.clear();
+    for(vector<size_t>& cluster:indices) {
+        clusters.push_back(vector<Note*>{});
+        for(size_t i:cluster) {
+            clusters.back().push_back(notes[i]);
+        }
+    }
+}
+
 /*
  *  This method does NOT need mutex because it's private and it's called from Mind only
  */
@@ -249,16 +298,14 @@ bool Mind::mindAmnesia()
  * REMEMBERING
  */
 
-const vector<Note*>& Mind::getMemoryDwell(int pageSize) const
+void Mind::getMemoryDwell(vector<Note*>& result, int pageSize, int page) const
 {
-    UNUSED_ARG(pageSize);
-
-    return memoryDwell;
+    memory.getMemoryDwell().getPage(result, pageSize==ALL_ENTRIES?0:pageSize, page);
 }
 
 size_t Mind::getMemoryDwellDepth() const
 {
-    return memoryDwell.size();
+    return memory.getMemoryDwell().size();
 }
 
 vector<Note*>* Mind::findNoteByNameFts(const string& regexp) const
@@ -383,32 +430,30 @@ vector<Note*>* Mind::findNoteFts(const string& regexp, const bool ignoreCase, Ou
 
 vector<Note*>* Mind::getReferencedNotes(const Note& note) const
 {
-    UNUSED_ARG(note);
-
-    return nullptr;
+    vector<Note*>* result = new vector<Note*>();
+    memory.getLinkGraph().getReferencedNotes(&note, *result);
+    return result;
 }
 
 vector<Note*>* Mind::getReferencedNotes(const Note& note, const Outline& outline) const
 {
-    UNUSED_ARG(note);
-    UNUSED_ARG(outline);
-
-    return nullptr;
+    vector<Note*>* result = new vector<Note*>();
+    memory.getLinkGraph().getReferencedNotes(&note, *result, &outline);
+    return result;
 }
 
 vector<Note*>* Mind::getRefereeNotes(const Note& note) const
 {
-    UNUSED_ARG(note);
-
-    return nullptr;
+    vector<Note*>* result = new vector<Note*>();
+    memory.getLinkGraph().getRefereeNotes(&note, *result);
+    return result;
 }
 
 vector<Note*>* Mind::getRefereeNotes(const Note& note, const Outline& outline) const
 {
-    UNUSED_ARG(note);
-    UNUSED_ARG(outline);
-
-    return nullptr;
+    vector<Note*>* result = new vector<Note*>();
+    memory.getLinkGraph().getRefereeNotes(&note, *result, &outline);
+    return result;
 }
 
 void Mind::findNoteByTags(const std::vector<const Tag*>& tags, std::vector<Note*>& result) const
@@ -417,22 +462,47 @@ void Mind::findNoteByTags(const std::vector<const Tag*>& tags, std::vector<Note*
     UNUSED_ARG(result);
 }
 
-const vector<Outline*>& Mind::getOutlines() const
-{
-    // IMPROVE PERF use dirty flag to avoid result-rebuilt
-    static vector<Outline*> result{};
-
-    if(scopeAspect.isEnabled()) {
-        result.clear();
-        for(Outline* o:memory.getOutlines()) {
-            if(scopeAspect.isInScope(o)) {
-                result.push_back(o);
+shared_ptr<const vector<Outline*>> Mind::getOutlines() const
+{
+    lock_guard<mutex> criticalSection{scopedOutlinesMutex};
+
+    if(!scopedOutlines
+         || scopedOutlinesScopeVersion != scopeAspect.getVersion()
+         || scopedOutlinesMemoryWatermark != memory.getOutlinesWatermark()
+         || scopedOutlinesTimeIndexVersion != memory.getTimeIndex().getVersion())
+    {
+        vector<Outline*>* outlines = new vector<Outline*>{};
+        if(scopeAspect.isEnabled()) {
+            if(timeScopeAspect.isEnabled()) {
+                vector<Outline*> candidates{};
+                memory.getTimeIndex().getOutlinesReadSince(timeScopeAspect.getTimePoint(), candidates);
+                if(candidates.size()) {
+                    // keep Memory order
+                    unordered_set<const Outline*> inTimeScope{candidates.begin(), candidates.end()};
+                    for(Outline* o:memory.getOutlines()) {
+                        if(inTimeScope.count(o)
+                             && (!tagsScopeAspect.isEnabled() || tagsScopeAspect.isInScope(o)))
+                        {
+                            outlines->push_back(o);
+                        }
+                    }
+                }
+            } else {
+                for(Outline* o:memory.getOutlines()) {
+                    if(scopeAspect.isInScope(o)) {
+                        outlines->push_back(o);
+                    }
+                }
             }
+        } else {
+            *outlines = memory.getOutlines();
         }
-        return result;
-    } else {
-        return memory.getOutlines();
+        scopedOutlines.reset(outlines);
+        scopedOutlinesScopeVersion = scopeAspect.getVersion();
+        scopedOutlinesMemoryWatermark = memory.getOutlinesWatermark();
+        scopedOutlinesTimeIndexVersion = memory.getTimeIndex().getVersion();
     }
+    return scopedOutlines;
 }
 
 vector<Outline*>* Mind::getOutlinesOfType(const OutlineType& type) const
@@ -688,6 +758,7 @@ Note* Mind::noteNew(
         n->completeProperties(n->getModified());
 
         o->addNote(n, NO_PARENT==offset?0:offset);
+        memory.reindex(o);
         return n;
     } else {
         throw MindForgerException("Outline for given key not found!");
@@ -698,7 +769,9 @@ Note* Mind::noteClone(const string& outlineKey, const Note* newNote)
 {
     Outline* o = memory.getOutline(outlineKey);
     if(o) {
-        return o->cloneNote(newNote);
+        Note* n = o->cloneNote(newNote);
+        memory.reindex(o);
+        return n;
     } else {
         throw MindForgerException("Outline for given key not found!");
     }
@@ -738,7 +811,14 @@ Outline* Mind::noteForget(Note* note)
     if(o) {
         deleteWatermark++;
 
+        // N and its children must be dropped by AI before they're deallocated
+        vector<Note*> forgotten{note};
+        o->getNoteChildren(note, &forgotten);
+        ai->onForget(forgotten);
+
         note->getOutline()->forgetNote(note);
+        // forgotten Ns must not be resolved as link targets/sources
+        memory.reindex(o);
         return o;
     } else {
         throw MindForgerException("Unable find Outline from which should be the Note deleted!");
@@ -805,6 +885,12 @@ bool Mind::isNerInitilized() const
 
 void Mind::recognizePersons(const Outline* outline, int entityFilter, std::vector<NerNamedEntity>& result) {
     ai->recognizePersons(outline, entityFilter, result);
+    // index the rest of memory so that memory-wide queries are instant (once per NER model load)
+    ai->recognizeInBackground(memory.getOutlines());
+}
+
+void Mind::recognizePersons(int entityFilter, std::vector<NerNamedEntity>& result) {
+    ai->recognizePersons(memory.getOutlines(), entityFilter, result);
 }
 
 #endif
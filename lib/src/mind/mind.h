@@ -20,6 +20,8 @@
 #define M8R_MIND_H_
 
 #include <inttypes.h>
+#include <atomic>
+#include <limits>
 #include <memory>
 #include <mutex>
 
@@ -61,7 +63,7 @@ constexpr auto NO_PARENT = 0xFFFF;
  *     V
  *  DREAMING
  *     |         ... automatically switches to THINKING once DREAMING is done,
- *     |             user/API caller cannot change DREAMING to different state
+ *     |             sleep() interrupts dreaming (SLEEPING) and think() resumes it
  *     V
  *  THINKING
  *     |
@@ -93,6 +95,8 @@ constexpr auto NO_PARENT = 0xFFFF;
  * relationships are inferred to Triples as well, etc. Once Memory is processed
  * to Mind, it's checked (for Triples integrity), optimized (redundant Triples
  * are removed). Dreaming is idle when Mind is ready to wake up.
+ *   Memory is dreamed in chunks in the background, therefore Mind provides
+ * associations of already dreamed Notes even when dreaming huge repositories.
  *
  * Mind's flow of thoughts cannot be stopped when awake, it can just be slowed
  * down for instance by meditation.
@@ -134,9 +138,9 @@ private:
     int deleteWatermark;
 
     /**
-     * @brief Active mental processes.
+     * @brief Active mental processes (AI tasks finish in executor threads).
      */
-    int activeProcesses;
+    std::atomic<int> activeProcesses;
 
     /**
      * Where the mind thinks.
@@ -160,14 +164,6 @@ private:
      */
     std::vector<Triple*> triples;
 
-    /**
-     * @brief Notes time machine.
-     *
-     * This member represents memory dwell - a structure of Notes that represents their
-     * relevance to the present. Deeper Note is, less relevant it is.
-     */
-    std::vector<Note*> memoryDwell;
-
     /**
      * @brief Cache of all Notes across all Outlines: built on FTS traversal, evicted on
      * any save/modification/delete.
@@ -187,6 +183,18 @@ private:
      */
     MindScopeAspect scopeAspect;
 
+    /**
+     * @brief Snapshot of Os in Mind scope: rebuilt only if scope or Memory Os changed.
+     *
+     * Snapshot is immutable - it's replaced (never modified) under the mutex so that
+     * it can be shared by GUI and worker threads (AI, distributor).
+     */
+    mutable std::mutex scopedOutlinesMutex;
+    mutable std::shared_ptr<const std::vector<Outline*>> scopedOutlines;
+    mutable unsigned long scopedOutlinesScopeVersion;
+    mutable unsigned long scopedOutlinesMemoryWatermark;
+    mutable unsigned long scopedOutlinesTimeIndexVersion;
+
 public:
     explicit Mind(Configuration &config);
     Mind() = delete;
@@ -229,10 +237,17 @@ public:
     /**
      * @brief Sleep to clear Mind, keep Memory and relax.
      *
-     * Memory is kept, but Mind is cleared. No thinking or dreaming.
+     * Memory is kept, but Mind is cleared. No thinking or dreaming. If Mind
+     * is DREAMING, then dreaming is interrupted (after the current chunk) and
+     * false is returned - next think() resumes dreaming.
      */
     bool sleep();
 
+    /**
+     * @brief Get dreaming progress in percent.
+     */
+    int getDreamProgress() const;
+
     /**
      * @brief Forget everything e.g. when MF creates a new empty repository.
      */
@@ -258,8 +273,22 @@ public:
      */
 
     bool isNerInitilized() const;
+
+    /**
+     * @brief Recognize named entities in O (in order of occurrence).
+     *
+     * Entities are cached until O is modified. Once NER is initialized, the rest
+     * of memory is indexed in the background.
+     */
     void recognizePersons(const Outline* outline, int entityFilter, std::vector<NerNamedEntity>& result);
 
+    /**
+     * @brief Recognize named entities in memory (distinct entities w/ the best score ordered by name).
+     *
+     * Entities are found in entity index - instant once memory is indexed.
+     */
+    void recognizePersons(int entityFilter, std::vector<NerNamedEntity>& result);
+
 #endif
 
     /*
@@ -279,10 +308,10 @@ public:
     /**
      * @brief Get memory dwell.
      *
-     * Get all Notes ordered by their importance in memory and
-     * trimmed by forgetting threshold.
+     * Get page of Notes ordered by their relevance to the present - recently
+     * and frequently read and written Notes are the most relevant.
      */
-    const std::vector<Note*>& getMemoryDwell(int pageSize = ALL_ENTRIES) const;
+    void getMemoryDwell(std::vector<Note*>& result, int pageSize = ALL_ENTRIES, int page = 0) const;
     size_t getMemoryDwellDepth() const;
 
     /*
@@ -319,6 +348,9 @@ public:
 
     /**
      * @brief Get Notes references by note (outgoing).
+     *
+     * References are served from Memory's link graph in O(degree), caller
+     * owns (deletes) the result.
      */
     std::vector<Note*>* getReferencedNotes(const Note& note) const;
     std::vector<Note*>* getReferencedNotes(const Note& note, const Outline& outline) const;
@@ -388,7 +420,17 @@ public:
      */
 
     // IMPROVE rename to getAllOs()
-    const std::vector<Outline*>& getOutlines() const;
+    /**
+     * @brief Get Os in Mind scope (all Os if scope is not set).
+     *
+     * Scope filtered Os are cached - the cache is evicted when scope, Memory
+     * Os or the time index (O/N read) change. Os are in Memory order.
+     *
+     * Returned snapshot is immutable and it's safe to use it from any thread - a scope
+     * or Memory Os change creates a new snapshot. Os themselves are NOT protected
+     * by the snapshot i.e. use Mind's lock to access Os which might be forgotten.
+     */
+    std::shared_ptr<const std::vector<Outline*>> getOutlines() const;
     std::vector<Outline*>* getOutlinesOfType(const OutlineType& type) const;
 
     void getAllNotes(std::vector<Note*>& notes) const;
@@ -418,6 +460,33 @@ public:
      */
     std::shared_future<bool> getAssociatedNotes(const std::string& word, std::vector<std::pair<Note*,float>>& associations, const Note* self=nullptr);
 
+    /**
+     * @brief Set listener notified (in AI thread) whenever a future returned by think()
+     * or getAssociatedNotes(), which was not ready, becomes ready.
+     *
+     * Listener enables frontends to wait for results w/o polling futures. It must be fast
+     * and must not call Mind (nullptr to unset).
+     */
+    void setTaskListener(std::function<void()> listener);
+
+    /**
+     * @brief Remember that user followed association of N to accepted N in the leaderboard.
+     *
+     * Associations followed by user (and those skipped) are used to train AA model
+     * when Mind dreams next time.
+     */
+    void acceptAssociation(const Note* n, const Note* accepted, const std::vector<std::pair<Note*,float>>& leaderboard);
+
+    /**
+     * @brief Find clusters of near-duplicate Ns (Ns w/ nearly the same description).
+     *
+     * Clusters are ordered by size (the biggest first). Mind doesn't have to be
+     * thinking as no AA is needed. Can be LONG running on huge repositories, therefore
+     * it's run by worker - Mind is locked only while Ns' descriptions are copied and
+     * caller must ensure that Ns are not deleted until clusters are used.
+     */
+    void findNearDuplicateNotes(std::vector<std::vector<Note*>>& clusters);
+
     // TODO rework methods below: leaderboard to be removed, methods below to be used
 
     /**
@@ -0,0 +1,115 @@
+/*
+ time_index.cpp     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#include "time_index.h"
+
+namespace m8r {
+
+using namespace std;
+
+TimeIndex::TimeIndex()
+    : version{0}
+{
+}
+
+TimeIndex::~TimeIndex()
+{
+}
+
+void TimeIndex::clear()
+{
+    version++;
+    outlinesByRead.clear();
+    outlinesByModified.clear();
+    notesByRead.clear();
+    notesByModified.clear();
+    outlineTimestamps.clear();
+    noteTimestamps.clear();
+}
+
+void TimeIndex::index(Outline* outline)
+{
+    remove(outline);
+    version++;
+
+    Timestamps t{outline->getRead(), outline->getModified()};
+    outlineTimestamps[outline] = t;
+    outlinesByRead.insert(make_pair(t.read, outline));
+    outlinesByModified.insert(make_pair(t.modified, outline));
+
+    vector<pair<Note*,Timestamps>>& ns = noteTimestamps[outline];
+    ns.reserve(outline->getNotesCount());
+    for(Note* n:outline->getNotes()) {
+        t.read = n->getRead();
+        t.modified = n->getModified();
+        ns.push_back(make_pair(n, t));
+        notesByRead.insert(make_pair(t.read, n));
+        notesByModified.insert(make_pair(t.modified, n));
+    }
+}
+
+void TimeIndex::remove(const Outline* outline)
+{
+    auto o = outlineTimestamps.find(outline);
+    if(o == outlineTimestamps.end()) {
+        return;
+    }
+    version++;
+
+    // const is safe to be cast away - pointer is used as the key only
+    Outline* key = const_cast<Outline*>(outline);
+    outlinesByRead.erase(make_pair(o->second.read, key));
+    outlinesByModified.erase(make_pair(o->second.modified, key));
+    outlineTimestamps.erase(o);
+
+    auto ns = noteTimestamps.find(outline);
+    if(ns != noteTimestamps.end()) {
+        for(pair<Note*,Timestamps>& n:ns->second) {
+            notesByRead.erase(make_pair(n.second.read, n.first));
+            notesByModified.erase(make_pair(n.second.modified, n.first));
+        }
+        noteTimestamps.erase(ns);
+    }
+}
+
+void TimeIndex::getOutlinesReadSince(time_t timePoint, vector<Outline*>& result) const
+{
+    since(outlinesByRead, timePoint, result);
+}
+
+void TimeIndex::getNotesReadSince(time_t timePoint, vector<Note*>& result) const
+{
+    since(notesByRead, timePoint, result);
+}
+
+void TimeIndex::getNotesModifiedSince(time_t timePoint, vector<Note*>& result) const
+{
+    since(notesByModified, timePoint, result);
+}
+
+void TimeIndex::getRecentOutlines(size_t count, vector<Outline*>& result) const
+{
+    recent(outlinesByModified, count, result);
+}
+
+void TimeIndex::getRecentNotes(size_t count, vector<Note*>& result) const
+{
+    recent(notesByModified, count, result);
+}
+
+} // m8r namespace
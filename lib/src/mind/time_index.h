@@ -0,0 +1,132 @@
+/*
+ time_index.h     MindForger thinking notebook
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+*/
+#ifndef M8R_TIME_INDEX_H
+#define M8R_TIME_INDEX_H
+
+#include <ctime>
+#include <set>
+#include <vector>
+#include <utility>
+#include <unordered_map>
+
+#include "../debug.h"
+#include "../model/outline.h"
+#include "../model/note.h"
+
+namespace m8r {
+
+/**
+ * @brief Os and Ns ordered by read and modified timestamps.
+ *
+ * Time scoped queries (like Ns read after a time point) are a binary search
+ * followed by a range scan - instead of the check of every O/N - and recently
+ * modified Os/Ns listings come from the same ordered structures.
+ *
+ * Index is built when Memory is learned and it's maintained incrementally
+ * i.e. an O (and its Ns) is re-indexed whenever it's remembered (saved) or read.
+ * Indexed timestamps are kept per O/N so that the old entries can be found
+ * and removed even if O/N timestamps were changed in the meantime.
+ */
+class TimeIndex
+{
+private:
+    struct Timestamps {
+        time_t read;
+        time_t modified;
+    };
+
+    std::set<std::pair<time_t,Outline*>> outlinesByRead;
+    std::set<std::pair<time_t,Outline*>> outlinesByModified;
+    std::set<std::pair<time_t,Note*>> notesByRead;
+    std::set<std::pair<time_t,Note*>> notesByModified;
+
+    // O > indexed timestamps of the O
+    std::unordered_map<const Outline*,Timestamps> outlineTimestamps;
+    // O > its Ns and their indexed timestamps
+    std::unordered_map<const Outline*,std::vector<std::pair<Note*,Timestamps>>> noteTimestamps;
+
+    // incremented on every index change - dirty flag for time scoped views
+    unsigned long version;
+
+public:
+    explicit TimeIndex();
+    TimeIndex(const TimeIndex&) = delete;
+    TimeIndex(const TimeIndex&&) = delete;
+    TimeIndex &operator=(const TimeIndex&) = delete;
+    TimeIndex &operator=(const TimeIndex&&) = delete;
+    ~TimeIndex();
+
+    size_t getOutlinesCount() const { return outlinesByRead.size(); }
+    size_t getNotesCount() const { return notesByRead.size(); }
+    unsigned long getVersion() const { return version; }
+
+    /**
+     * @brief Index O and its Ns (O is removed first if already indexed).
+     */
+    void index(Outline* outline);
+
+    /**
+     * @brief Remove O and its Ns from the index.
+     */
+    void remove(const Outline* outline);
+
+    void clear();
+
+    /**
+     * @brief Get Os read at or after the time point - ordered from the oldest.
+     */
+    void getOutlinesReadSince(time_t timePoint, std::vector<Outline*>& result) const;
+    /**
+     * @brief Get Ns read at or after the time point - ordered from the oldest.
+     */
+    void getNotesReadSince(time_t timePoint, std::vector<Note*>& result) const;
+    /**
+     * @brief Get Ns modified at or after the time point - ordered from the oldest.
+     */
+    void getNotesModifiedSince(time_t timePoint, std::vector<Note*>& result) const;
+
+    /**
+     * @brief Get (at most count) recently modified Os - ordered from the most recent.
+     */
+    void getRecentOutlines(size_t count, std::vector<Outline*>& result) const;
+    /**
+     * @brief Get (at most count) recently modified Ns - ordered from the most recent.
+     */
+    void getRecentNotes(size_t count, std::vector<Note*>& result) const;
+
+private:
+    template<typename T>
+    static void since(const std::set<std::pair<time_t,T*>>& ordered, time_t timePoint, std::vector<T*>& result)
+    {
+        for(auto i = ordered.lower_bound(std::make_pair(timePoint, static_cast<T*>(nullptr))); i != ordered.end(); ++i) {
+            result.push_back(i->second);
+        }
+    }
+
+    template<typename T>
+    static void recent(const std::set<std::pair<time_t,T*>>& ordered, size_t count, std::vector<T*>& result)
+    {
+        for(auto i = ordered.rbegin(); i != ordered.rend() && count; ++i, --count) {
+            result.push_back(i->second);
+        }
+    }
+};
+
+}
+#endif // M8R_TIME_INDEX_H
@@ -118,7 +118,7 @@ Outline::Outline(const Outline& o)
         tags.insert(tags.end(), o.tags.begin(), o.tags.end());
     }
 
-    outlineDescriptorAsNote = nullptr;
+    outlineDescriptorAsNote = new Note(&NOTE_4_OUTLINE_TYPE, this);
 
     flags = o.flags;
     dirty = o.dirty;
@@ -73,6 +73,7 @@ void FilesystemPersistence::save(Outline* outline)
         std::ofstream out(outline->getKey());
         out << *text;
         out.close();
+        outline->setBytesize(text->size());
         delete text;
 
         outline->clearDirty();
@@ -43,6 +43,9 @@ constexpr const auto CONFIG_SETTING_MIND_STATE = "* Mind state: ";
 constexpr const auto CONFIG_SETTING_MIND_TIME_SCOPE_LABEL = "* Time scope: ";
 constexpr const auto CONFIG_SETTING_MIND_TAGS_SCOPE_LABEL = "* Tags scope: ";
 constexpr const auto CONFIG_SETTING_MIND_DISTRIBUTOR_INTERVAL = "* Async refresh interval (ms): ";
+constexpr const auto CONFIG_SETTING_MIND_AI_THREADS = "* AI threads: ";
+constexpr const auto CONFIG_SETTING_MIND_AI_STEMMER_LANGUAGE = "* AI stemmer language: ";
+constexpr const auto CONFIG_SETTING_MIND_AI_EMBEDDINGS = "* AI word embeddings: ";
 
 // repositories
 constexpr const auto CONFIG_SETTING_ACTIVE_REPOSITORY_LABEL = "* Active repository: ";
@@ -236,6 +239,30 @@ void MarkdownConfigurationRepresentation::configuration(string* title, vector<st
                         }
                         i %=10000;
                         c.setDistributorSleepInterval(i);
+                    } else if(line->find(CONFIG_SETTING_MIND_AI_THREADS) != std::string::npos) {
+                        string t = line->substr(strlen(CONFIG_SETTING_MIND_AI_THREADS));
+                        int i;
+                        try {
+                          i = std::stoi(t);
+                        }
+                        catch(...) {
+                          i = Configuration::DEFAULT_AI_THREADS;
+                        }
+                        if(i<0) {
+                            i = Configuration::DEFAULT_AI_THREADS;
+                        }
+                        c.setAiThreads(i);
+                    } else if(line->find(CONFIG_SETTING_MIND_AI_STEMMER_LANGUAGE) != std::string::npos) {
+                        string t = line->substr(strlen(CONFIG_SETTING_MIND_AI_STEMMER_LANGUAGE));
+                        stringRightTrim(t);
+                        if(t.empty()) {
+                            t.assign(Configuration::DEFAULT_AI_STEMMER_LANGUAGE);
+                        }
+                        c.setAiStemmerLanguage(t);
+                    } else if(line->find(CONFIG_SETTING_MIND_AI_EMBEDDINGS) != std::string::npos) {
+                        string t = line->substr(strlen(CONFIG_SETTING_MIND_AI_EMBEDDINGS));
+                        stringRightTrim(t);
+                        c.setAiEmbeddingsPath(t);
                     }
                 }
             }
@@ -322,6 +349,16 @@ string& MarkdownConfigurationRepresentation::to(Configuration* c, string& md)
          CONFIG_SETTING_MIND_DISTRIBUTOR_INTERVAL << (c?c->getDistributorSleepInterval():Configuration::DEFAULT_DISTRIBUTOR_SLEEP_INTERVAL+1) << endl <<
          "    * Sleep interval (miliseconds) between asynchronous mind-related evaluations (associations, ...)" << endl <<
          "    * Examples: 3000, 5000, 10000" << endl <<
+         CONFIG_SETTING_MIND_AI_THREADS << (c?c->getAiThreads():Configuration::DEFAULT_AI_THREADS) << endl <<
+         "    * Number of threads used by AI computations (associations, ...), 0 means number of CPU cores" << endl <<
+         "    * Examples: 0, 2, 4" << endl <<
+         CONFIG_SETTING_MIND_AI_STEMMER_LANGUAGE << (c?c->getAiStemmerLanguage():Configuration::DEFAULT_AI_STEMMER_LANGUAGE) << endl <<
+         "    * Language of Notes used to stem words by AI" << endl <<
+         "    * Examples: english, german, french, spanish, italian, portuguese, dutch, danish, norwegian, swedish, finnish" << endl <<
+         CONFIG_SETTING_MIND_AI_EMBEDDINGS << (c?c->getAiEmbeddingsPath():"") << endl <<
+         "    * Word vectors used to associate Notes by meaning (synonyms), empty to disable" << endl <<
+         "    * Text file (GloVe format) is converted to binary file in cache directory when Mind dreams" << endl <<
+         "    * Examples: /home/me/glove/glove.6B.100d.txt" << endl <<
          endl <<
 
          "# " << CONFIG_SECTION_APP << endl <<
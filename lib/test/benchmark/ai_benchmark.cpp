@@ -19,10 +19,22 @@
 
 #include <string>
 #include <iostream>
+#include <vector>
+#include <cstdlib>
+#include <sstream>
+#include <locale>
+#include <codecvt>
 
 #include <gtest/gtest.h>
 
+#include "../../src/install/installer.h"
+#include "../../src/gear/file_utils.h"
 #include "../../src/mind/mind.h"
+#include "../../src/mind/ai/ai_aa_bow.h"
+#include "../../src/mind/ai/nlp/word_vector.h"
+#include "../../src/mind/ai/nlp/markdown_tokenizer.h"
+#include "../../src/mind/ai/nlp/stemmer/stemmer.h"
+#include "../../src/gear/work_stealing_pool.h"
 
 using namespace std;
 using namespace m8r;
@@ -31,8 +43,8 @@ extern char* getMindforgerGitHomePath();
 
 /*
  * Performance improvements ideas:
- *   - IF |notes|>1000 THEN split aaMatrix rows to launch(CPU-1) tasks > start thread for each task > join threads (thread x down ~ 80% down)
- *   - compute above aaMatrix diagonal values only (2x faster ~ 50% down)
+ *   - IF |notes|>1000 THEN split aaMatrix rows to launch(CPU-1) tasks > start thread for each task > join threads (thread x down ~ 80% down) ... DONE w/ WorkStealingPool
+ *   - compute above aaMatrix diagonal values only (2x faster ~ 50% down) ... DONE
  *   - use trie instead of map in lexicon (10% faster ~ 10% down)
  *   - heuristics:
  *     - codereview calculateSimilarityByWords() > WordFrequencyList::evalUnion/Intersection must be MUCH faster
@@ -66,20 +78,259 @@ TEST(AiBenchmark, DISABLED_AaMatrix)
     ASSERT_LE(1, mind.remind().getOutlinesCount());
 
     /*
-     * Tokenize repository > make AI to think > find the most similar Notes pair
+     * Tokenize repository > make AI to think > calculate AA matrix w/ 1, 2, 4, ... threads
      */
 
+    config.setAaAlgorithm(m8r::Configuration::AssociationAssessmentAlgorithm::BOW);
+    m8r::AiAaBoW aa{mind.remind(), mind};
+
     auto beginDream = chrono::high_resolution_clock::now();
+    ASSERT_TRUE(aa.dream().get());
+    auto endDream = chrono::high_resolution_clock::now();
+    cout << "Dream DONE in " << chrono::duration_cast<chrono::microseconds>(endDream-beginDream).count()/1000.0 << "ms" << endl;
 
-    // TODO to be rewritten mind.dream();
+    double serialMs = 0;
+    size_t cores = m8r::WorkStealingPool::getCpuCoresCount();
+    for(size_t threads=1; threads<=cores; threads*=2) {
+        auto begin = chrono::high_resolution_clock::now();
+        aa.precalculateAa(threads);
+        auto end = chrono::high_resolution_clock::now();
+        double ms = chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0;
+        if(threads == 1) {
+            serialMs = ms;
+        }
+        cout << "AA matrix " << aa.getAaSize() << "x" << aa.getAaSize()
+             << " w/ " << threads << " thread(s): " << ms << "ms"
+             << " (speedup " << (ms>0?serialMs/ms:0) << "x)" << endl;
+    }
+}
 
-    auto endDream = chrono::high_resolution_clock::now();
-    MF_DEBUG(endl << "Dream DONE in " << chrono::duration_cast<chrono::microseconds>(endDream-beginDream).count()/1000.0 << "ms" << endl);
-
-    // get the best associations of N
-    m8r::Note* n=mind.remind().getOutlines()[0]->getNotes()[0];
-    UNUSED_ARG(n);
-    std::vector<std::pair<m8r::Note*,float>> lb{};
-    // TODO to be rewritten mind.getAssociationsLeaderboard(n, lb);
-    // TODO to be rewritten m8r::Ai::print(n,lb);
+/*
+ * Think as you WRITE w/ AA BoW: latency of words > Ns and O > Ns associations on
+ * 20k Ns (generated repository w/ skewed word distribution) - target is <50ms.
+ */
+TEST(AiBenchmark, DISABLED_AaWordsAndOutline)
+{
+    const int OUTLINES = 40;
+    const int NOTES = 500;
+    const int WORDS = 20000;
+    const int NOTE_WORDS = 40;
+
+    string repositoryDir{"/tmp/mf-benchmark-repository-aa-words"};
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+    m8r::Installer installer{};
+    installer.createEmptyMindForgerRepository(repositoryDir);
+    srand(42);
+    for(int o=0; o<OUTLINES; o++) {
+        string md{"# Outline "};
+        md += std::to_string(o);
+        md += "\n";
+        for(int n=0; n<NOTES; n++) {
+            md += "\n## Note " + std::to_string(o) + " " + std::to_string(n) + "\n";
+            for(int w=0; w<NOTE_WORDS; w++) {
+                // skewed distribution ~ some words are frequent
+                md += " w" + std::to_string((rand()%WORDS) * (rand()%WORDS) / WORDS);
+            }
+            md += "\n";
+        }
+        m8r::stringToFile(repositoryDir+"/memory/outline-"+std::to_string(o)+".md", md);
+    }
+
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-aib-awo.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)));
+    config.setAaAlgorithm(m8r::Configuration::AssociationAssessmentAlgorithm::BOW);
+    config.setAsyncMindThreshold(OUTLINES*NOTES+1);
+    m8r::Mind mind(config);
+    ASSERT_TRUE(mind.learn());
+    ASSERT_TRUE(mind.think().get());
+    ASSERT_EQ(OUTLINES*NOTES, mind.remind().getNotesCount());
+
+    const int QUERIES = 100;
+    double wordsMs = 0, outlineMs = 0;
+    size_t associations = 0;
+    for(int q=0; q<QUERIES; q++) {
+        string words{};
+        for(int w=0; w<3; w++) {
+            words += " w" + std::to_string(rand()%WORDS);
+        }
+        vector<pair<m8r::Note*,float>> leaderboard{};
+        auto begin = chrono::high_resolution_clock::now();
+        mind.getAssociatedNotes(words, leaderboard);
+        auto end = chrono::high_resolution_clock::now();
+        wordsMs = std::max(wordsMs, chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0);
+        associations += leaderboard.size();
+
+        leaderboard.clear();
+        begin = chrono::high_resolution_clock::now();
+        mind.getAssociatedNotes(mind.remind().getOutlines()[q%OUTLINES], leaderboard);
+        end = chrono::high_resolution_clock::now();
+        outlineMs = std::max(outlineMs, chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0);
+        associations += leaderboard.size();
+    }
+
+    cout << "Associations of " << QUERIES << " queries on " << OUTLINES*NOTES << " Ns (" << associations << " associations):" << endl
+         << "  words  : " << wordsMs << "ms (max)" << endl
+         << "  outline: " << outlineMs << "ms (max)" << endl;
+    EXPECT_GT(50., wordsMs);
+    EXPECT_GT(50., outlineMs);
+
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+}
+
+/*
+ * Similarity by words of the most relevant words: map based WordFrequencyList (original
+ * implementation) vs. sorted sparse WordVector.
+ */
+static float legacySimilarityByWords(m8r::Lexicon& lexicon, m8r::WordFrequencyList& v1, m8r::WordFrequencyList& v2, int threshold)
+{
+    m8r::WordFrequencyList intersection{&lexicon};
+    float iWeight=0, uWeight=0;
+    int t=0;
+    for(auto e:v1.iterableByWeight()) {
+        if(t++>=threshold) break;
+        float w = lexicon.getWeight(lexicon.getId(e->first));
+        uWeight += w;
+        if(v2.contains(e->first)) {
+            iWeight += w;
+            intersection.add(e->first);
+        }
+    }
+    t=0;
+    for(auto e:v2.iterableByWeight()) {
+        if(t++>=threshold) break;
+        if(!intersection.contains(e->first)) {
+            float w = lexicon.getWeight(lexicon.getId(e->first));
+            uWeight += w;
+            if(v1.contains(e->first)) {
+                iWeight += w;
+            }
+        }
+    }
+    return uWeight>0?iWeight/uWeight:0;
+}
+
+TEST(AiBenchmark, DISABLED_WordSimilarity)
+{
+    const int WORDS = 5000;
+    const int DOCS = 2000;
+    const int DOC_WORDS = 60;
+    const int THRESHOLD = 10;
+
+    m8r::Lexicon lexicon{};
+    vector<m8r::WordFrequencyList*> lists{};
+    srand(42);
+    for(int d=0; d<DOCS; d++) {
+        m8r::WordFrequencyList* l = new m8r::WordFrequencyList{&lexicon};
+        for(int w=0; w<DOC_WORDS; w++) {
+            // skewed distribution ~ some words are frequent
+            int word = (rand()%WORDS) * (rand()%WORDS) / WORDS;
+            l->add(&lexicon.getWord(lexicon.add("w"+std::to_string(word))));
+        }
+        lists.push_back(l);
+    }
+    lexicon.recalculateWeights();
+    vector<m8r::WordVector> vectors(DOCS);
+    for(int d=0; d<DOCS; d++) {
+        lists[d]->sort();
+        vectors[d].build(*lists[d], lexicon, THRESHOLD);
+    }
+
+    float legacySum=0, sum=0;
+    auto begin = chrono::high_resolution_clock::now();
+    for(int y=0; y<DOCS; y++) {
+        for(int x=y+1; x<DOCS; x++) {
+            legacySum += legacySimilarityByWords(lexicon, *lists[x], *lists[y], THRESHOLD);
+        }
+    }
+    auto end = chrono::high_resolution_clock::now();
+    double legacyMs = chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0;
+
+    begin = chrono::high_resolution_clock::now();
+    for(int y=0; y<DOCS; y++) {
+        for(int x=y+1; x<DOCS; x++) {
+            sum += m8r::WordVector::similarity(vectors[x], vectors[y]);
+        }
+    }
+    end = chrono::high_resolution_clock::now();
+    double ms = chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0;
+
+    cout << "Similarity of " << DOCS*(DOCS-1)/2 << " pairs:" << endl
+         << "  WordFrequencyList: " << legacyMs << "ms" << endl
+         << "  WordVector       : " << ms << "ms (speedup " << (ms>0?legacyMs/ms:0) << "x)" << endl;
+    EXPECT_NEAR(legacySum, sum, legacySum/1000.);
+
+    for(auto l:lists) {
+        delete l;
+    }
+}
+
+/*
+ * Stemming of benchmark repository vocabulary (each word occurrence is stemmed): original
+ * implementation (UTF-8 codec conversion of every word) vs. memoized Stemmer w/ ASCII fast path.
+ */
+static string legacyStem(stemming::english_stem<>& stemEnglish, wstring_convert<codecvt_utf8_utf16<wchar_t>>& converter, const string& word)
+{
+    std::wstringstream swide;
+    swide << word.c_str();
+    wstring wide = swide.str();
+    stemEnglish(wide);
+    return converter.to_bytes(wide);
+}
+
+TEST(AiBenchmark, DISABLED_Stemmer)
+{
+    string repositoryPath{"/lib/test/resources/benchmark-repository"};
+    repositoryPath.insert(0, getMindforgerGitHomePath());
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-aib-s.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)));
+    m8r::Mind mind(config);
+    ASSERT_TRUE(mind.learn());
+    ASSERT_LE(1, mind.remind().getOutlinesCount());
+
+    // vocabulary w/ word frequencies
+    m8r::Lexicon lexicon{};
+    m8r::CommonWordsBlacklist blacklist{};
+    m8r::MarkdownTokenizer tokenizer{lexicon, blacklist};
+    vector<m8r::Note*> notes{};
+    mind.remind().getAllNotes(notes);
+    for(m8r::Note* n:notes) {
+        m8r::WordFrequencyList wfl{&lexicon};
+        tokenizer.tokenize(n, wfl, true, true, false);
+    }
+    vector<const string*> tokens{};
+    for(uint32_t id=0; id<lexicon.size(); id++) {
+        for(int f=0; f<lexicon.getFrequency(id); f++) {
+            tokens.push_back(&lexicon.getWord(id));
+        }
+    }
+    ASSERT_LT(0, tokens.size());
+
+    stemming::english_stem<> stemEnglish{};
+    wstring_convert<codecvt_utf8_utf16<wchar_t>> converter{};
+    size_t legacyChars=0;
+    auto begin = chrono::high_resolution_clock::now();
+    for(const string* t:tokens) {
+        legacyChars += legacyStem(stemEnglish, converter, *t).size();
+    }
+    auto end = chrono::high_resolution_clock::now();
+    double legacyMs = chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0;
+
+    m8r::Stemmer stemmer{};
+    size_t chars=0;
+    begin = chrono::high_resolution_clock::now();
+    for(const string* t:tokens) {
+        chars += stemmer.stem(*t).size();
+    }
+    end = chrono::high_resolution_clock::now();
+    double ms = chrono::duration_cast<chrono::microseconds>(end-begin).count()/1000.0;
+
+    cout << "Stemming of " << tokens.size() << " tokens (" << lexicon.size() << " words):" << endl
+         << "  wstring_convert: " << legacyMs << "ms" << endl
+         << "  Stemmer        : " << ms << "ms (speedup " << (ms>0?legacyMs/ms:0) << "x)" << endl;
+    EXPECT_EQ(legacyChars, chars);
+    EXPECT_EQ(lexicon.size(), stemmer.getCacheSize());
 }
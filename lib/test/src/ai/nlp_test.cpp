@@ -22,10 +22,17 @@
 #include <vector>
 #include <string>
 #include <map>
+#include <set>
+#include <algorithm>
+#include <functional>
 
 #include "../../../src/config/configuration.h"
+#include "../../../src/install/installer.h"
+#include "../../../src/gear/file_utils.h"
 #include "../../../src/mind/mind.h"
 #include "../../../src/mind/ai/ai.h"
+#include "../../../src/mind/ai/aa_matrix.h"
+#include "../../../src/mind/ai/aa_model.h"
 #include "../../../src/mind/ai/nlp/stemmer/stemmer.h"
 #include "../../../src/mind/ai/nlp/string_char_provider.h"
 #include "../../../src/mind/ai/nlp/note_char_provider.h"
@@ -33,6 +40,9 @@
 #include "../../../src/mind/ai/nlp/lexicon.h"
 #include "../../../src/mind/ai/nlp/word_frequency_list.h"
 #include "../../../src/mind/ai/nlp/bag_of_words.h"
+#include "../../../src/mind/ai/nlp/word_vector.h"
+#include "../../../src/mind/ai/nlp/word_embeddings.h"
+#include "../../../src/mind/ai/nlp/min_hash.h"
 
 #include <gtest/gtest.h>
 
@@ -61,6 +71,22 @@ TEST(AiNlpTestCase, Stemmer)
         cout << "Before: " << w << endl;
         cout << "After : " << sW << endl;
     }
+    ASSERT_EQ("learn", stemmer.stem("learning"));
+    ASSERT_EQ("machin", stemmer.stem("machine"));
+
+    // stems are memoized
+    ASSERT_EQ(words.size(), stemmer.getCacheSize());
+    const string& s1 = stemmer.stem("informational");
+    ASSERT_EQ(words.size(), stemmer.getCacheSize());
+    ASSERT_EQ(s1, stemmer.stem("informational"));
+
+    // non-ASCII words are decoded, language switch invalidates cache
+    ASSERT_EQ(m8r::Stemmer::GERMAN, m8r::Stemmer::toLanguage("German"));
+    ASSERT_EQ(m8r::Stemmer::ENGLISH, m8r::Stemmer::toLanguage("klingon"));
+    stemmer.setLanguage(m8r::Stemmer::GERMAN);
+    ASSERT_EQ(0, stemmer.getCacheSize());
+    ASSERT_EQ("haus", stemmer.stem("h\xC3\xA4user"));
+    ASSERT_EQ("haus", stemmer.stem("hauser"));
 }
 
 TEST(AiNlpTestCase, Lexicon)
@@ -69,19 +95,19 @@ TEST(AiNlpTestCase, Lexicon)
 
     lexicon.add("a5");
     ASSERT_EQ(1, lexicon.size());
-    ASSERT_EQ(1, lexicon.get("a5")->frequency);
+    ASSERT_EQ(1, lexicon.getFrequency(lexicon.getId("a5")));
 
     lexicon.add("a5");
     ASSERT_EQ(1, lexicon.size());
-    ASSERT_EQ(2, lexicon.get("a5")->frequency);
+    ASSERT_EQ(2, lexicon.getFrequency(lexicon.getId("a5")));
 
     string s{"a5"};
     lexicon.add(s);
     ASSERT_EQ(1, lexicon.size());
-    ASSERT_EQ(3, lexicon.get(s)->frequency);
+    ASSERT_EQ(3, lexicon.getFrequency(lexicon.getId(s)));
     lexicon.add(&s);
     ASSERT_EQ(1, lexicon.size());
-    ASSERT_EQ(4, lexicon.get(&s)->frequency);
+    ASSERT_EQ(4, lexicon.getFrequency(lexicon.getId(&s)));
 
     // adding more words for better weight calculation 5/3/2
     lexicon.add("a5");
@@ -95,12 +121,29 @@ TEST(AiNlpTestCase, Lexicon)
     lexicon.recalculateWeights();
     lexicon.print();
 
-    ASSERT_FLOAT_EQ(0.01, lexicon.get("a5")->weight);
-    ASSERT_FLOAT_EQ(0.4, lexicon.get("a3")->weight);
-    ASSERT_FLOAT_EQ(0.6, lexicon.get("a2")->weight);
+    ASSERT_FLOAT_EQ(0.01, lexicon.getWeight(lexicon.getId("a5")));
+    ASSERT_FLOAT_EQ(0.4, lexicon.getWeight(lexicon.getId("a3")));
+    ASSERT_FLOAT_EQ(0.6, lexicon.getWeight(lexicon.getId("a2")));
 
     // TODO weights: increase scale
 
+    // interning: dense IDs, stable word addresses (table is resized several times)
+    ASSERT_EQ(m8r::Lexicon::NO_WORD, lexicon.getId("unknown"));
+    const string* a5 = &lexicon.getWord(lexicon.getId("a5"));
+    for(int i=0; i<5000; i++) {
+        ASSERT_EQ(3+i, lexicon.add("w"+std::to_string(i)));
+    }
+    ASSERT_EQ(5003, lexicon.size());
+    for(int i=0; i<5000; i++) {
+        ASSERT_EQ(3+i, lexicon.getId("w"+std::to_string(i)));
+    }
+    ASSERT_EQ(a5, &lexicon.getWord(lexicon.getId("a5")));
+    ASSERT_EQ(5, lexicon.getFrequency(lexicon.getId("a5")));
+
+    lexicon.clear();
+    ASSERT_EQ(0, lexicon.size());
+    ASSERT_EQ(m8r::Lexicon::NO_WORD, lexicon.getId("a5"));
+
 }
 
 TEST(AiNlpTestCase, BowOutline)
@@ -163,6 +206,98 @@ TEST(AiNlpTestCase, BowOutline)
     ASSERT_EQ(1, bow.size());
 }
 
+TEST(AiNlpTestCase, TokenizerSpan)
+{
+    string text{"Self-awareness of -- Albert's [Universe](http://universe.com) \xC3\xA9t\xC3\xA9 ends with Einstein"};
+
+    m8r::Lexicon lexicon{};
+    m8r::CommonWordsBlacklist wordBlaclist{};
+    m8r::MarkdownTokenizer tokenizer{lexicon, wordBlaclist};
+
+    // char provider and span tokenization must be the same
+    m8r::StringCharProvider chars{text};
+    m8r::WordFrequencyList streamWfl{&lexicon};
+    tokenizer.tokenize(chars, streamWfl, false, true, false);
+    m8r::WordFrequencyList spanWfl{&lexicon};
+    tokenizer.tokenize(text.data(), text.data()+text.size(), spanWfl, false, true, false);
+    spanWfl.print();
+    ASSERT_EQ(9, spanWfl.size());
+    ASSERT_EQ(streamWfl.iterable(), spanWfl.iterable());
+
+    // hyphenated words are kept, high Unicode chars are delimiters, last word is NOT lost
+    ASSERT_NE(m8r::Lexicon::NO_WORD, lexicon.getId("self-awareness"));
+    ASSERT_NE(m8r::Lexicon::NO_WORD, lexicon.getId("universe"));
+    ASSERT_NE(m8r::Lexicon::NO_WORD, lexicon.getId("einstein"));
+    ASSERT_NE(m8r::Lexicon::NO_WORD, lexicon.getId("albert"));
+    ASSERT_EQ(m8r::Lexicon::NO_WORD, lexicon.getId("t"));
+}
+
+TEST(AiNlpTestCase, WordVector)
+{
+    m8r::Lexicon lexicon{};
+    const char* words[] = {"a", "b", "c", "d"};
+    const float weights[] = {0.9, 0.8, 0.1, 0.7};
+    for(int i=0; i<4; i++) {
+        lexicon.setWeight(lexicon.add(words[i]), weights[i]);
+    }
+    ASSERT_EQ(0, lexicon.getId("a"));
+    ASSERT_EQ(3, lexicon.getId("d"));
+
+    m8r::WordFrequencyList l1{&lexicon}, l2{&lexicon}, l3{&lexicon};
+    l1.add(&lexicon.getWord(lexicon.getId("a")));
+    l1.add(&lexicon.getWord(lexicon.getId("b")));
+    l1.add(&lexicon.getWord(lexicon.getId("c")));
+    l2.add(&lexicon.getWord(lexicon.getId("b")));
+    l2.add(&lexicon.getWord(lexicon.getId("c")));
+    l2.add(&lexicon.getWord(lexicon.getId("d")));
+    l1.sort();
+    l2.sort();
+    l3.sort();
+
+    // 2 relevant words: R(v1)={a,b}, R(v2)={b,d}
+    m8r::WordVector v1{}, v2{}, v3{};
+    v1.build(l1, lexicon, 2);
+    v2.build(l2, lexicon, 2);
+    v3.build(l3, lexicon, 2);
+    ASSERT_EQ(3, v1.size());
+    ASSERT_EQ(2, v1.getRelevantSize());
+
+    // intersection {b} ~ 0.8, union {a,b,d} ~ 2.4
+    EXPECT_FLOAT_EQ(0.8/2.4, m8r::WordVector::similarity(v1,v2));
+    EXPECT_FLOAT_EQ(m8r::WordVector::similarity(v1,v2), m8r::WordVector::similarity(v2,v1));
+    EXPECT_FLOAT_EQ(1., m8r::WordVector::similarity(v1,v1));
+    EXPECT_FLOAT_EQ(0., m8r::WordVector::similarity(v1,v3));
+
+    // long vectors (search of IDs in blocks) vs. brute force
+    m8r::Lexicon big{};
+    for(int i=0; i<200; i++) {
+        big.setWeight(big.add(std::to_string(i)), (i%17+1)/20.);
+    }
+    m8r::WordFrequencyList b1{&big}, b2{&big};
+    for(int i=0; i<200; i++) {
+        if(i%3==0) b1.add(&big.getWord(big.getId(std::to_string(i))));
+        if(i%5==0 || i%7==0) b2.add(&big.getWord(big.getId(std::to_string(i))));
+    }
+    b1.sort();
+    b2.sort();
+    m8r::WordVector bv1{}, bv2{};
+    bv1.build(b1, big, 10);
+    bv2.build(b2, big, 10);
+
+    std::set<uint32_t> r1{bv1.getRelevantIds().begin(),bv1.getRelevantIds().end()};
+    std::set<uint32_t> r2{bv2.getRelevantIds().begin(),bv2.getRelevantIds().end()};
+    float iWeight=0, uWeight=0;
+    for(uint32_t id=0; id<big.size(); id++) {
+        bool in1 = b1.contains(&big.getWord(id)), in2 = b2.contains(&big.getWord(id));
+        bool inR1 = r1.count(id), inR2 = r2.count(id);
+        if(inR1 || inR2) uWeight += big.getWeight(id);
+        if((inR1 && in2) || (inR2 && in1)) iWeight += big.getWeight(id);
+    }
+    ASSERT_LT(0, iWeight);
+    EXPECT_FLOAT_EQ(iWeight/uWeight, m8r::WordVector::similarity(bv1,bv2));
+    EXPECT_FLOAT_EQ(iWeight/uWeight, m8r::WordVector::similarity(bv2,bv1));
+}
+
 /*
  * AA: BoW
  */
@@ -285,21 +420,1008 @@ TEST(AiNlpTestCase, AaUniverseBow)
     ASSERT_EQ(9, leaderboard.size());
     ASSERT_EQ("Same Albert Einstein", leaderboard[0].first->getName());
     ASSERT_EQ("Universe", leaderboard[0].first->getOutline()->getName());
-    ASSERT_FLOAT_EQ(0.9, leaderboard[0].second);
+    // AA rankings are quantized (16-bit), title words: {albert, einstein} ~ {same, albert, einstein}
+    ASSERT_NEAR(0.9333, leaderboard[0].second, 0.0001);
     ASSERT_EQ("Same Albert Einstein", leaderboard[1].first->getName());
     ASSERT_EQ("Alternative Universe", leaderboard[1].first->getOutline()->getName());
 }
 
+TEST(AiNlpTestCase, AaWordsAndOutlineBow)
+{
+    string repositoryPath{"/lib/test/resources/aa-repository"};
+    repositoryPath.insert(0, getMindforgerGitHomePath());
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-antc-awob.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)));
+    config.setAaAlgorithm(m8r::Configuration::AssociationAssessmentAlgorithm::BOW);
+
+    m8r::Mind mind(config);
+    ASSERT_TRUE(mind.learn());
+    ASSERT_TRUE(mind.think().get());
+    m8r::Outline* u = mind.remind().getOutlines()[0];
+    m8r::Outline* a = mind.remind().getOutlines()[1];
+    if(u->getName().find("Alternative") != string::npos) {
+        std::swap(u, a);
+    }
+
+    // think as you WRITE: words > Ns (synchronous)
+    vector<pair<m8r::Note*,float>> leaderboard{};
+    shared_future<bool> f = mind.getAssociatedNotes("Einstein's theory of relativity", leaderboard);
+    ASSERT_EQ(future_status::ready, f.wait_for(chrono::microseconds(0)));
+    ASSERT_TRUE(f.get());
+    ASSERT_LE(2, leaderboard.size());
+    EXPECT_NE(string::npos, leaderboard[0].first->getName().find("Albert Einstein"));
+    for(size_t i=1; i<leaderboard.size(); i++) {
+        EXPECT_GE(leaderboard[i-1].second, leaderboard[i].second);
+    }
+    const m8r::Note* self = leaderboard[0].first;
+    leaderboard.clear();
+    ASSERT_TRUE(mind.getAssociatedNotes("Einstein's theory of relativity", leaderboard, self).get());
+    ASSERT_LT(0, leaderboard.size());
+    for(auto& l:leaderboard) {
+        EXPECT_NE(self, l.first);
+    }
+    // unknown words are not associated
+    leaderboard.clear();
+    ASSERT_TRUE(mind.getAssociatedNotes("xylophone zeppelin", leaderboard).get());
+    EXPECT_EQ(0, leaderboard.size());
+
+    // O > Ns of other Os
+    leaderboard.clear();
+    f = mind.getAssociatedNotes(a, leaderboard);
+    ASSERT_EQ(future_status::ready, f.wait_for(chrono::microseconds(0)));
+    ASSERT_TRUE(f.get());
+    ASSERT_LT(0, leaderboard.size());
+    EXPECT_NE(string::npos, leaderboard[0].first->getName().find("Albert Einstein"));
+    for(auto& l:leaderboard) {
+        EXPECT_EQ(u, l.first->getOutline());
+    }
+    leaderboard.clear();
+    ASSERT_TRUE(mind.getAssociatedNotes(u, leaderboard).get());
+    ASSERT_LT(0, leaderboard.size());
+    EXPECT_EQ("Same Albert Einstein", leaderboard[0].first->getName());
+    for(auto& l:leaderboard) {
+        EXPECT_EQ(a, l.first->getOutline());
+    }
+}
+
 /*
  * AA: FTS
  */
 
 TEST(AiNlpTestCase, AaRepositoryFts)
 {
-    // TODO AaRepositoryFts
+    string repositoryDir{"/tmp/mf-unit-repository-aa-fts"};
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+    m8r::Installer installer{};
+    installer.createEmptyMindForgerRepository(repositoryDir);
+    m8r::stringToFile(
+        repositoryDir+"/memory/alpha.md",
+        "# Alpha\nMindForger thinking.\n\n## Planet Orbit\nPlanets orbit the Sun. Orbit, orbit.\n\n## Guitar\nGuitar chord.\n");
+    m8r::stringToFile(
+        repositoryDir+"/memory/beta.md",
+        "# Beta\nAbout.\n\n## Orbital Mechanics\nKepler laws of planetary orbits.\n");
+
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-antc-arf.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)));
+    config.setAaAlgorithm(m8r::Configuration::AssociationAssessmentAlgorithm::WEIGHTED_FTS);
+
+    m8r::Mind mind(config);
+    ASSERT_TRUE(mind.learn());
+    m8r::Outline* alpha = mind.remind().getOutline(repositoryDir+"/memory/alpha.md");
+    m8r::Outline* beta = mind.remind().getOutline(repositoryDir+"/memory/beta.md");
+
+    m8r::AiAaWeightedFts aa{mind.remind(), mind};
+    ASSERT_TRUE(aa.dream().get());
+    ASSERT_LT(0, aa.getPostingsWordsCount());
+
+    // term is matched as substring of words: title 100, description 10 per occurrence
+    const m8r::Note* self = nullptr;
+    vector<pair<m8r::Note*,float>> leaderboard{};
+    ASSERT_TRUE(aa.getAssociatedNotes("Orbit", leaderboard, self).get());
+    ASSERT_EQ(2, leaderboard.size());
+    EXPECT_EQ("Planet Orbit", leaderboard[0].first->getName());
+    EXPECT_EQ("Orbital Mechanics", leaderboard[1].first->getName());
+    EXPECT_FLOAT_EQ(110./130., leaderboard[1].second);
+
+    // phrase
+    leaderboard.clear();
+    ASSERT_TRUE(aa.getAssociatedNotes("orbit the sun", leaderboard, self).get());
+    ASSERT_EQ(1, leaderboard.size());
+    EXPECT_EQ("Planet Orbit", leaderboard[0].first->getName());
+
+    // O match makes all its Ns associated
+    leaderboard.clear();
+    ASSERT_TRUE(aa.getAssociatedNotes("mind", leaderboard, self).get());
+    ASSERT_EQ(3, leaderboard.size());
+    EXPECT_EQ(alpha->getOutlineDescriptorAsNote(), leaderboard[0].first);
+
+    // fallback to words
+    leaderboard.clear();
+    ASSERT_TRUE(aa.getAssociatedNotes("kepler chord xyz", leaderboard, self).get());
+    ASSERT_EQ(2, leaderboard.size());
+
+    // postings are updated incrementally
+    alpha->getNotes()[1]->setName("Guitar Orbit");
+    aa.remember(alpha);
+    leaderboard.clear();
+    ASSERT_TRUE(aa.getAssociatedNotes("orbit", leaderboard, self).get());
+    ASSERT_EQ(3, leaderboard.size());
+    aa.forget(beta);
+    leaderboard.clear();
+    ASSERT_TRUE(aa.getAssociatedNotes("orbit", leaderboard, self).get());
+    ASSERT_EQ(2, leaderboard.size());
+    for(auto& a:leaderboard) {
+        EXPECT_EQ(alpha, a.first->getOutline());
+    }
+    leaderboard.clear();
+    ASSERT_FALSE(aa.getAssociatedNotes("kepler", leaderboard, self).get());
+
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
 }
 
 TEST(AiNlpTestCase, AaUniverseFts)
 {
     // TODO AaUniverseFts
 }
+
+TEST(AiNlpTestCase, AaParallelBow)
+{
+    string repositoryPath{"/lib/test/resources/universe-repository"};
+    repositoryPath.insert(0, getMindforgerGitHomePath());
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-antc-apb.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)));
+    config.setAaAlgorithm(m8r::Configuration::AssociationAssessmentAlgorithm::BOW);
+
+    m8r::Mind mind(config);
+    ASSERT_TRUE(mind.learn());
+
+    m8r::AiAaBoW aa{mind.remind(), mind};
+    ASSERT_TRUE(aa.dream().get());
+    ASSERT_LE(5, aa.getAaSize());
+
+    // serial
+    aa.precalculateAa(1);
+    vector<vector<float>> serial(aa.getAaSize(), vector<float>(aa.getAaSize()));
+    for(size_t x=0; x<aa.getAaSize(); x++) {
+        for(size_t y=0; y<aa.getAaSize(); y++) {
+            serial[x][y] = aa.getAa(x,y);
+        }
+    }
+
+    // parallel calculation must give the same (complete and symmetric) AA
+    aa.precalculateAa(3);
+    for(size_t x=0; x<aa.getAaSize(); x++) {
+        EXPECT_FLOAT_EQ(1., aa.getAa(x,x));
+        for(size_t y=0; y<aa.getAaSize(); y++) {
+            ASSERT_NE(-1., aa.getAa(x,y));
+            ASSERT_FLOAT_EQ(serial[x][y], aa.getAa(x,y));
+            ASSERT_FLOAT_EQ(aa.getAa(y,x), aa.getAa(x,y));
+        }
+    }
+}
+
+TEST(AiNlpTestCase, AaSnapshotBow)
+{
+    string repositoryPath{"/lib/test/resources/universe-repository"};
+    repositoryPath.insert(0, getMindforgerGitHomePath());
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-antc-asb.md");
+    string cachePath{config.getCachePath()};
+    config.setCachePath("/tmp/mf-unit-cache-aa-snapshot");
+    m8r::removeDirectoryRecursively(config.getCachePath().c_str());
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)));
+    config.setAaAlgorithm(m8r::Configuration::AssociationAssessmentAlgorithm::BOW);
+
+    m8r::Mind mind(config);
+    ASSERT_TRUE(mind.learn());
+
+    // 1st dream builds model from scratch and persists it
+    vector<vector<float>> aas{};
+    {
+        m8r::AiAaBoW aa{mind.remind(), mind};
+        ASSERT_TRUE(aa.dream().get());
+        ASSERT_FALSE(aa.isSnapshotLoaded());
+        ASSERT_TRUE(m8r::isFile(aa.getSnapshotPath().c_str()));
+
+        aa.precalculateAa(1);
+        aas.resize(aa.getAaSize(), vector<float>(aa.getAaSize()));
+        for(size_t x=0; x<aa.getAaSize(); x++) {
+            for(size_t y=0; y<aa.getAaSize(); y++) {
+                aas[x][y] = aa.getAa(x,y);
+            }
+        }
+        // calculated AA is persisted on sleep
+        ASSERT_TRUE(aa.sleep());
+    }
+
+    // 2nd dream loads the model including calculated AA
+    {
+        m8r::AiAaBoW aa{mind.remind(), mind};
+        ASSERT_TRUE(aa.dream().get());
+        ASSERT_TRUE(aa.isSnapshotLoaded());
+        ASSERT_EQ(aas.size(), aa.getAaSize());
+        for(size_t x=0; x<aa.getAaSize(); x++) {
+            for(size_t y=0; y<aa.getAaSize(); y++) {
+                ASSERT_FLOAT_EQ(aas[x][y], aa.getAa(x,y));
+            }
+        }
+    }
+
+    // modified N invalidates the snapshot
+    vector<m8r::Note*> notes{};
+    mind.remind().getAllNotes(notes);
+    notes[0]->setName(notes[0]->getName()+" Modified");
+    {
+        m8r::AiAaBoW aa{mind.remind(), mind};
+        ASSERT_TRUE(aa.dream().get());
+        ASSERT_FALSE(aa.isSnapshotLoaded());
+        ASSERT_EQ(m8r::AaMatrix::NOT_SET, aa.getAa(0,1));
+    }
+
+    m8r::removeDirectoryRecursively(config.getCachePath().c_str());
+    config.setCachePath(cachePath);
+}
+
+TEST(AiNlpTestCase, AaIncrementalBow)
+{
+    string repositoryPath{"/lib/test/resources/universe-repository"};
+    repositoryPath.insert(0, getMindforgerGitHomePath());
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-antc-aib.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)));
+    config.setAaAlgorithm(m8r::Configuration::AssociationAssessmentAlgorithm::BOW);
+
+    m8r::Mind mind(config);
+    ASSERT_TRUE(mind.learn());
+    ASSERT_TRUE(mind.think().get());
+    ASSERT_EQ(m8r::Configuration::MindState::THINKING, config.getMindState());
+
+    auto associate = [&mind](const m8r::Note* n, vector<pair<m8r::Note*,float>>& leaderboard) {
+        leaderboard.clear();
+        if(mind.getAssociatedNotes(n, leaderboard).get()) { // blocked
+            leaderboard.clear();
+            mind.getAssociatedNotes(n, leaderboard);
+        }
+    };
+
+    m8r::Outline* o = mind.remind().getOutlines()[0];
+    m8r::Note* einstein = o->getNoteByName("Albert Einstein");
+    ASSERT_NE(nullptr, einstein);
+    vector<pair<m8r::Note*,float>> leaderboard{};
+    associate(einstein, leaderboard);
+    ASSERT_LT(0, leaderboard.size());
+
+    // new N is learned w/o dream
+    m8r::Note* twin = new m8r::Note(einstein->getType(), o);
+    twin->setName(einstein->getName());
+    for(string* line:einstein->getDescription()) {
+        twin->addDescriptionLine(new string{*line});
+    }
+    o->addNote(twin);
+    mind.remind().reindex(o);
+    ASSERT_LE(0, twin->getAiAaMatrixIndex());
+    const int twinIndex = twin->getAiAaMatrixIndex();
+    associate(einstein, leaderboard);
+    ASSERT_LT(0, leaderboard.size());
+    EXPECT_EQ(twin, leaderboard[0].first);
+    associate(twin, leaderboard);
+    ASSERT_LT(0, leaderboard.size());
+    EXPECT_EQ(einstein, leaderboard[0].first);
+
+    // modified N is learned again
+    twin->setName("Guitar chords");
+    twin->clearDescription();
+    twin->addDescriptionLine(new string{"Chords and strings of an acoustic guitar."});
+    mind.remind().reindex(o);
+    EXPECT_EQ(twinIndex, twin->getAiAaMatrixIndex());
+    associate(einstein, leaderboard);
+    ASSERT_LT(0, leaderboard.size());
+    EXPECT_NE(twin, leaderboard[0].first);
+
+    // deleted N is forgotten and its slot is reused by new N
+    const m8r::Note* deleted = twin;
+    o->forgetNote(twin);
+    mind.remind().reindex(o);
+    associate(einstein, leaderboard);
+    for(auto& a:leaderboard) {
+        ASSERT_NE(deleted, a.first);
+    }
+    m8r::Note* newbie = new m8r::Note(einstein->getType(), o);
+    newbie->setName("Newbie");
+    o->addNote(newbie);
+    mind.remind().reindex(o);
+    EXPECT_EQ(twinIndex, newbie->getAiAaMatrixIndex());
+}
+
+TEST(AiNlpTestCase, AaForgetBow)
+{
+    string repositoryDir{"/tmp/mf-unit-repository-aa-forget"};
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+    m8r::Installer installer{};
+    installer.createEmptyMindForgerRepository(repositoryDir);
+    m8r::stringToFile(
+        repositoryDir+"/memory/physics.md",
+        "# Physics\nPhysicists.\n\n"
+        "## Albert Einstein\nTheory of relativity, spacetime and gravity.\n\n"
+        "## Isaac Newton\nLaws of motion and gravity.\n\n"
+        "### Apple\nApple falling from a tree due to gravity.\n\n"
+        "## Niels Bohr\nModel of atom.\n");
+    m8r::stringToFile(
+        repositoryDir+"/memory/relativity.md",
+        "# Relativity\nTheory.\n\n"
+        "## Special relativity\nSpacetime and speed of light.\n\n"
+        "## General relativity\nSpacetime curvature and gravity.\n");
+
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-antc-afb.md");
+    string cachePath{config.getCachePath()};
+    config.setCachePath("/tmp/mf-unit-cache-aa-forget");
+    m8r::removeDirectoryRecursively(config.getCachePath().c_str());
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)));
+    config.setAaAlgorithm(m8r::Configuration::AssociationAssessmentAlgorithm::BOW);
+
+    m8r::Mind mind(config);
+    ASSERT_TRUE(mind.learn());
+    ASSERT_TRUE(mind.think().get());
+    ASSERT_EQ(m8r::Configuration::MindState::THINKING, config.getMindState());
+    m8r::Outline* physics = mind.remind().getOutline(repositoryDir+"/memory/physics.md");
+    m8r::Outline* relativity = mind.remind().getOutline(repositoryDir+"/memory/relativity.md");
+    ASSERT_NE(nullptr, physics);
+    ASSERT_NE(nullptr, relativity);
+
+    // busy AI (e.g. task of distributor in progress) doesn't apply O changes...
+    mind.incActiveProcesses();
+
+    // ... but deleted Ns are dropped immediately - before they're deallocated
+    m8r::Note* newton = physics->getNoteByName("Isaac Newton");
+    ASSERT_NE(nullptr, newton);
+    const void* deleted[] = {newton, physics->getNoteByName("Apple")};
+    ASSERT_NE(nullptr, deleted[1]);
+    vector<pair<m8r::Note*,float>> leaderboard{};
+    ASSERT_TRUE(mind.getAssociatedNotes("gravity", leaderboard).get());
+    ASSERT_LT(0, leaderboard.size());
+    mind.noteForget(newton);
+    leaderboard.clear();
+    ASSERT_TRUE(mind.getAssociatedNotes("gravity", leaderboard).get());
+    ASSERT_LT(0, leaderboard.size());
+    for(auto& a:leaderboard) {
+        ASSERT_NE(deleted[0], a.first);
+        ASSERT_NE(deleted[1], a.first);
+    }
+
+    // ... and so are Ns of forgotten O
+    leaderboard.clear();
+    ASSERT_TRUE(mind.getAssociatedNotes("spacetime", leaderboard).get());
+    ASSERT_LT(1, leaderboard.size());
+    mind.remind().forget(relativity);
+    leaderboard.clear();
+    ASSERT_TRUE(mind.getAssociatedNotes("spacetime", leaderboard).get());
+    ASSERT_LT(0, leaderboard.size());
+    for(auto& a:leaderboard) {
+        ASSERT_EQ(physics, a.first->getOutline());
+    }
+
+    mind.decActiveProcesses();
+    m8r::removeDirectoryRecursively(config.getCachePath().c_str());
+    config.setCachePath(cachePath);
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+}
+
+TEST(AiNlpTestCase, AaDreamChunksBow)
+{
+    // repository w/ more Ns than a single dream chunk
+    string repositoryDir{"/tmp/mf-unit-repository-aa-dream-chunks"};
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+    m8r::Installer installer{};
+    installer.createEmptyMindForgerRepository(repositoryDir);
+    vector<string> topics{"planet orbit", "guitar chord", "stock market"};
+    for(string& topic:topics) {
+        string md{"# "};
+        md += topic;
+        md += "\nAbout.\n";
+        for(int i=0; i<1000; i++) {
+            md += "\n## " + topic + " " + std::to_string(i) + "\n" + topic + " " + std::to_string(i%7) + ".\n";
+        }
+        m8r::stringToFile(repositoryDir+"/memory/"+topic.substr(0, topic.find(' '))+".md", md);
+    }
+
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-antc-adcb.md");
+    string cachePath{config.getCachePath()};
+    config.setCachePath("/tmp/mf-unit-cache-aa-dream-chunks");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)));
+    config.setAaAlgorithm(m8r::Configuration::AssociationAssessmentAlgorithm::BOW);
+    // dream in the background
+    config.setAsyncMindThreshold(100);
+
+    m8r::Mind mind(config);
+    ASSERT_TRUE(mind.learn());
+    ASSERT_EQ(3000, mind.remind().getNotesCount());
+    m8r::Note* n = mind.remind().getOutlines()[0]->getNotes()[0];
+
+    // reference: uninterrupted dream
+    vector<pair<m8r::Note*,float>> expected{};
+    {
+        m8r::AiAaBoW aa{mind.remind(), mind};
+        ASSERT_TRUE(aa.dream().get());
+        ASSERT_EQ(100, aa.getDreamProgress());
+        if(aa.getAssociatedNotes(n, expected).get()) { // blocked
+            aa.getAssociatedNotes(n, expected);
+        }
+        ASSERT_LT(0, expected.size());
+        ASSERT_TRUE(aa.sleep());
+    }
+    // dream must not be loaded from snapshot
+    m8r::removeDirectoryRecursively(config.getCachePath().c_str());
+
+    // interrupted dream is resumed - dream is interrupted after the 1st chunk
+    m8r::AiAaBoW aa{mind.remind(), mind};
+    aa.setDreamChunkListener([&aa](size_t dreamed) {
+        if(dreamed == 1000) {
+            aa.interruptDream();
+        }
+    });
+    ASSERT_FALSE(aa.dream().get());
+    EXPECT_EQ(33, aa.getDreamProgress());
+    EXPECT_EQ(m8r::Configuration::MindState::SLEEPING, config.getMindState());
+
+    aa.setDreamChunkListener(nullptr);
+    ASSERT_TRUE(aa.dream().get());
+    EXPECT_EQ(100, aa.getDreamProgress());
+    EXPECT_EQ(3000, aa.getAaSize());
+    vector<pair<m8r::Note*,float>> leaderboard{};
+    if(aa.getAssociatedNotes(n, leaderboard).get()) { // blocked
+        aa.getAssociatedNotes(n, leaderboard);
+    }
+    ASSERT_EQ(expected.size(), leaderboard.size());
+    for(size_t i=0; i<leaderboard.size(); i++) {
+        EXPECT_EQ(expected[i].first, leaderboard[i].first);
+        EXPECT_FLOAT_EQ(expected[i].second, leaderboard[i].second);
+    }
+
+    m8r::removeDirectoryRecursively(config.getCachePath().c_str());
+    config.setCachePath(cachePath);
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+}
+
+TEST(AiNlpTestCase, AaDreamChunksChangedOutlineBow)
+{
+    // repository w/ more Ns than a single dream chunk
+    string repositoryDir{"/tmp/mf-unit-repository-aa-dream-chunks-changed"};
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+    m8r::Installer installer{};
+    installer.createEmptyMindForgerRepository(repositoryDir);
+    vector<string> topics{"planet orbit", "guitar chord", "stock market"};
+    for(string& topic:topics) {
+        string md{"# "};
+        md += topic;
+        md += "\nAbout.\n";
+        for(int i=0; i<1000; i++) {
+            md += "\n## " + topic + " " + std::to_string(i) + "\n" + topic + " " + std::to_string(i%7) + ".\n";
+        }
+        m8r::stringToFile(repositoryDir+"/memory/"+topic.substr(0, topic.find(' '))+".md", md);
+    }
+
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-antc-adccb.md");
+    string cachePath{config.getCachePath()};
+    config.setCachePath("/tmp/mf-unit-cache-aa-dream-chunks-changed");
+    m8r::removeDirectoryRecursively(config.getCachePath().c_str());
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)));
+    config.setAaAlgorithm(m8r::Configuration::AssociationAssessmentAlgorithm::BOW);
+    // dream in the background
+    config.setAsyncMindThreshold(100);
+
+    m8r::Mind mind(config);
+    ASSERT_TRUE(mind.learn());
+    ASSERT_EQ(3000, mind.remind().getNotesCount());
+    // Ns of the 2nd O are dreamed by the 2nd chunk
+    m8r::Outline* o = mind.remind().getOutlines()[1];
+
+    // O is changed after the 1st chunk > its not dreamed Ns are learned as pending O
+    m8r::AiAaBoW aa{mind.remind(), mind};
+    aa.setDreamChunkListener([&aa,o](size_t dreamed) {
+        if(dreamed == 1000) {
+            o->getNotes()[0]->setName("planet orbit guitar chord");
+            aa.remember(o);
+        } else {
+            aa.interruptDream();
+        }
+    });
+    ASSERT_FALSE(aa.dream().get());
+    EXPECT_EQ(66, aa.getDreamProgress());
+
+    // Ns are posted just once - even if their slots were reused by pending O
+    auto assertUniquePostings = [&aa]() {
+        for(const vector<uint32_t>& posting:aa.getWordPostings()) {
+            vector<uint32_t> unique{posting};
+            std::sort(unique.begin(), unique.end());
+            unique.erase(std::unique(unique.begin(), unique.end()), unique.end());
+            ASSERT_EQ(unique.size(), posting.size());
+        }
+    };
+    assertUniquePostings();
+
+    aa.setDreamChunkListener(nullptr);
+    ASSERT_TRUE(aa.dream().get());
+    EXPECT_EQ(100, aa.getDreamProgress());
+    EXPECT_EQ(3000, aa.getAaSize());
+    assertUniquePostings();
+    for(m8r::Note* n:o->getNotes()) {
+        ASSERT_LE(0, n->getAiAaMatrixIndex());
+        ASSERT_GT(3000, n->getAiAaMatrixIndex());
+    }
+
+    m8r::removeDirectoryRecursively(config.getCachePath().c_str());
+    config.setCachePath(cachePath);
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+}
+
+TEST(AiNlpTestCase, AaMatrix)
+{
+    m8r::AaMatrix aa{};
+    aa.reset(5);
+    // packed upper triangular matrix w/ diagonal
+    ASSERT_EQ(5, aa.getSize());
+    ASSERT_EQ(15*sizeof(m8r::AaMatrix::Cell), aa.getBytesize());
+
+    for(size_t x=0; x<5; x++) {
+        ASSERT_FALSE(aa.isRowCalculated(x));
+        for(size_t y=0; y<5; y++) {
+            ASSERT_FALSE(aa.isSet(x,y));
+            ASSERT_EQ(m8r::AaMatrix::NOT_SET, aa.get(x,y));
+        }
+    }
+
+    // symmetry
+    aa.set(1, 3, 0.5);
+    EXPECT_TRUE(aa.isSet(3,1));
+    EXPECT_NEAR(0.5, aa.get(1,3), 0.0001);
+    EXPECT_FLOAT_EQ(aa.get(1,3), aa.get(3,1));
+    aa.set(4, 0, 0.25);
+    EXPECT_NEAR(0.25, aa.get(0,4), 0.0001);
+    EXPECT_FALSE(aa.isSet(0,3));
+
+    // quantization: 0 is a valid ranking, the highest rankings are saturated
+    aa.set(2, 0, 0.);
+    EXPECT_TRUE(aa.isSet(0,2));
+    EXPECT_FLOAT_EQ(0., aa.get(0,2));
+    aa.set(2, 1, 1000.);
+    EXPECT_FLOAT_EQ(m8r::AaMatrix::MAX_AA, aa.get(1,2));
+
+    // diagonal is row calculated marker
+    aa.setRowCalculated(2);
+    EXPECT_TRUE(aa.isRowCalculated(2));
+    EXPECT_FLOAT_EQ(1., aa.get(2,2));
+    EXPECT_FALSE(aa.isRowCalculated(3));
+
+    // growth keeps calculated cells, cross of N can be cleared
+    aa.resize(7);
+    EXPECT_EQ(7, aa.getSize());
+    EXPECT_NEAR(0.5, aa.get(3,1), 0.0001);
+    EXPECT_TRUE(aa.isRowCalculated(2));
+    EXPECT_FALSE(aa.isSet(6,1));
+    aa.set(6, 2, 0.75);
+    aa.clearRow(2);
+    EXPECT_FALSE(aa.isRowCalculated(2));
+    EXPECT_FALSE(aa.isSet(6,2));
+    EXPECT_FALSE(aa.isSet(0,2));
+    EXPECT_TRUE(aa.isSet(1,3));
+
+    aa.reset(3);
+    EXPECT_FALSE(aa.isSet(1,2));
+    aa.clear();
+    EXPECT_EQ(0, aa.getSize());
+}
+
+TEST(AiNlpTestCase, AaTopKBow)
+{
+    string repositoryPath{"/lib/test/resources/universe-repository"};
+    repositoryPath.insert(0, getMindforgerGitHomePath());
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-antc-atkb.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryPath)));
+    config.setAaAlgorithm(m8r::Configuration::AssociationAssessmentAlgorithm::BOW);
+
+    m8r::Mind mind(config);
+    ASSERT_TRUE(mind.learn());
+
+    // dense AA as reference
+    m8r::AiAaBoW dense{mind.remind(), mind};
+    dense.setAaStorage(m8r::AiAaBoW::AaStorage::DENSE_MATRIX);
+    ASSERT_TRUE(dense.dream().get());
+    ASSERT_FALSE(dense.isAaSparse());
+    dense.precalculateAa(1);
+
+    m8r::AiAaBoW sparse{mind.remind(), mind};
+    sparse.setAaStorage(m8r::AiAaBoW::AaStorage::TOP_K);
+    ASSERT_TRUE(sparse.dream().get());
+    ASSERT_TRUE(sparse.isAaSparse());
+    ASSERT_EQ(0, sparse.getAaSize());
+    sparse.precalculateAa(2);
+
+    // every sparse row must be the best K of dense row (ordered from the best)
+    const m8r::AaTopK& topK = sparse.getAaTopK();
+    ASSERT_EQ(dense.getAaSize(), topK.getSize());
+    for(size_t y=0; y<topK.getSize(); y++) {
+        ASSERT_TRUE(topK.isRowCalculated(y));
+
+        vector<float> expected{};
+        for(size_t x=0; x<dense.getAaSize(); x++) {
+            if(x!=y) expected.push_back(dense.getAa(x,y));
+        }
+        std::sort(expected.begin(), expected.end(), std::greater<float>());
+        expected.resize(std::min(expected.size(), topK.getK()));
+
+        vector<m8r::AaTopK::Entry> row{};
+        topK.getRow(y, row);
+        ASSERT_EQ(expected.size(), row.size());
+        for(size_t i=0; i<row.size(); i++) {
+            ASSERT_NE(y, row[i].first);
+            // dense AA rankings are quantized
+            ASSERT_NEAR(expected[i], row[i].second, 0.0001);
+        }
+    }
+}
+
+TEST(AiNlpTestCase, AaCandidatesBow)
+{
+    // Os w/ Ns about different topics - Ns share relevant words w/ Ns of the same topic only
+    string repositoryDir{"/tmp/mf-unit-repository-aa-candidates"};
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+    m8r::Installer installer{};
+    installer.createEmptyMindForgerRepository(repositoryDir);
+    vector<string> topics{"planet orbit", "guitar chord", "stock market"};
+    for(string& topic:topics) {
+        string md{"# "};
+        md += topic;
+        md += "\nAbout.\n";
+        for(int i=0; i<15; i++) {
+            md += "\n## " + topic + " " + std::to_string(i) + "\n" + topic + " " + topic + ".\n";
+        }
+        m8r::stringToFile(repositoryDir+"/memory/"+topic.substr(0, topic.find(' '))+".md", md);
+    }
+
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-antc-acb.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)));
+    config.setAaAlgorithm(m8r::Configuration::AssociationAssessmentAlgorithm::BOW);
+
+    m8r::Mind mind(config);
+    ASSERT_TRUE(mind.learn());
+    ASSERT_EQ(3, mind.remind().getOutlinesCount());
+
+    m8r::AiAaBoW aa{mind.remind(), mind};
+    aa.setAaStorage(m8r::AiAaBoW::AaStorage::DENSE_MATRIX);
+    ASSERT_TRUE(aa.dream().get());
+    ASSERT_EQ(45, aa.getAaSize());
+
+    m8r::Outline* o = mind.remind().getOutlines()[0];
+    m8r::Note* n = o->getNotes()[0];
+    vector<pair<m8r::Note*,float>> leaderboard{};
+    if(aa.getAssociatedNotes(n, leaderboard).get()) { // blocked
+        aa.getAssociatedNotes(n, leaderboard);
+    }
+    ASSERT_EQ(10, leaderboard.size());
+    for(auto& a:leaderboard) {
+        EXPECT_EQ(o, a.first->getOutline());
+    }
+
+    // only candidates (Ns sharing words/O) were assessed
+    size_t y = n->getAiAaMatrixIndex();
+    EXPECT_FALSE(aa.getAaTopK().getSize());
+    for(m8r::Outline* other:mind.remind().getOutlines()) {
+        for(m8r::Note* on:other->getNotes()) {
+            size_t x = on->getAiAaMatrixIndex();
+            if(x != y) {
+                if(other == o) {
+                    EXPECT_NE(-1., aa.getAa(x,y));
+                } else {
+                    EXPECT_EQ(-1., aa.getAa(x,y));
+                }
+            }
+        }
+    }
+}
+
+TEST(AiNlpTestCase, AaModel)
+{
+    // features of associated Ns are similar by descriptions
+    m8r::AssociationAssessmentFeatureBatch samples{100};
+    vector<float> labels{};
+    m8r::AssociationAssessmentNotesFeature feature{};
+    for(int i=0; i<100; i++) {
+        feature.clearFeatures();
+        feature.setHaveMutualRel(i%7 == 0);
+        feature.setTypeMatches(i%3 == 0);
+        feature.setSimilarityByTags((i%5)/5.);
+        feature.setSimilarityByTitles((i%4)/4.);
+        feature.setSimilarityByDescription((i%10)/10.);
+        feature.setSimilaritySameOutline(i%2 == 0);
+        samples.add(feature);
+        labels.push_back(i%10 >= 5 ? 1. : 0.);
+    }
+    ASSERT_EQ(100, samples.getSize());
+    ASSERT_TRUE(samples.isFull());
+
+    // untrained model is the hand-weighted metric - batch gives the same ranking as single feature
+    m8r::AssociationAssessmentModel model{};
+    ASSERT_FALSE(model.isTrained());
+    ASSERT_EQ(0, model.getFingerprint());
+    vector<float> scores(samples.getSize());
+    model.assess(samples, scores.data());
+    for(size_t i=0; i<samples.getSize(); i++) {
+        feature.clearFeatures();
+        feature.setHaveMutualRel(i%7 == 0);
+        feature.setTypeMatches(i%3 == 0);
+        feature.setSimilarityByTags((i%5)/5.);
+        feature.setSimilarityByTitles((i%4)/4.);
+        feature.setSimilarityByDescription((i%10)/10.);
+        feature.setSimilaritySameOutline(i%2 == 0);
+        ASSERT_EQ(feature.areNotesAssociatedMetric(), scores[i]);
+        ASSERT_EQ(model.assess(feature), scores[i]);
+    }
+
+    // training is deterministic and trained network separates samples
+    ASSERT_TRUE(model.train(samples, labels));
+    ASSERT_TRUE(model.isTrained());
+    ASSERT_NE(0, model.getFingerprint());
+    m8r::AssociationAssessmentModel twin{};
+    twin.train(samples, labels);
+    ASSERT_EQ(model.getFingerprint(), twin.getFingerprint());
+
+    model.assess(samples, scores.data());
+    for(size_t i=0; i<samples.getSize(); i++) {
+        if(labels[i] > .5) {
+            EXPECT_GT(scores[i], .5);
+        } else {
+            EXPECT_LT(scores[i], .5);
+        }
+    }
+
+    model.forget();
+    ASSERT_FALSE(model.isTrained());
+    samples.clear();
+    ASSERT_EQ(0, samples.getSize());
+    ASSERT_FALSE(model.train(samples, labels));
+}
+
+TEST(AiNlpTestCase, AaModelTrainingBow)
+{
+    string repositoryDir{"/tmp/mf-unit-repository-aa-training"};
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+    m8r::Installer installer{};
+    installer.createEmptyMindForgerRepository(repositoryDir);
+    vector<string> topics{"planet orbit", "guitar chord"};
+    for(string& topic:topics) {
+        string md{"# "};
+        md += topic;
+        md += "\nAbout.\n";
+        for(int i=0; i<15; i++) {
+            md += "\n## " + topic + " " + std::to_string(i) + "\n" + topic + " " + topic + ".\n";
+        }
+        m8r::stringToFile(repositoryDir+"/memory/"+topic.substr(0, topic.find(' '))+".md", md);
+    }
+
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-antc-amtb.md");
+    string cachePath{config.getCachePath()};
+    config.setCachePath("/tmp/mf-unit-cache-aa-training");
+    m8r::removeDirectoryRecursively(config.getCachePath().c_str());
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)));
+    config.setAaAlgorithm(m8r::Configuration::AssociationAssessmentAlgorithm::BOW);
+
+    m8r::Mind mind(config);
+    ASSERT_TRUE(mind.learn());
+
+    // user follows associations in leaderboards
+    {
+        m8r::AiAaBoW aa{mind.remind(), mind};
+        ASSERT_TRUE(aa.dream().get());
+        ASSERT_FALSE(aa.getAaModel().isTrained());
+        for(m8r::Note* n:mind.remind().getOutlines()[0]->getNotes()) {
+            vector<pair<m8r::Note*,float>> leaderboard{};
+            if(aa.getAssociatedNotes(n, leaderboard).get()) { // blocked
+                aa.getAssociatedNotes(n, leaderboard);
+            }
+            ASSERT_LE(3, leaderboard.size());
+            aa.acceptAssociation(n, leaderboard[2].first, leaderboard);
+        }
+        ASSERT_TRUE(m8r::isFile(aa.getTrainingSetPath().c_str()));
+    }
+
+    // AA model is trained when Mind dreams again (AA in snapshot is recalculated by the trained model)
+    uint64_t fingerprint;
+    {
+        m8r::AiAaBoW aa{mind.remind(), mind};
+        ASSERT_TRUE(aa.dream().get());
+        ASSERT_TRUE(aa.isSnapshotLoaded());
+        ASSERT_TRUE(aa.getAaModel().isTrained());
+        fingerprint = aa.getAaModel().getFingerprint();
+    }
+
+    // unchanged training set ~ AA model is restored from snapshot
+    {
+        m8r::AiAaBoW aa{mind.remind(), mind};
+        ASSERT_TRUE(aa.dream().get());
+        ASSERT_TRUE(aa.isSnapshotLoaded());
+        ASSERT_TRUE(aa.getAaModel().isTrained());
+        ASSERT_EQ(fingerprint, aa.getAaModel().getFingerprint());
+    }
+
+    m8r::removeDirectoryRecursively(config.getCachePath().c_str());
+    config.setCachePath(cachePath);
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+}
+
+TEST(AiNlpTestCase, AaWordEmbeddingsBow)
+{
+    string repositoryDir{"/tmp/mf-unit-repository-aa-embeddings"};
+    string embeddingsPath{"/tmp/mf-unit-embeddings.txt"};
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+    m8r::Installer installer{};
+    installer.createEmptyMindForgerRepository(repositoryDir);
+    m8r::stringToFile(repositoryDir+"/memory/alpha.md", "# Alpha\n\n## Alpha Note\ncar car.\n");
+    m8r::stringToFile(repositoryDir+"/memory/beta.md", "# Beta\n\n## Beta Note\nautomobile automobile.\n");
+    m8r::stringToFile(repositoryDir+"/memory/gamma.md", "# Gamma\n\n## Gamma Note\nguitar guitar.\n");
+    // word2vec header, punctuation and words w/ the same stem
+    m8r::stringToFile(
+        embeddingsPath,
+        "5 10\n"
+        ", 1 1 1 1 1 1 1 1 1 1\n"
+        "car 1 0.1 0 0 0 0 0 0 0 0.1\n"
+        "Cars 1 0.1 0 0 0 0 0 0 0 0.1\n"
+        "automobile 0.9 0.2 0 0 0 0 0 0 0 0\n"
+        "guitar 0 0 1 0 0 0 0 0 0.5 0\n");
+
+    // conversion & mapping
+    string binaryPath{"/tmp/mf-unit-embeddings.bin"};
+    ASSERT_TRUE(m8r::WordEmbeddings::convert(embeddingsPath, binaryPath, m8r::Stemmer::Language::ENGLISH));
+    ASSERT_FALSE(m8r::WordEmbeddings::isBinary(embeddingsPath));
+    ASSERT_TRUE(m8r::WordEmbeddings::isBinary(binaryPath));
+    {
+        m8r::WordEmbeddings embeddings{};
+        ASSERT_FALSE(embeddings.open(embeddingsPath));
+        ASSERT_EQ(0, embeddings.getFingerprint());
+        ASSERT_TRUE(embeddings.open(binaryPath));
+        EXPECT_EQ(3, embeddings.size());
+        EXPECT_EQ(10, embeddings.getDimension());
+        EXPECT_NE(0, embeddings.getFingerprint());
+        const float* car = embeddings.get("car");
+        const float* automobile = embeddings.get("automobil");
+        const float* guitar = embeddings.get("guitar");
+        ASSERT_NE(nullptr, car);
+        ASSERT_NE(nullptr, automobile);
+        ASSERT_NE(nullptr, guitar);
+        ASSERT_EQ(nullptr, embeddings.get("automobile"));
+        ASSERT_EQ(nullptr, embeddings.get(","));
+        EXPECT_NEAR(1., m8r::WordEmbeddings::dot(car, car, 10), 0.0001);
+        EXPECT_GT(m8r::WordEmbeddings::dot(car, automobile, 10), 0.9);
+        EXPECT_NEAR(0., m8r::WordEmbeddings::dot(car, guitar, 10), 0.0001);
+    }
+    std::remove(binaryPath.c_str());
+
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-antc-aweb.md");
+    string cachePath{config.getCachePath()};
+    config.setCachePath("/tmp/mf-unit-cache-aa-embeddings");
+    m8r::removeDirectoryRecursively(config.getCachePath().c_str());
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)));
+    config.setAaAlgorithm(m8r::Configuration::AssociationAssessmentAlgorithm::BOW);
+    config.setAiEmbeddingsPath(embeddingsPath);
+
+    m8r::Mind mind(config);
+    ASSERT_TRUE(mind.learn());
+
+    // synonyms associate Ns which share no word
+    m8r::AiAaBoW aa{mind.remind(), mind};
+    ASSERT_TRUE(aa.dream().get());
+    ASSERT_TRUE(aa.getEmbeddings().isOpen());
+    vector<pair<m8r::Note*,float>> leaderboard{};
+    m8r::Note* n = mind.remind().getOutline(repositoryDir+"/memory/alpha.md")->getNotes()[0];
+    if(aa.getAssociatedNotes(n, leaderboard).get()) { // blocked
+        aa.getAssociatedNotes(n, leaderboard);
+    }
+    ASSERT_LE(1, leaderboard.size());
+    EXPECT_EQ("Beta Note", leaderboard[0].first->getName());
+    for(size_t i=1; i<leaderboard.size(); i++) {
+        EXPECT_GT(leaderboard[0].second, leaderboard[i].second);
+    }
+
+    config.setAiEmbeddingsPath("");
+    m8r::removeDirectoryRecursively(config.getCachePath().c_str());
+    config.setCachePath(cachePath);
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+    std::remove(embeddingsPath.c_str());
+}
+
+TEST(AiNlpTestCase, NearDuplicatesMinHash)
+{
+    // word sequence tokenization keeps order and repetitions
+    m8r::Lexicon lexicon{};
+    m8r::CommonWordsBlacklist wordBlaclist{};
+    m8r::MarkdownTokenizer tokenizer{lexicon, wordBlaclist};
+    string text{"Universe of Einstein - universe"};
+    vector<uint32_t> ids{};
+    tokenizer.tokenize(text.data(), text.data()+text.size(), ids, true, true, false);
+    ASSERT_EQ(3, ids.size());
+    EXPECT_EQ("universe", lexicon.getWord(ids[0]));
+    EXPECT_EQ("einstein", lexicon.getWord(ids[1]));
+    EXPECT_EQ(ids[0], ids[2]);
+
+    m8r::MinHash minHash{};
+    vector<uint32_t> signatures(3*m8r::MinHash::SIGNATURE_SIZE);
+    ASSERT_FALSE(minHash.sign(vector<uint32_t>{1, 2}, signatures.data()));
+
+    // repository: Ns w/ random descriptions, exact copies and a copy w/ one word changed
+    string repositoryDir{"/tmp/mf-unit-repository-near-duplicates"};
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+    m8r::Installer installer{};
+    installer.createEmptyMindForgerRepository(repositoryDir);
+    unsigned seed = 7;
+    auto randomWord = [&seed]() {
+        seed = seed*1103515245+12345;
+        unsigned w = (seed>>16)%2000;
+        string word{"q"};
+        for(int i=0; i<4; i++, w/=26) {
+            word += static_cast<char>('a'+w%26);
+        }
+        return word;
+    };
+    vector<string> descriptions{};
+    string md{"# Imports\nImported Ns.\n"};
+    for(int i=0; i<200; i++) {
+        string description{};
+        for(int w=0; w<80; w++) {
+            description += randomWord() + " ";
+        }
+        descriptions.push_back(description);
+        md += "\n## Note " + std::to_string(i) + "\n" + description + "\n";
+    }
+    for(int i=0; i<3; i++) {
+        md += "\n## Copy " + std::to_string(i) + "\n" + descriptions[20] + "\n";
+    }
+    string edited{descriptions[10]};
+    edited.replace(edited.rfind(' ', edited.size()-2)+1, string::npos, "qzzzz ");
+    md += "\n## Edited\n" + edited + "\n";
+    // too short to be a duplicate
+    md += "\n## Short 1\nDone.\n\n## Short 2\nDone.\n";
+    m8r::stringToFile(repositoryDir+"/memory/imports.md", md);
+
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-antc-ndmh.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)));
+    // detection doesn't need AA model
+    config.setAaAlgorithm(m8r::Configuration::AssociationAssessmentAlgorithm::WEIGHTED_FTS);
+    m8r::Mind mind(config);
+    ASSERT_TRUE(mind.learn());
+    ASSERT_EQ(206, mind.remind().getNotesCount());
+
+    vector<vector<m8r::Note*>> clusters{};
+    mind.findNearDuplicateNotes(clusters);
+    ASSERT_EQ(2, clusters.size());
+    ASSERT_EQ(4, clusters[0].size());
+    EXPECT_EQ("Note 20", clusters[0][0]->getName());
+    EXPECT_EQ("Copy 2", clusters[0][3]->getName());
+    ASSERT_EQ(2, clusters[1].size());
+    EXPECT_EQ("Note 10", clusters[1][0]->getName());
+    EXPECT_EQ("Edited", clusters[1][1]->getName());
+
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+}
@@ -0,0 +1,209 @@
+/*
+ priority_executor_test.cpp     MindForger application test
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../../src/gear/priority_executor.h"
+
+using namespace std;
+
+TEST(PriorityExecutorTestCase, PriorityDedupCancel)
+{
+    m8r::PriorityExecutor executor{1};
+    ASSERT_EQ(1, executor.getSize());
+
+    // block the only worker so that tasks are queued
+    promise<void> gate{};
+    shared_future<void> opened = gate.get_future().share();
+    shared_future<bool> blocker = executor.submit(nullptr, 0, [opened]() { opened.wait(); return true; });
+    while(!executor.getRunningCount()) {
+        this_thread::yield();
+    }
+
+    mutex orderMutex{};
+    vector<int> order{};
+    auto task = [&orderMutex,&order](int id) {
+        return [&orderMutex,&order,id]() {
+            lock_guard<mutex> criticalSection{orderMutex};
+            order.push_back(id);
+            return true;
+        };
+    };
+    int keys[5];
+
+    shared_future<bool> background = executor.submit(&keys[0], 0, task(0));
+    shared_future<bool> older = executor.submit(&keys[1], 1, task(1));
+    shared_future<bool> newer = executor.submit(&keys[2], 1, task(2));
+
+    // duplicate request shares future of the queued task
+    bool queued = true;
+    shared_future<bool> duplicate = executor.submit(&keys[2], 1, task(22), nullptr, &queued);
+    ASSERT_FALSE(queued);
+
+    // stale request is cancelled
+    int cancelled = 0;
+    shared_future<bool> stale = executor.submit(&keys[3], 2, task(3), [&cancelled]() { cancelled++; }, &queued);
+    ASSERT_TRUE(queued);
+    ASSERT_EQ(5, executor.getQueuedCount() + executor.getRunningCount());
+    ASSERT_TRUE(executor.cancel(&keys[3]));
+    ASSERT_FALSE(executor.cancel(&keys[3]));
+    ASSERT_EQ(1, cancelled);
+    ASSERT_EQ(future_status::ready, stale.wait_for(chrono::microseconds(0)));
+    ASSERT_FALSE(stale.get());
+
+    // cancel queued tasks of given priority except the current one
+    shared_future<bool> current = executor.submit(&keys[4], 1, task(4));
+    ASSERT_EQ(2, executor.cancelQueued(1, &keys[4]));
+    ASSERT_FALSE(older.get());
+    ASSERT_FALSE(newer.get());
+    ASSERT_FALSE(duplicate.get());
+
+    gate.set_value();
+    ASSERT_TRUE(blocker.get());
+    ASSERT_TRUE(current.get());
+    ASSERT_TRUE(background.get());
+
+    // higher priority first, then the most recent one
+    ASSERT_EQ(2, order.size());
+    EXPECT_EQ(4, order[0]);
+    EXPECT_EQ(0, order[1]);
+
+    // key can be reused once task is finished
+    shared_future<bool> again = executor.submit(&keys[4], 1, task(4), nullptr, &queued);
+    ASSERT_TRUE(queued);
+    ASSERT_TRUE(again.get());
+}
+
+TEST(PriorityExecutorTestCase, ExceptionAndShutdown)
+{
+    shared_future<bool> failed, running, pending;
+    atomic<int> cancelled{0};
+    promise<void> gate{};
+    {
+        m8r::PriorityExecutor executor{1};
+        failed = executor.submit(nullptr, 0, []() -> bool { throw std::runtime_error("task failure"); });
+        ASSERT_FALSE(failed.get());
+
+        shared_future<void> opened = gate.get_future().share();
+        running = executor.submit(nullptr, 0, [opened]() { opened.wait(); return true; });
+        while(!executor.getRunningCount()) {
+            this_thread::yield();
+        }
+        pending = executor.submit(nullptr, 0, []() { return true; }, [&cancelled]() { cancelled++; });
+
+        // shutdown cancels queued tasks and waits for running ones
+        thread opener{[&gate]() { this_thread::sleep_for(chrono::milliseconds(50)); gate.set_value(); }};
+        executor.shutdown();
+        opener.join();
+
+        // submit after shutdown is cancelled
+        ASSERT_FALSE(executor.submit(nullptr, 0, []() { return true; }, [&cancelled]() { cancelled++; }).get());
+    }
+
+    // futures outlive executor
+    EXPECT_TRUE(running.get());
+    EXPECT_FALSE(pending.get());
+    EXPECT_EQ(2, cancelled.load());
+}
+
+TEST(PriorityExecutorTestCase, FinishListener)
+{
+    m8r::PriorityExecutor executor{1};
+
+    mutex finishedMutex{};
+    condition_variable finishedChanged{};
+    int finished = 0;
+    executor.setFinishListener([&finishedMutex,&finishedChanged,&finished]() {
+        lock_guard<mutex> criticalSection{finishedMutex};
+        finished++;
+        finishedChanged.notify_all();
+    });
+
+    // listener is notified once future of every task is ready
+    for(int i=0; i<3; i++) {
+        executor.submit(nullptr, 0, []() { return true; });
+    }
+    {
+        unique_lock<mutex> criticalSection{finishedMutex};
+        ASSERT_TRUE(finishedChanged.wait_for(criticalSection, chrono::seconds(5), [&finished]() { return finished == 3; }));
+    }
+
+    // ... as well as once cancelled task is finished
+    promise<void> gate{};
+    shared_future<void> opened = gate.get_future().share();
+    shared_future<bool> blocker = executor.submit(nullptr, 0, [opened]() { opened.wait(); return true; });
+    while(!executor.getRunningCount()) {
+        this_thread::yield();
+    }
+    int key;
+    shared_future<bool> pending = executor.submit(&key, 0, []() { return true; });
+    ASSERT_TRUE(executor.cancel(&key));
+    {
+        lock_guard<mutex> criticalSection{finishedMutex};
+        EXPECT_EQ(4, finished);
+    }
+
+    // unset listener is not notified
+    executor.setFinishListener(nullptr);
+    gate.set_value();
+    ASSERT_TRUE(blocker.get());
+    executor.shutdown();
+    lock_guard<mutex> criticalSection{finishedMutex};
+    EXPECT_EQ(4, finished);
+}
+
+TEST(PriorityExecutorTestCase, Drain)
+{
+    m8r::PriorityExecutor executor{1};
+
+    promise<void> gate{};
+    shared_future<void> opened = gate.get_future().share();
+    atomic<bool> finished{false};
+    shared_future<bool> running = executor.submit(nullptr, 0, [opened,&finished]() {
+        opened.wait();
+        finished = true;
+        return true;
+    });
+    while(!executor.getRunningCount()) {
+        this_thread::yield();
+    }
+    int cancelled = 0;
+    shared_future<bool> pending = executor.submit(nullptr, 1, []() { return true; }, [&cancelled]() { cancelled++; });
+
+    // drain cancels queued tasks and waits for running ones
+    thread opener{[&gate]() { this_thread::sleep_for(chrono::milliseconds(50)); gate.set_value(); }};
+    executor.drain();
+    opener.join();
+    EXPECT_TRUE(finished.load());
+    EXPECT_EQ(0, executor.getRunningCount());
+    EXPECT_EQ(0, executor.getQueuedCount());
+    EXPECT_EQ(1, cancelled);
+    EXPECT_TRUE(running.get());
+    EXPECT_FALSE(pending.get());
+
+    // executor is usable after drain
+    EXPECT_TRUE(executor.submit(nullptr, 0, []() { return true; }).get());
+}
@@ -0,0 +1,118 @@
+/*
+ work_stealing_pool_test.cpp     MindForger application test
+
+ Copyright (C) 2016-2018 Martin Dvorak <martin.dvorak@mindforger.com>
+
+ This program is free software; you can redistribute it and/or
+ modify it under the terms of the GNU General Public License
+ as published by the Free Software Foundation; either version 2
+ of the License, or (at your option) any later version.
+
+ This program is distributed in the hope that it will be useful,
+ but WITHOUT ANY WARRANTY; without even the implied warranty of
+ MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ GNU General Public License for more details.
+
+ You should have received a copy of the GNU General Public License
+ along with this program. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#include "../../src/gear/work_stealing_pool.h"
+
+using namespace std;
+
+TEST(WorkStealingPoolTestCase, RunUnbalancedTasks)
+{
+    m8r::WorkStealingPool pool{4};
+    ASSERT_EQ(4, pool.getSize());
+    ASSERT_LE(1, m8r::WorkStealingPool::getCpuCoresCount());
+
+    // triangular (unbalanced) tasks writing disjoint cells
+    const size_t n = 200;
+    vector<unsigned long> sums(n, 0);
+    atomic<int> executed{0};
+    vector<m8r::WorkStealingPool::Task> tasks{};
+    for(size_t i=0; i<n; i++) {
+        tasks.push_back([i,n,&sums,&executed]() {
+            for(size_t j=i; j<n; j++) {
+                sums[i] += j;
+            }
+            executed++;
+        });
+    }
+    pool.run(tasks);
+
+    ASSERT_EQ(n, executed.load());
+    for(size_t i=0; i<n; i++) {
+        ASSERT_EQ((n*(n-1))/2-(i*(i-1))/2, sums[i]);
+    }
+}
+
+TEST(WorkStealingPoolTestCase, TaskException)
+{
+    m8r::WorkStealingPool pool{2};
+    atomic<int> executed{0};
+    vector<m8r::WorkStealingPool::Task> tasks{};
+    for(int i=0; i<10; i++) {
+        tasks.push_back([i,&executed]() {
+            executed++;
+            if(i==5) {
+                throw std::runtime_error("task failure");
+            }
+        });
+    }
+
+    // all tasks are executed and the failure is propagated to the caller
+    EXPECT_THROW(pool.run(tasks), std::runtime_error);
+    EXPECT_EQ(10, executed.load());
+}
+
+TEST(WorkStealingPoolTestCase, WorkersReusedByBatches)
+{
+    m8r::WorkStealingPool pool{4};
+
+    // batches run concurrently by 2 callers share pool workers
+    mutex idsMutex{};
+    set<thread::id> ids{};
+    atomic<int> running{0};
+    atomic<int> maxRunning{0};
+    atomic<int> executed{0};
+    auto batches = [&]() {
+        for(int b=0; b<10; b++) {
+            vector<m8r::WorkStealingPool::Task> tasks{};
+            for(int i=0; i<20; i++) {
+                tasks.push_back([&]() {
+                    int r = ++running;
+                    for(int m = maxRunning; r > m && !maxRunning.compare_exchange_weak(m, r);) {}
+                    {
+                        lock_guard<mutex> criticalSection{idsMutex};
+                        ids.insert(this_thread::get_id());
+                    }
+                    this_thread::sleep_for(chrono::microseconds(100));
+                    executed++;
+                    running--;
+                });
+            }
+            pool.run(tasks);
+        }
+    };
+    thread caller{batches};
+    batches();
+    caller.join();
+
+    EXPECT_EQ(400, executed.load());
+    // 3 workers + 2 callers (as the worker 0), while a single batch runs at a time
+    EXPECT_GE(5u, ids.size());
+    EXPECT_GE(4, maxRunning.load());
+}
@@ -300,3 +300,393 @@ TEST(MindTestCase, CommonWordsBlacklist) {
     ASSERT_TRUE(blacklist.findWord("you"));
     ASSERT_TRUE(blacklist.findWord("the"));
 }
+
+TEST(MindTestCase, LinkGraph) {
+    // copy repository as Os will be modified and saved
+    string repositoryDir{"/tmp/mf-unit-repository-links"};
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+    string repositoryTemplate{"/lib/test/resources/links-repository"};
+    repositoryTemplate.insert(0, getMindforgerGitHomePath());
+    m8r::copyDirectoryRecursively(repositoryTemplate.c_str(), repositoryDir.c_str());
+
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-mtc-lg.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)));
+    m8r::Mind mind(config);
+    mind.learn();
+    m8r::Memory& memory = mind.remind();
+    ASSERT_EQ(5, memory.getOutlinesCount());
+
+    string memoryDir{repositoryDir+"/memory"};
+    m8r::Outline* src = memory.getOutline(memoryDir+"/links-src.md");
+    m8r::Outline* dst = memory.getOutline(memoryDir+"/links-dst.md");
+    m8r::Outline* subdirSrc = memory.getOutline(memoryDir+"/src-subdir/links-subdir-src.md");
+    ASSERT_NE(nullptr, src);
+    ASSERT_NE(nullptr, dst);
+    ASSERT_NE(nullptr, subdirSrc);
+
+    // outgoing: dst O, dst-subdir O, dst#n2, #n2 and dst-subdir#n2 (absolute /home/... link is broken)
+    unique_ptr<vector<m8r::Note*>> referenced{mind.getReferencedNotes(*src->getOutlineDescriptorAsNote())};
+    ASSERT_EQ(5, referenced->size());
+    EXPECT_NE(referenced->end(), std::find(referenced->begin(), referenced->end(), dst->getOutlineDescriptorAsNote()));
+    referenced.reset(mind.getReferencedNotes(*src->getOutlineDescriptorAsNote(), *dst));
+    ASSERT_EQ(2, referenced->size());
+
+    // incoming
+    m8r::Note* dstN2 = dst->getNoteByName("N2");
+    ASSERT_NE(nullptr, dstN2);
+    unique_ptr<vector<m8r::Note*>> referees{mind.getRefereeNotes(*dstN2)};
+    ASSERT_EQ(2, referees->size());
+    referees.reset(mind.getRefereeNotes(*dstN2, *subdirSrc));
+    ASSERT_EQ(1, referees->size());
+    EXPECT_EQ(subdirSrc->getOutlineDescriptorAsNote(), referees->at(0));
+    referees.reset(mind.getRefereeNotes(*dst->getNoteByName("N1")));
+    EXPECT_EQ(0, referees->size());
+
+    // incremental update on save: N1 starts to reference N1 in dst O
+    m8r::Note* srcN1 = src->getNoteByName("N1");
+    srcN1->addDescriptionLine(new string{"See [N1](links-dst.md#n1)."});
+    memory.remember(src->getKey());
+    referees.reset(mind.getRefereeNotes(*dst->getNoteByName("N1")));
+    ASSERT_EQ(1, referees->size());
+    EXPECT_EQ(srcN1, referees->at(0));
+
+    // forgotten O no longer references anything
+    size_t edges = memory.getLinkGraph().getEdgesCount();
+    mind.outlineForget(subdirSrc->getKey());
+    EXPECT_EQ(edges-6, memory.getLinkGraph().getEdgesCount());
+    referees.reset(mind.getRefereeNotes(*dstN2));
+    ASSERT_EQ(1, referees->size());
+    EXPECT_EQ(src->getOutlineDescriptorAsNote(), referees->at(0));
+}
+
+TEST(MindTestCase, ScopedOutlines) {
+    // copy repository as Os will be modified and saved
+    string repositoryDir{"/tmp/mf-unit-repository-scope"};
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+    string repositoryTemplate{"/lib/test/resources/links-repository"};
+    repositoryTemplate.insert(0, getMindforgerGitHomePath());
+    m8r::copyDirectoryRecursively(repositoryTemplate.c_str(), repositoryDir.c_str());
+
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-mtc-so.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)));
+    m8r::Mind mind(config);
+    mind.learn();
+    m8r::Memory& memory = mind.remind();
+    ASSERT_EQ(5, memory.getOutlinesCount());
+
+    // no scope > all Os
+    shared_ptr<const vector<m8r::Outline*>> all = mind.getOutlines();
+    EXPECT_EQ(memory.getOutlines(), *all);
+    EXPECT_EQ(5, all->size());
+    // snapshot is reused until scope or Memory Os change
+    EXPECT_EQ(all, mind.getOutlines());
+
+    // tags scope > no O has the tag
+    const m8r::Tag* tag = memory.getOntology().findOrCreateTag("scope-test");
+    vector<const m8r::Tag*> tags{tag};
+    mind.getTagsScopeAspect().setTags(tags);
+    shared_ptr<const vector<m8r::Outline*>> scoped = mind.getOutlines();
+    EXPECT_NE(all, scoped);
+    EXPECT_EQ(0, scoped->size());
+    // previous snapshot is immutable
+    EXPECT_EQ(5, all->size());
+
+    // O modification w/o remembering it doesn't evict the cache
+    string memoryDir{repositoryDir+"/memory"};
+    m8r::Outline* dst = memory.getOutline(memoryDir+"/links-dst.md");
+    ASSERT_NE(nullptr, dst);
+    dst->addTag(tag);
+    EXPECT_EQ(scoped, mind.getOutlines());
+    EXPECT_EQ(0, mind.getOutlines()->size());
+
+    // remembered O evicts the cache
+    memory.remember(dst->getKey());
+    EXPECT_NE(scoped, mind.getOutlines());
+    EXPECT_EQ(0, scoped->size());
+    ASSERT_EQ(1, mind.getOutlines()->size());
+    EXPECT_EQ(dst, mind.getOutlines()->at(0));
+
+    // forgotten O evicts the cache
+    mind.outlineForget(dst->getKey());
+    EXPECT_EQ(0, mind.getOutlines()->size());
+
+    // scope change evicts the cache
+    mind.getTagsScopeAspect().reset();
+    EXPECT_EQ(4, mind.getOutlines()->size());
+    mind.getTagsScopeAspect().setTags(tags);
+    EXPECT_EQ(0, mind.getOutlines()->size());
+    mind.getTagsScopeAspect().reset();
+    EXPECT_EQ(memory.getOutlines(), *mind.getOutlines());
+}
+
+TEST(MindTestCase, Statistics) {
+    string repositoryDir{"/tmp/mf-unit-repository-statistics"};
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+    m8r::Installer installer{};
+    installer.createEmptyMindForgerRepository(repositoryDir);
+    string oFile{repositoryDir+"/memory/outline.md"};
+    string oContent{"# Test Outline\n\nOutline text.\n\n## Note 1\nNote 1  text.\n\n## Note 2\n\tNote 2 text.\n"};
+    m8r::stringToFile(oFile,oContent);
+
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-mtc-s.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)));
+    m8r::Mind mind{config};
+    mind.learn();
+    m8r::Memory& memory = mind.remind();
+
+    const m8r::MemoryStatistics& statistics = memory.getStatistics();
+    string dump{};
+    statistics.toString(dump);
+    cout << endl << "Statistics: " << dump << endl;
+    EXPECT_EQ(1, statistics.getOutlinesCount());
+    EXPECT_EQ(2, statistics.getNotesCount());
+    EXPECT_EQ(2, memory.getNotesCount());
+    EXPECT_EQ(oContent.size(), statistics.getBytesCount());
+    EXPECT_EQ(oContent.size(), memory.getOutlineMarkdownsSize());
+    // name + description words of O and Ns
+    EXPECT_EQ(2+2+2+3+2+3, statistics.getWordsCount());
+    EXPECT_EQ(0, statistics.getTagsCount());
+
+    // new N w/ tags
+    m8r::Outline* o = memory.getOutlines()[0];
+    string name{"Tagged Note"};
+    vector<const m8r::Tag*> tags{};
+    tags.push_back(mind.ontology().findOrCreateTag(m8r::Tag::KeyCool()));
+    tags.push_back(mind.ontology().findOrCreateTag(m8r::Tag::KeyImportant()));
+    mind.noteNew(o->getKey(), 0, &name, nullptr, 1, &tags);
+    EXPECT_EQ(3, statistics.getNotesCount());
+    // new N has name and ... description
+    EXPECT_EQ(2+2+2+3+2+3+2+1, statistics.getWordsCount());
+    EXPECT_EQ(2, statistics.getTagsCount());
+    EXPECT_EQ(2, statistics.getDistinctTagsCount());
+
+    // remembered O has new size
+    memory.remember(o->getKey());
+    unique_ptr<string> md{m8r::fileToString(o->getKey())};
+    EXPECT_EQ(md->size(), statistics.getBytesCount());
+    EXPECT_EQ(3, statistics.getNotesCount());
+
+    // delete N
+    mind.noteForget(o->getNotes()[0]);
+    EXPECT_EQ(2, statistics.getNotesCount());
+    EXPECT_EQ(0, statistics.getTagsCount());
+    EXPECT_EQ(0, statistics.getDistinctTagsCount());
+    EXPECT_EQ(2+2+2+3+2+3, statistics.getWordsCount());
+
+    // forget O
+    mind.outlineForget(o->getKey());
+    EXPECT_EQ(0, statistics.getOutlinesCount());
+    EXPECT_EQ(0, statistics.getNotesCount());
+    EXPECT_EQ(0, statistics.getBytesCount());
+    EXPECT_EQ(0, statistics.getWordsCount());
+}
+
+TEST(MindTestCase, TimeIndex) {
+    string repositoryDir{"/tmp/mf-unit-repository-time"};
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+    m8r::Installer installer{};
+    installer.createEmptyMindForgerRepository(repositoryDir);
+    string oldMeta{"<!-- Metadata: type: Note; created: 2000-01-01 10:00:00; reads: 1; read: 2000-01-01 10:00:00; revision: 1; modified: 2000-01-01 10:00:00; -->"};
+    string newMeta{"<!-- Metadata: type: Note; created: 2000-01-01 10:00:00; reads: 1; read: 2037-01-01 10:00:00; revision: 1; modified: 2037-01-01 10:00:00; -->"};
+    m8r::stringToFile(
+        repositoryDir+"/memory/old.md",
+        "# Old Outline "+oldMeta+"\nText.\n\n## Old Note "+oldMeta+"\nText.\n");
+    m8r::stringToFile(
+        repositoryDir+"/memory/new.md",
+        "# New Outline "+newMeta+"\nText.\n\n## New Note "+newMeta+"\nText.\n\n## Newer Note "+newMeta+"\nText.\n");
+
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-mtc-ti.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)));
+    m8r::Mind mind{config};
+    mind.learn();
+    m8r::Memory& memory = mind.remind();
+    ASSERT_EQ(2, memory.getOutlinesCount());
+    EXPECT_EQ(2, memory.getTimeIndex().getOutlinesCount());
+    EXPECT_EQ(3, memory.getTimeIndex().getNotesCount());
+
+    // recent
+    vector<m8r::Note*> ns{};
+    memory.getTimeIndex().getRecentNotes(1, ns);
+    ASSERT_EQ(1, ns.size());
+    EXPECT_NE(string::npos, ns[0]->getName().find("New"));
+    ns.clear();
+    memory.getTimeIndex().getRecentNotes(10, ns);
+    ASSERT_EQ(3, ns.size());
+    EXPECT_EQ("Old Note", ns[2]->getName());
+    vector<m8r::Outline*> os{};
+    memory.getTimeIndex().getRecentOutlines(10, os);
+    ASSERT_EQ(2, os.size());
+    EXPECT_EQ("New Outline", os[0]->getName());
+
+    // time scope: 1 year
+    m8r::TimeScope timeScope{1,0,0,0,0};
+    mind.getTimeScopeAspect().setTimeScope(timeScope);
+    ASSERT_EQ(1, mind.getOutlines()->size());
+    EXPECT_EQ("New Outline", mind.getOutlines()->at(0)->getName());
+    ns.clear();
+    mind.getAllNotes(ns);
+    EXPECT_EQ(2, ns.size());
+
+    // forgotten O is removed from the index
+    mind.outlineForget(mind.getOutlines()->at(0)->getKey());
+    EXPECT_EQ(1, memory.getTimeIndex().getOutlinesCount());
+    EXPECT_EQ(1, memory.getTimeIndex().getNotesCount());
+    EXPECT_EQ(0, mind.getOutlines()->size());
+    ns.clear();
+    mind.getAllNotes(ns);
+    EXPECT_EQ(0, ns.size());
+
+    // no scope > all Ns
+    mind.getTimeScopeAspect().resetTimeScope();
+    ns.clear();
+    mind.getAllNotes(ns);
+    ASSERT_EQ(1, ns.size());
+    EXPECT_EQ("Old Note", ns[0]->getName());
+}
+
+TEST(MindTestCase, TimeIndexRead) {
+    string repositoryDir{"/tmp/mf-unit-repository-time-read"};
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+    m8r::Installer installer{};
+    installer.createEmptyMindForgerRepository(repositoryDir);
+    string oldMeta{"<!-- Metadata: type: Note; created: 2000-01-01 10:00:00; reads: 1; read: 2000-01-01 10:00:00; revision: 1; modified: 2000-01-01 10:00:00; -->"};
+    string newMeta{"<!-- Metadata: type: Note; created: 2000-01-01 10:00:00; reads: 1; read: 2037-01-01 10:00:00; revision: 1; modified: 2037-01-01 10:00:00; -->"};
+    m8r::stringToFile(
+        repositoryDir+"/memory/old.md",
+        "# Old Outline "+oldMeta+"\nText.\n\n## Old Note "+oldMeta+"\nText.\n\n## Older Note "+oldMeta+"\nText.\n");
+    m8r::stringToFile(
+        repositoryDir+"/memory/new.md",
+        "# New Outline "+newMeta+"\nText.\n\n## New Note "+newMeta+"\nText.\n\n## Newer Note "+newMeta+"\nText.\n");
+
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-mtc-tir.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)));
+    m8r::Mind mind{config};
+    mind.learn();
+    m8r::Memory& memory = mind.remind();
+    ASSERT_EQ(2, memory.getOutlinesCount());
+    vector<m8r::Note*> all{};
+    mind.getAllNotes(all);
+    ASSERT_EQ(4, all.size());
+
+    // time scope: 1 year
+    m8r::TimeScope timeScope{1,0,0,0,0};
+    mind.getTimeScopeAspect().setTimeScope(timeScope);
+    vector<m8r::Note*> ns{};
+    mind.getAllNotes(ns);
+    EXPECT_EQ(2, ns.size());
+    shared_ptr<const vector<m8r::Outline*>> os = mind.getOutlines();
+    ASSERT_EQ(1, os->size());
+    EXPECT_EQ("New Outline", os->at(0)->getName());
+
+    // read N is in scope immediately - w/o remembering its O
+    m8r::Outline* old = memory.getOutline(repositoryDir+"/memory/old.md");
+    ASSERT_NE(nullptr, old);
+    m8r::Note* oldNote = old->getNoteByName("Older Note");
+    ASSERT_NE(nullptr, oldNote);
+    u_int32_t reads = oldNote->getReads();
+    memory.read(oldNote);
+    EXPECT_EQ(reads+1, oldNote->getReads());
+    ns.clear();
+    mind.getAllNotes(ns);
+    ASSERT_EQ(3, ns.size());
+    EXPECT_NE(ns.end(), find(ns.begin(), ns.end(), oldNote));
+    // Memory order is kept (same as w/o scope, just filtered)
+    vector<m8r::Note*> expected{};
+    for(m8r::Note* n:all) {
+        if(n == oldNote || n->getOutline()->getName() == "New Outline") {
+            expected.push_back(n);
+        }
+    }
+    EXPECT_EQ(expected, ns);
+
+    // N read doesn't make its O read
+    EXPECT_EQ(1, mind.getOutlines()->size());
+
+    // read O evicts scoped Os
+    memory.read(old);
+    os = mind.getOutlines();
+    ASSERT_EQ(2, os->size());
+    EXPECT_EQ(memory.getOutlines(), *os);
+}
+
+TEST(MindTestCase, MemoryDwell) {
+    string repositoryDir{"/tmp/mf-unit-repository-dwell"};
+    m8r::removeDirectoryRecursively(repositoryDir.c_str());
+    m8r::Installer installer{};
+    installer.createEmptyMindForgerRepository(repositoryDir);
+    string meta2000{"<!-- Metadata: type: Note; created: 2000-01-01 10:00:00; reads: 1; read: 2000-01-01 10:00:00; revision: 1; modified: 2000-01-01 10:00:00; -->"};
+    string meta2010{"<!-- Metadata: type: Note; created: 2000-01-01 10:00:00; reads: 1; read: 2010-01-01 10:00:00; revision: 1; modified: 2010-01-01 10:00:00; -->"};
+    string meta2018{"<!-- Metadata: type: Note; created: 2000-01-01 10:00:00; reads: 1; read: 2018-01-01 10:00:00; revision: 1; modified: 2018-01-01 10:00:00; -->"};
+    m8r::stringToFile(
+        repositoryDir+"/memory/dwell.md",
+        "# Outline "+meta2018+"\nText.\n\n## A "+meta2000+"\nText.\n\n## B "+meta2010+"\nText.\n\n## C "+meta2018+"\nText.\n");
+
+    m8r::Configuration& config = m8r::Configuration::getInstance();
+    config.clear();
+    config.setConfigFilePath("/tmp/cfg-mtc-md.md");
+    config.setActiveRepository(config.addRepository(m8r::RepositoryIndexer::getRepositoryForPath(repositoryDir)));
+    m8r::Mind mind{config};
+    mind.learn();
+    m8r::Memory& memory = mind.remind();
+    ASSERT_EQ(1, memory.getOutlinesCount());
+    m8r::Outline* o = memory.getOutlines()[0];
+    ASSERT_EQ(3, o->getNotesCount());
+    m8r::Note* a = o->getNotes()[0];
+    m8r::Note* b = o->getNotes()[1];
+    m8r::Note* c = o->getNotes()[2];
+
+    // seeded from persisted timestamps
+    EXPECT_EQ(3, mind.getMemoryDwellDepth());
+    vector<m8r::Note*> dwell{};
+    mind.getMemoryDwell(dwell);
+    ASSERT_EQ(3, dwell.size());
+    EXPECT_EQ(c, dwell[0]);
+    EXPECT_EQ(b, dwell[1]);
+    EXPECT_EQ(a, dwell[2]);
+    dwell.clear();
+    mind.getMemoryDwell(dwell, 2, 1);
+    ASSERT_EQ(1, dwell.size());
+    EXPECT_EQ(a, dwell[0]);
+
+    // frequently read N gets the most relevant
+    time_t when = c->getRead();
+    EXPECT_GT(memory.getMemoryDwell().getRelevance(c, when), memory.getMemoryDwell().getRelevance(a, when));
+    for(int i=0; i<5; i++) {
+        memory.getMemoryDwell().read(a, when);
+    }
+    EXPECT_GT(memory.getMemoryDwell().getRelevance(a, when), memory.getMemoryDwell().getRelevance(c, when));
+    dwell.clear();
+    mind.getMemoryDwell(dwell, 1);
+    ASSERT_EQ(1, dwell.size());
+    EXPECT_EQ(a, dwell[0]);
+
+    // written N
+    b->makeModified();
+    memory.remember(o->getKey());
+    dwell.clear();
+    mind.getMemoryDwell(dwell, 1);
+    ASSERT_EQ(1, dwell.size());
+    EXPECT_EQ(b, dwell[0]);
+
+    // deleted N
+    mind.noteForget(b);
+    EXPECT_EQ(2, mind.getMemoryDwellDepth());
+    dwell.clear();
+    mind.getMemoryDwell(dwell);
+    ASSERT_EQ(2, dwell.size());
+    EXPECT_EQ(a, dwell[0]);
+    EXPECT_EQ(c, dwell[1]);
+
+    mind.outlineForget(o->getKey());
+    EXPECT_EQ(0, mind.getMemoryDwellDepth());
+}
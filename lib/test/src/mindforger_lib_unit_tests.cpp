@@ -19,6 +19,8 @@
 
 #include <iostream>
 #include <gtest/gtest.h>
+#include "../../src/config/configuration.h"
+#include "../../src/gear/file_utils.h"
 
 using namespace std;
 
@@ -55,6 +57,15 @@ int main(int argc, char **argv)
         return 1;
     } else {
         testing::InitGoogleTest(&argc, argv);
-        return RUN_ALL_TESTS();
+
+        // tests and benchmarks must not write AI snapshots to user's cache
+        m8r::Configuration& config = m8r::Configuration::getInstance();
+        config.setCachePath("/tmp/mf-unit-cache");
+        m8r::removeDirectoryRecursively(config.getCachePath().c_str());
+
+        int result = RUN_ALL_TESTS();
+
+        m8r::removeDirectoryRecursively(config.getCachePath().c_str());
+        return result;
     }
 }
@@ -69,7 +69,9 @@ SOURCES += \
     ../benchmark/trie_benchmark.cpp \
     ../benchmark/ai_benchmark.cpp \
     gear/file_utils_test.cpp \
-    gear/trie_test.cpp
+    gear/trie_test.cpp \
+    gear/work_stealing_pool_test.cpp \
+    gear/priority_executor_test.cpp
 
 HEADERS += \
     ./test_gear.h